@@ -0,0 +1,240 @@
+#ifndef AFFINEMATRIX_H
+#define AFFINEMATRIX_H
+
+#include "xe/matrix.h"
+#include "xe/vector3.h"
+#include "xe/quaternion.h"
+
+#include <cmath>   // fabs()
+
+/**
+ * An affine transformation: any combination of scales, rotations, shears
+ * and translations, but no projection. It is an XeMatrix without the last
+ * column, which is always (0, 0, 0, 1) for such transformations: the first
+ * three rows hold the linear part and the last row the translation.
+ *
+ * It takes 48 bytes instead of 64, and composing, inverting and
+ * transforming skip the work the last column would need. Use it for scene
+ * and object transforms, and XeMatrix for projections and when handing
+ * matrices to the renderer. Results are the same as for the equivalent
+ * XeMatrix operations, except for the sign of zero entries and, for
+ * inverses, rounding
+ */
+class XeAffineMatrix
+{
+public:
+    union
+    {
+        struct
+        {
+            float m11, m12, m13;
+            float m21, m22, m23;
+            float m31, m32, m33;
+            float m41, m42, m43;
+        };
+
+        float m[12];
+    };
+
+    /** Gets the identity transformation */
+    static constexpr XeAffineMatrix Identity();
+
+    /**
+     * Creates an affine transformation from a matrix, dropping its last column
+     * @param m A matrix whose last column is (0, 0, 0, 1)
+     */
+    static XeAffineMatrix FromXeMatrix(const XeMatrix& m);
+    /**
+     * Creates a transformation that scales, then rotates, then translates,
+     * like XeMatrix::FromScaleRotationTranslation()
+     * @param scale The scale along each axis
+     * @param rotation The rotation, as a unit quaternion
+     * @param translation The translation
+     */
+    static XeAffineMatrix FromScaleRotationTranslation(const XeVector3& scale, const XeQuaternion& rotation, const XeVector3& translation);
+
+    /**
+     * Composes two transformations: the result applies m1, then m2, like
+     * XeMatrix::Multiply(m1, m2)
+     */
+    static XeAffineMatrix Multiply(const XeAffineMatrix& m1, const XeAffineMatrix& m2);
+    /** Computes the determinant of a transformation's linear part */
+    static float Determinant(const XeAffineMatrix& m);
+    /** Computes the inverse of a transformation */
+    static XeAffineMatrix Invert(const XeAffineMatrix& m);
+    /**
+     * Computes the inverse of a transformation whose linear part is a
+     * rotation, i.e. a rigid transformation without scaling. The inverse of
+     * the rotation is its transpose, so this is much cheaper than Invert(),
+     * and the result is wrong for other transformations
+     */
+    static XeAffineMatrix InvertOrthonormal(const XeAffineMatrix& m);
+
+    /** Transforms a point */
+    static XeVector3 Transform(const XeAffineMatrix& m, const XeVector3& v);
+    /**
+     * Transforms a direction, ignoring the translation. Normals transformed
+     * by a non-uniform scale need the transpose of the inverse instead
+     */
+    static XeVector3 TransformNormal(const XeAffineMatrix& m, const XeVector3& v);
+
+    /** Checks two transformations for equality */
+    static bool Equal(const XeAffineMatrix& m1, const XeAffineMatrix& m2, float epsilon = 1e-6f);
+    /** Checks two transformations for inequality */
+    static bool NotEqual(const XeAffineMatrix& m1, const XeAffineMatrix& m2, float epsilon = 1e-6f);
+
+    /** Creates the identity transformation */
+    constexpr XeAffineMatrix();
+    /** Creates a transformation with the given entries */
+    constexpr XeAffineMatrix(float m11, float m12, float m13,
+                             float m21, float m22, float m23,
+                             float m31, float m32, float m33,
+                             float m41, float m42, float m43);
+
+    /** Creates the matrix for this transformation */
+    XeMatrix toXeMatrix() const;
+
+    /** Computes the translation of this transformation */
+    XeVector3 translation() const;
+
+    /** Computes the determinant of this transformation's linear part */
+    float determinant() const;
+    /** Computes the inverse of this transformation */
+    XeAffineMatrix invert() const;
+    /** Computes the inverse of this transformation, if it is rigid (see InvertOrthonormal()) */
+    XeAffineMatrix invertOrthonormal() const;
+
+    /** Checks two transformations for equality */
+    bool operator== (const XeAffineMatrix& rhs) const;
+    /** Checks two transformations for inequality */
+    bool operator!= (const XeAffineMatrix& rhs) const;
+
+    /** Composes this transformation with another */
+    XeAffineMatrix operator* (const XeAffineMatrix& rhs) const;
+    /** Transforms a point */
+    XeVector3 operator* (const XeVector3& rhs) const;
+    /** Composes this transformation with another */
+    XeAffineMatrix& operator*= (const XeAffineMatrix& rhs);
+};
+
+constexpr XeAffineMatrix::XeAffineMatrix()
+    : m{1, 0, 0,
+        0, 1, 0,
+        0, 0, 1,
+        0, 0, 0}
+{ }
+
+constexpr XeAffineMatrix::XeAffineMatrix(float m11, float m12, float m13,
+                                         float m21, float m22, float m23,
+                                         float m31, float m32, float m33,
+                                         float m41, float m42, float m43)
+    : m{m11, m12, m13,
+        m21, m22, m23,
+        m31, m32, m33,
+        m41, m42, m43}
+{ }
+
+constexpr XeAffineMatrix XeAffineMatrix::Identity()
+{
+    return XeAffineMatrix(1, 0, 0,
+                          0, 1, 0,
+                          0, 0, 1,
+                          0, 0, 0);
+}
+
+inline XeAffineMatrix XeAffineMatrix::FromXeMatrix(const XeMatrix &m)
+{
+    return XeAffineMatrix(m.m11, m.m12, m.m13,
+                          m.m21, m.m22, m.m23,
+                          m.m31, m.m32, m.m33,
+                          m.m41, m.m42, m.m43);
+}
+
+inline XeVector3 XeAffineMatrix::Transform(const XeAffineMatrix &m, const XeVector3 &v)
+{
+    return XeVector3(v.x * m.m11 + v.y * m.m21 + v.z * m.m31 + m.m41,
+                     v.x * m.m12 + v.y * m.m22 + v.z * m.m32 + m.m42,
+                     v.x * m.m13 + v.y * m.m23 + v.z * m.m33 + m.m43);
+}
+
+inline XeVector3 XeAffineMatrix::TransformNormal(const XeAffineMatrix &m, const XeVector3 &v)
+{
+    return XeVector3(v.x * m.m11 + v.y * m.m21 + v.z * m.m31,
+                     v.x * m.m12 + v.y * m.m22 + v.z * m.m32,
+                     v.x * m.m13 + v.y * m.m23 + v.z * m.m33);
+}
+
+inline float XeAffineMatrix::Determinant(const XeAffineMatrix &m)
+{
+    return ((m.m11 * ((m.m22 * m.m33) - (m.m23 * m.m32)))
+            - (m.m12 * ((m.m21 * m.m33) - (m.m23 * m.m31))))
+            + (m.m13 * ((m.m21 * m.m32) - (m.m22 * m.m31)));
+}
+
+inline bool XeAffineMatrix::Equal(const XeAffineMatrix &m1, const XeAffineMatrix &m2, float epsilon)
+{
+    for (int i = 0; i < 12; i++)
+        if (fabs(m1.m[i] - m2.m[i]) > epsilon)
+            return false;
+    return true;
+}
+
+inline bool XeAffineMatrix::NotEqual(const XeAffineMatrix &m1, const XeAffineMatrix &m2, float epsilon)
+{
+    return !XeAffineMatrix::Equal(m1, m2, epsilon);
+}
+
+inline XeMatrix XeAffineMatrix::toXeMatrix() const
+{
+    return XeMatrix(m11, m12, m13, 0,
+                    m21, m22, m23, 0,
+                    m31, m32, m33, 0,
+                    m41, m42, m43, 1);
+}
+
+inline XeVector3 XeAffineMatrix::translation() const
+{
+    return XeVector3(m41, m42, m43);
+}
+
+inline float XeAffineMatrix::determinant() const
+{
+    return XeAffineMatrix::Determinant(*this);
+}
+
+inline XeAffineMatrix XeAffineMatrix::invert() const
+{
+    return XeAffineMatrix::Invert(*this);
+}
+
+inline XeAffineMatrix XeAffineMatrix::invertOrthonormal() const
+{
+    return XeAffineMatrix::InvertOrthonormal(*this);
+}
+
+inline bool XeAffineMatrix::operator== (const XeAffineMatrix& rhs) const
+{
+    return XeAffineMatrix::Equal(*this, rhs);
+}
+
+inline bool XeAffineMatrix::operator!= (const XeAffineMatrix& rhs) const
+{
+    return XeAffineMatrix::NotEqual(*this, rhs);
+}
+
+inline XeAffineMatrix XeAffineMatrix::operator* (const XeAffineMatrix& rhs) const
+{
+    return XeAffineMatrix::Multiply(*this, rhs);
+}
+
+inline XeVector3 XeAffineMatrix::operator* (const XeVector3& rhs) const
+{
+    return XeAffineMatrix::Transform(*this, rhs);
+}
+
+inline XeAffineMatrix& XeAffineMatrix::operator*= (const XeAffineMatrix& rhs)
+{
+    return (*this = XeAffineMatrix::Multiply(*this, rhs));
+}
+
+#endif // AFFINEMATRIX_H
@@ -0,0 +1,45 @@
+
+#pragma once
+
+#include "xe/global.h"
+
+/** A set of heap allocation counters. See XeAllocTracker */
+class XE_EXPORT XeAllocStats
+{
+public:
+    XeAllocStats() : allocs(0), frees(0), bytesAllocated(0), bytesFreed(0) { }
+
+    /** The number of allocations made */
+    quint64 allocs;
+    /** The number of allocations released */
+    quint64 frees;
+    /** The total size of all allocations made, in bytes */
+    quint64 bytesAllocated;
+    /** The total size of all allocations released, in bytes */
+    quint64 bytesFreed;
+
+    /** Gets the counts accumulated between two snapshots. Counts that would go
+      * negative are clamped to zero
+      */
+    XeAllocStats operator-(const XeAllocStats &) const;
+    XeAllocStats &operator+=(const XeAllocStats &);
+};
+
+/** Counts heap allocations made by the application.
+  * When XE_ALLOC_TRACKING is enabled in xe/config.h, xenon replaces the global
+  * operator new/delete (and, on glibc, malloc/free) with versions that keep
+  * per-thread and process-wide counters. XeProfiler snapshots these counters
+  * to attribute allocations to the section that made them.
+  * When XE_ALLOC_TRACKING is disabled, all counters read as zero.
+  */
+class XE_EXPORT XeAllocTracker
+{
+public:
+    /** Gets a value indicating whether allocation tracking was compiled in */
+    static bool isEnabled();
+
+    /** Gets the counters for allocations made by the calling thread */
+    static XeAllocStats thread();
+    /** Gets the counters for allocations made by all threads */
+    static XeAllocStats process();
+};
@@ -4,9 +4,10 @@
 #include "xe/axisinput.h"
 #include "xe/buttoninput.h"
 #include "xe/global.h"
+
+#include <QByteArray>
 #include "xe/range.h"
 
-#include <QString>
 
 /** A button input that wraps an axis inputs. The virtual button created from
   * the axis is down when the axis's value falls within a certain range
@@ -33,6 +34,13 @@ public:
 private:
     XeAxisInput *m_axis;
     XeRangeF m_range;
-    QString m_id, m_name;
+    /** Built by rename() when id() or name() is first asked for after the
+      * inputs change, so rebinding doesn't build or keep any strings
+      */
+    mutable QByteArray m_id;
+    mutable QByteArray m_name;
+    mutable bool m_named;
+
+    void rename() const;
 };
 
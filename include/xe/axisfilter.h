@@ -0,0 +1,102 @@
+
+#pragma once
+
+#include "xe/global.h"
+#include "xe/inputhandle.h"
+
+#include <QVector>
+
+/** A chain of processing stages for each mapped axis: dead zones, response
+  * curves, smoothing and acceleration.
+  *
+  * Stages are stored in one flat array, radial dead zones first, then grouped
+  * by axis in the order they were added, and run() applies them all in a single pass over a dense
+  * array of axis values. xe_input runs its filters once per tick right after
+  * evaluating the mapped inputs, so reading a filtered value is a plain
+  * array read no matter how many stages an axis has.
+  *
+  * Stages expect values centered on 0, e.g. -1 to 1 for a stick, and work
+  * on their magnitude, keeping their sign.
+  */
+class XE_EXPORT XeAxisFilters
+{
+public:
+    XeAxisFilters();
+
+    /** Zeroes values closer to 0 than size, and rescales the rest so the
+      * output still starts at 0 at the edge of the dead zone
+      */
+    void deadZone(XeAxisHandle axis, float size);
+    /** Like deadZone(), but applied to the length of the (x, y) vector of
+      * two axes, so a stick has a round dead zone instead of a cross.
+      * Radial dead zones run before the stages of any single axis, so both
+      * axes' own stages see the dead-zoned values
+      */
+    void radialDeadZone(XeAxisHandle x, XeAxisHandle y, float size);
+    /** Raises the magnitude of the value to the given power. Exponents above
+      * 1 give finer control near the center
+      */
+    void exponent(XeAxisHandle axis, float power);
+    /** Maps the magnitude of the value through a piecewise-linear curve,
+      * given as output values at evenly spaced inputs from 0 to 1 inclusive
+      * (at least two points)
+      */
+    void curve(XeAxisHandle axis, const QVector<float> &points);
+    /** Smooths the value with an exponential moving average that reaches
+      * about 63% of a step change after the given number of seconds,
+      * regardless of tick rate
+      */
+    void smooth(XeAxisHandle axis, float seconds);
+    /** Scales up fast movement, for relative axes such as mouse motion: the
+      * value is multiplied by 1 + gain * speed (in units per second), up to
+      * limit times
+      */
+    void accelerate(XeAxisHandle axis, float gain, float limit = 4.f);
+
+    /** Removes all stages of an axis, including radial dead zones it is in */
+    void clear(XeAxisHandle axis);
+    /** Removes all stages */
+    void clear();
+
+    /** Gets the number of stages of all axes */
+    int count() const;
+
+    /** Applies all stages to values, in place. values[i] is the value of
+      * the axis with handle index i; stages of axes at or beyond count are skipped
+      */
+    void run(float *values, int count, float dt);
+
+private:
+    enum Type
+    {
+        DEADZONE,
+        RADIAL_DEADZONE,
+        EXPONENT,
+        CURVE,
+        SMOOTH,
+        ACCELERATE,
+    };
+
+    struct Stage
+    {
+        Type type;
+        int axis;
+        /** RADIAL_DEADZONE: the y axis */
+        int axis2;
+        float a;
+        float b;
+        /** SMOOTH: the smoothed value so far */
+        float state;
+        /** CURVE: the range of m_points holding the curve */
+        int first;
+        int points;
+    };
+
+    QVector<Stage> m_stages;
+    QVector<float> m_points;
+
+    static Stage stage(Type type, int axis);
+    /** The position of a stage in m_stages relative to others */
+    static qint64 order(const Stage &);
+    void add(const Stage &);
+};
@@ -0,0 +1,159 @@
+
+#pragma once
+
+#include "xe/global.h"
+#include "xe/updatable.h"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+/** A set of input bindings loaded from text, e.g. a player's control scheme.
+  *
+  * Each line binds a virtual button or axis name to an expression over
+  * device inputs:
+  *
+  *     # Comments start with a hash
+  *     button jump       = Keyboard.Space | Mouse.right
+  *     button fullscreen = Keyboard.Alt & Keyboard.Enter
+  *     button idle       = !(Keyboard.W | Keyboard.S)
+  *     button throttle   = Gamepad.Trigger[0.5, 1]
+  *     axis   move_x     = Keyboard.D - Keyboard.A
+  *     axis   sprint_x   = Keyboard.D * 2 - Keyboard.A * 2
+  *     axis   look_x     = Mouse.Horizontal
+  *
+  * '&', '|' and '!' combine buttons like XeAndButton, XeOrButton and
+  * XeNotButton. An axis followed by [min, max] is a button that is down
+  * while the axis is in range, like XeAxisButton. An axis line is either a
+  * single input, or a sum of buttons with optional weights, like
+  * XeButtonAxis; a single input that turns out to be a button reads 1
+  * while it is down and 0 otherwise. Numbers always use '.' as the decimal
+  * point, whatever the locale. IDs containing other characters than letters, digits and
+  * '_' can be quoted, e.g. "Bot 1".jump.
+  *
+  * Parsing produces flat tables rather than input objects, which XeInput
+  * compiles straight into its XeInputProgram (see XeInput::setProfile()).
+  * Loading, swapping or reloading a profile doesn't allocate an object per
+  * binding. Device inputs are looked up when the profile is compiled, and
+  * again whenever a device is attached to or detached from xe_kernel.
+  *
+  * A profile loaded from a file can reload itself when the file changes:
+  * attach it to xe_kernel->preUpdate() and it checks the file's
+  * modification time every pollInterval() seconds. If a reload fails to
+  * parse, the previous bindings are kept, and the file is tried again at
+  * every poll until it parses.
+  */
+class XE_EXPORT XeBindingProfile : public XeUpdatable
+{
+public:
+    enum NodeType
+    {
+        /** A button of a device */
+        BUTTON,
+        /** An axis of a device */
+        AXIS,
+        /** Down if all operands are down */
+        AND,
+        /** Down if any operand is down */
+        OR,
+        /** Down if node first is up */
+        NOT,
+        /** Down if axis node first is within [min, max] */
+        AXIS_BUTTON,
+        /** The sum of the weights of the operands that are down */
+        BUTTON_AXIS,
+    };
+
+    /** An expression node. Nodes only refer to nodes before them */
+    struct Node
+    {
+        NodeType type;
+        /** BUTTON, AXIS: the interned device and input IDs */
+        const char *device;
+        const char *input;
+        /** AND, OR, BUTTON_AXIS: the range of operands(). NOT, AXIS_BUTTON:
+          * the node the operation applies to
+          */
+        int first;
+        int count;
+        float min, max;
+    };
+
+    struct Operand
+    {
+        int node;
+        /** BUTTON_AXIS: the value the operand adds while it is down */
+        float weight;
+    };
+
+    struct Binding
+    {
+        /** The interned virtual input name */
+        const char *name;
+        /** The root node of the expression */
+        int node;
+    };
+
+    XeBindingProfile();
+
+    /** Replaces the bindings with those parsed from text. If the text
+      * doesn't parse, the bindings don't change, the error is written to
+      * xe_trace and returned in error, and false is returned
+      */
+    bool parse(const QByteArray &text, QString *error = 0);
+    /** Parses a profile from a file, and if it parses, remembers the file
+      * and its modification time for reload()
+      */
+    bool load(const char *path);
+    /** Gets the file the profile was loaded from, or "" */
+    const char *path() const;
+    /** Loads the file again if it changed since it was last loaded.
+      * Returns true if new bindings were loaded
+      */
+    bool reload();
+
+    /** Gets or sets how often update() checks the file for changes, in
+      * seconds. 0 turns hot reloading off
+      */
+    float pollInterval() const;
+    void setPollInterval(float seconds);
+
+    /** Removes all bindings */
+    void clear();
+
+    /** Gets a number that changes whenever the bindings change */
+    quint64 revision() const;
+
+    const QVector<Node> &nodes() const;
+    const QVector<Operand> &operands() const;
+    const QVector<Binding> &buttons() const;
+    const QVector<Binding> &axes() const;
+
+    /** Gets the index in buttons() or axes() of the binding for a name, or
+      * -1 if the profile doesn't bind it
+      */
+    int findButton(const char *name) const;
+    int findAxis(const char *name) const;
+
+    /** Checks the file for changes, every pollInterval() seconds */
+    void update(float dt);
+
+private:
+    QVector<Node> m_nodes;
+    QVector<Operand> m_operands;
+    QVector<Binding> m_buttons;
+    QVector<Binding> m_axes;
+    QHash<QByteArray, int> m_buttonIndex;
+    QHash<QByteArray, int> m_axisIndex;
+    quint64 m_revision;
+
+    const char *m_path;
+    QDateTime m_modified;
+    float m_pollInterval;
+    float m_sincePoll;
+
+    /** parse(), naming source in errors */
+    bool parse(const QByteArray &text, const char *source, QString *error);
+};
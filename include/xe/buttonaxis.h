@@ -5,8 +5,8 @@
 #include "xe/buttoninput.h"
 #include "xe/global.h"
 
+#include <QByteArray>
 #include <QList>
-#include <QString>
 
 /** An axis input that wraps button inputs. The value of the virtual axis
   * is the sum of the values associated with each child button. The value
@@ -20,6 +20,8 @@
 class XE_EXPORT XeButtonAxis : public XeAxisInput
 {
 public:
+    XeButtonAxis();
+
     /** Attachs a button to this axis
       * @param button The button to attach
       * @param upval The value produced by the button when it is not being held down
@@ -37,7 +39,6 @@ public:
 
     float value() const;
 
-private:
     struct ButtonValue
     {
         XeButtonInput *button;
@@ -47,7 +48,18 @@ private:
         ButtonValue(XeButtonInput *b, float up, float down) : button(b), upval(up), downval(down) { }
     };
 
+    /** Gets the attached buttons and their values */
+    const QList<ButtonValue> &buttons() const;
+
+private:
     QList<ButtonValue> m_buttons;
-    QString m_id, m_name;
+    /** Built by rename() when id() or name() is first asked for after the
+      * inputs change, so rebinding doesn't build or keep any strings
+      */
+    mutable QByteArray m_id;
+    mutable QByteArray m_name;
+    mutable bool m_named;
+
+    void rename() const;
 };
 
@@ -0,0 +1,136 @@
+
+#pragma once
+
+#include "xe/buttoninput.h"
+#include "xe/global.h"
+#include "xe/updatable.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+/** A handle to a combo registered with an XeComboMatcher */
+typedef int XeCombo;
+
+/** Detects fighting game-style button combos: sequences of presses within a
+  * time window, chords of simultaneous presses, and charge moves.
+  *
+  * Each tick, update() walks the event queue of each device that has a
+  * button used by any combo once, and feeds the presses and releases of
+  * those buttons in the order they happened to the combos that use them.
+  * Presses quicker than a tick still count, and windows are measured from
+  * when each press arrived rather than from the tick it was seen in.
+  * Composite buttons (e.g. XeOrButton) have no events and are sampled once
+  * per tick.
+  *
+  * Each combo is a small state machine that advances on those transitions,
+  * so the cost per tick depends on how many buttons changed rather than on
+  * how many combos are registered.
+  *
+  * Attach the matcher to xe_kernel->preUpdate() (after xe_input, if it uses
+  * mapped inputs) and check completed() or fired() during the tick.
+  */
+class XE_EXPORT XeComboMatcher : public XeUpdatable
+{
+public:
+    XeComboMatcher();
+
+    /** Registers a sequence: the buttons must be pressed in order, with the
+      * whole sequence completed within window seconds of the first press.
+      * Pressing another button of the sequence out of order restarts it
+      */
+    XeCombo sequence(const char *name, const QList<XeButtonInput*> &buttons, float window = .5f);
+    /** Registers a chord: all the buttons must be pressed within window
+      * seconds of each other, and be down at the same time
+      */
+    XeCombo chord(const char *name, const QList<XeButtonInput*> &buttons, float window = .05f);
+    /** Registers a charge move: hold must be held down for at least
+      * seconds, then release pressed either while hold is still down or
+      * within window seconds of letting go of it
+      */
+    XeCombo charge(const char *name, XeButtonInput *hold, float seconds, XeButtonInput *release,
+                   float window = .2f);
+
+    /** Removes all combos */
+    void clear();
+
+    /** Gets the number of registered combos. Handles range from 0 to count() - 1 */
+    int count() const;
+    /** Gets the name a combo was registered with */
+    const char *name(XeCombo) const;
+
+    /** Gets whether a combo completed during the last update() */
+    bool fired(XeCombo) const;
+    /** Gets the combos that completed during the last update() */
+    const QList<XeCombo> &completed() const;
+
+    /** Feeds the buttons' presses and releases since the last tick to all
+      * combos. Call it before the devices clear their event queues
+      */
+    void update(float dt);
+
+private:
+    enum Type
+    {
+        SEQUENCE,
+        CHORD,
+        CHARGE,
+    };
+
+    struct Combo
+    {
+        Type type;
+        QByteArray name;
+        /** Indices into m_buttons. For CHARGE, the hold and release buttons */
+        QVector<int> buttons;
+        float window;
+        float hold;
+
+        /** SEQUENCE: the index of the next button expected, and the time
+          * the first one was pressed
+          */
+        int step;
+        double start;
+        /** CHARGE: the time until which a charge is still held */
+        double chargedUntil;
+        bool fired;
+    };
+
+    struct Button
+    {
+        XeButtonInput *input;
+        bool down;
+        double downSince;
+        double lastPress;
+        /** The combos that use this button */
+        QVector<int> combos;
+    };
+
+    QVector<Combo> m_combos;
+    QVector<Button> m_buttons;
+    /** The index of each button in m_buttons */
+    QHash<const XeButtonInput*, int> m_index;
+    /** The IDs of the devices the buttons belong to */
+    QVector<QByteArray> m_devices;
+    /** A press or release, at a time on the matcher's clock */
+    struct Event
+    {
+        double time;
+        int button;
+        bool down;
+    };
+
+    QList<XeCombo> m_completed;
+    QVector<Event> m_events;
+    /** Seconds since the matcher was created. A double, so a session that
+      * runs for days still resolves presses a tick apart
+      */
+    double m_time;
+
+    XeCombo add(Type type, const char *name, const QList<XeButtonInput*> &buttons, float window, float hold);
+    int button(XeButtonInput *);
+    void transition(int button, bool down, double time);
+    void press(XeCombo c, int button, double time);
+    void fire(XeCombo c);
+};
@@ -10,3 +10,35 @@
 /** If disabled, all XeProfiler begin/end calls become no-ops */
 #define XE_PROFILING 1
 
+/** If enabled, xenon replaces the global allocator with one that counts
+  * allocations per thread (see XeAllocTracker). Adds a small cost to every
+  * heap allocation, so it is disabled by default
+  */
+#define XE_ALLOC_TRACKING 0
+
+/** If enabled, relative mouse mode reads raw motion from XInput 2 on Linux
+  * instead of warping the cursor. Needs QtX11Extras and xcb-xinput, which
+  * qmake links when run with CONFIG+=xe_raw_mouse (this also enables it)
+  */
+#ifndef XE_RAW_MOUSE
+#define XE_RAW_MOUSE 0
+#endif
+
+/** The instruction set the math library uses for four-wide float math (see
+  * XeSimd): XE_SIMD_SSE, XE_SIMD_NEON, or XE_SIMD_SCALAR for portable code.
+  * Chosen from the target architecture unless defined when building, e.g.
+  * with DEFINES += XE_SIMD=0
+  */
+#define XE_SIMD_SCALAR 0
+#define XE_SIMD_SSE 1
+#define XE_SIMD_NEON 2
+
+#ifndef XE_SIMD
+#   if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#       define XE_SIMD XE_SIMD_SSE
+#   elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#       define XE_SIMD XE_SIMD_NEON
+#   else
+#       define XE_SIMD XE_SIMD_SCALAR
+#   endif
+#endif
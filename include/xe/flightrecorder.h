@@ -0,0 +1,104 @@
+
+#pragma once
+
+#include "xe/alloctracker.h"
+#include "xe/global.h"
+#include "xe/tracelogger.h"
+#include "xe/updatable.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+class XeProfiler;
+class XeProfilerSection;
+
+/** Keeps the last few frames of profiler samples, trace messages and frame
+  * times in memory, and writes them to disk whenever a frame takes longer
+  * than a configurable threshold. This gives post-mortem data for rare
+  * spikes without running full tracing all the time.
+  *
+  * Attach the recorder to xe_trace to capture trace messages, and update it
+  * once per tick after its profiler has been updated (for example, by adding
+  * it to xe_kernel->postUpdate() after the profiler).
+  */
+class XE_EXPORT XeFlightRecorder : public XeUpdatable, public XeTraceLogger
+{
+public:
+    /** Creates a flight recorder
+      * @param profiler The profiler whose sections are recorded each frame,
+      *                 or NULL to record only frame times and trace messages
+      * @param frames   The number of frames to keep in memory
+      */
+    XeFlightRecorder(XeProfiler *profiler = 0, int frames = 120);
+
+    /** Gets or sets the profiler whose sections are recorded each frame */
+    XeProfiler *profiler() const;
+    void setProfiler(XeProfiler *);
+
+    /** Gets or sets the number of frames kept in memory.
+      * Setting this discards all frames recorded so far
+      */
+    int frames() const;
+    void setFrames(int);
+
+    /** Gets or sets the frame time, in partial seconds, above which the
+      * recorded frames are written to disk
+      */
+    float threshold() const;
+    void setThreshold(float);
+
+    /** Gets or sets the directory trace files are written to */
+    const char *directory() const;
+    void setDirectory(const char *);
+
+    /** Gets the number of trace files written so far */
+    int dumpCount() const;
+
+    /** Writes all frames currently held in memory to a trace file.
+      * Returns false if the file could not be written
+      */
+    bool dump(const char *path) const;
+
+    /** Records a trace message into the current frame */
+    void log(time_t timestamp, XeTraceType type, const char *str);
+
+    /** Closes the current frame and checks whether it exceeded the threshold
+      * @param dt The time elapsed since the last tick, in partial seconds
+      */
+    void update(float dt);
+
+private:
+    struct Sample
+    {
+        const XeProfilerSection *section;
+        float dt;
+        XeAllocStats allocs;
+    };
+
+    struct Record
+    {
+        time_t timestamp;
+        XeTraceType type;
+        QByteArray message;
+    };
+
+    struct Frame
+    {
+        quint64 index;
+        float dt;
+        QVector<Sample> samples;
+        QVector<Record> records;
+    };
+
+    XeProfiler *m_profiler;
+    QVector<Frame> m_frames;
+    QList<XeProfilerSection*> m_sections;
+    int m_current;
+    int m_count;
+    quint64 m_frameIndex;
+    int m_cooldown;
+    int m_dumps;
+    float m_threshold;
+    QByteArray m_directory;
+};
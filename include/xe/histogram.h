@@ -0,0 +1,59 @@
+
+#pragma once
+
+#include "xe/global.h"
+
+/** Counts durations in power-of-two buckets, so percentiles of large numbers
+  * of samples can be estimated with a fixed amount of memory and a constant
+  * cost per sample.
+  *
+  * Samples are given in nanoseconds and bucketed by microseconds: bucket 0
+  * holds samples under 1us, and bucket i holds samples from 2^(i-1) up to
+  * 2^i microseconds. The last bucket also holds everything longer.
+  */
+class XE_EXPORT XeHistogram
+{
+public:
+    /** The number of buckets; the last one starts at about 4 seconds */
+    enum { BUCKETS = 24 };
+
+    XeHistogram();
+
+    /** Adds a sample, in nanoseconds. Negative samples count as zero */
+    void add(qint64 ns);
+    /** Adds all samples of another histogram to this one */
+    void merge(const XeHistogram &);
+    /** Removes all samples */
+    void clear();
+
+    /** Gets the number of samples added */
+    quint64 count() const;
+    /** Gets the number of samples in a bucket */
+    quint64 bucket(int i) const;
+    /** Gets the upper bound of a bucket, in microseconds */
+    static qint64 bucketLimit(int i);
+
+    /** Gets the smallest and largest samples, in nanoseconds, or 0 if the
+      * histogram is empty
+      */
+    qint64 min() const;
+    qint64 max() const;
+    /** Gets the mean of all samples, in nanoseconds */
+    qint64 mean() const;
+
+    /** Estimates the sample below which the given fraction (0-1) of samples
+      * fall, in nanoseconds. The estimate is the upper bound of the bucket it
+      * falls in, clamped to max(), so it is never lower than the real value
+      */
+    qint64 percentile(float p) const;
+
+    /** Writes the non-empty buckets to xe_trace */
+    void log(const char *title) const;
+
+private:
+    quint64 m_buckets[BUCKETS];
+    quint64 m_count;
+    qint64 m_sum;
+    qint64 m_min;
+    qint64 m_max;
+};
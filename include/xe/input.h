@@ -1,50 +1,143 @@
 
 #pragma once
 
+#include "xe/axisfilter.h"
 #include "xe/axisinput.h"
 #include "xe/buttoninput.h"
 #include "xe/global.h"
+#include "xe/inputhandle.h"
+#include "xe/inputevent.h"
+#include "xe/inputprogram.h"
+#include "xe/updatable.h"
 
+#include <QByteArray>
 #include <QHash>
+#include <QList>
+#include <QVector>
 
-/** Maps virtual button names to button objects */
+class XeBindingProfile;
+
+/** Maps virtual button names to button objects.
+  *
+  * Names can be resolved once to a handle, which indexes a flat table
+  * instead of hashing the name on every query. Remapping a name replaces
+  * its entry in the table, so handles stay valid and see the new button
+  */
 class XE_EXPORT XeButtonMap
 {
 public:
+    XeButtonMap();
+
     void map(const char *name, XeButtonInput *button);
     void unmap(const char *name);
 
     XeButtonInput *get(const char *name) const;
     XeButtonInput *operator[](const char *name) const;
 
+    /** Resolves a name to a handle. The name doesn't need to be mapped yet;
+      * the handle refers to whatever button is mapped to it at query time
+      */
+    XeButtonHandle handle(const char *name);
+    /** Gets the button mapped to a handle, or NULL if the name isn't mapped */
+    XeButtonInput *get(XeButtonHandle handle) const;
+    XeButtonInput *operator[](XeButtonHandle handle) const;
+    /** Gets the handle a name was resolved to, or an invalid handle if it
+      * never was
+      */
+    XeButtonHandle find(const char *name) const;
+    /** Gets the name a handle was resolved from */
+    const char *name(XeButtonHandle handle) const;
+
+    /** Gets the number of handles resolved so far. Handle indices range
+      * from 0 to count() - 1
+      */
+    int count() const;
+    /** Gets a number that changes whenever a name is mapped, unmapped or
+      * resolved to a new handle
+      */
+    quint64 revision() const;
+
 private:
-    QHash<QString, XeButtonInput*> m_map;
+    QHash<QByteArray, int> m_handles;
+    quint64 m_revision;
+    QVector<XeButtonInput*> m_buttons;
+    QVector<QByteArray> m_names;
 };
 
-/** Maps virtual axis names to axis objects */
+/** Maps virtual axis names to axis objects. Names can be resolved to handles
+  * in the same way as XeButtonMap
+  */
 class XE_EXPORT XeAxisMap
 {
 public:
+    XeAxisMap();
+
     void map(const char *name, XeAxisInput *button);
     void unmap(const char *name);
 
     XeAxisInput *get(const char *name) const;
     XeAxisInput *operator[](const char *name) const;
 
+    /** Resolves a name to a handle. The name doesn't need to be mapped yet */
+    XeAxisHandle handle(const char *name);
+    /** Gets the axis mapped to a handle, or NULL if the name isn't mapped */
+    XeAxisInput *get(XeAxisHandle handle) const;
+    XeAxisInput *operator[](XeAxisHandle handle) const;
+    /** Gets the handle a name was resolved to, or an invalid handle if it
+      * never was
+      */
+    XeAxisHandle find(const char *name) const;
+    /** Gets the name a handle was resolved from */
+    const char *name(XeAxisHandle handle) const;
+
+    /** Gets the number of handles resolved so far. Handle indices range
+      * from 0 to count() - 1
+      */
+    int count() const;
+    /** Gets a number that changes whenever a name is mapped, unmapped or
+      * resolved to a new handle
+      */
+    quint64 revision() const;
+
 private:
-    QHash<QString, XeAxisInput*> m_map;
+    QHash<QByteArray, int> m_handles;
+    quint64 m_revision;
+    QVector<XeAxisInput*> m_axes;
+    QVector<QByteArray> m_names;
 };
 
-/** Manages the application-level button and axis maps */
-class XE_EXPORT XeInput
+/** Manages the application-level button and axis maps.
+  *
+  * Once per tick (before the current screen is updated), the kernel calls
+  * update(), which evaluates every mapped input once through an
+  * XeInputProgram. Queries during the tick are then served from the
+  * program's results instead of evaluating composite inputs again. The
+  * program is recompiled automatically when the maps change; call
+  * recompile() after attaching or detaching children of a composite
+  * input that is already mapped. Buttons held across a recompile stay
+  * down rather than registering as pressed again.
+  *
+  * Names can also be bound by an XeBindingProfile (see setProfile()). A
+  * name bound by the profile takes its binding over whatever is mapped to
+  * it in b or a.
+  */
+class XE_EXPORT XeInput : public XeUpdatable
 {
 public:
+    XeInput();
+
     /** Maps virtual names to axis inputs */
     XeAxisMap a;
 
     /** Maps virtual names to butotn inputs */
     XeButtonMap b;
 
+    /** Dead zones, curves and smoothing for mapped axes, by XeAxisHandle.
+      * value() returns axis values after these filters, as of the last
+      * update(); changes to the maps and filters apply from the next one
+      */
+    XeAxisFilters filters;
+
     bool isDown(const char *name) const;
     bool isUp(const char *name) const;
     bool isPressed(const char *name) const;
@@ -52,6 +145,72 @@ public:
 
     float value(const char *name) const;
     float value(const char *name, float min, float max) const;
+
+    /** Queries by handle skip the name lookup; resolve handles once with
+      * b.handle() and a.handle(), e.g. when a screen is loaded
+      */
+    bool isDown(XeButtonHandle button) const;
+    bool isUp(XeButtonHandle button) const;
+    bool isPressed(XeButtonHandle button) const;
+    bool isReleased(XeButtonHandle button) const;
+
+    float value(XeAxisHandle axis) const;
+    float value(XeAxisHandle axis, float min, float max) const;
+
+    /** Appends the events a button received since the last tick to out,
+      * oldest first, and returns how many there were. Only buttons that
+      * belong directly to a device record events; composite buttons (e.g.
+      * XeOrButton) have none
+      */
+    int buttonEvents(const char *name, QList<XeInputEvent> &out) const;
+    int buttonEvents(XeButtonHandle button, QList<XeInputEvent> &out) const;
+    /** Appends the events an axis received since the last tick to out,
+      * oldest first, and returns how many there were
+      */
+    int axisEvents(const char *name, QList<XeInputEvent> &out) const;
+    int axisEvents(XeAxisHandle axis, QList<XeInputEvent> &out) const;
+
+    /** Gets the number of times a button was pressed since the last tick.
+      * Unlike isPressed(), counts every press, however quick
+      */
+    int presses(const char *name) const;
+    int presses(XeButtonHandle button) const;
+
+    /** Evaluates all mapped inputs for this tick, recompiling the program
+      * first if the maps changed, and runs the axis filters. The kernel
+      * calls this on xe_input
+      */
+    void update(float dt);
+    /** Binds names from a profile, or unbinds them if profile is NULL. The
+      * profile isn't owned; it must stay alive until it is replaced. The
+      * program is recompiled at the next update(), and again whenever the
+      * profile changes (e.g. when it reloads its file) or a device is
+      * attached to or detached from xe_kernel
+      */
+    void setProfile(XeBindingProfile *profile);
+    XeBindingProfile *profile() const;
+
+    /** Recompiles the input program at the next update() */
+    void recompile();
+    /** Gets the compiled input program */
+    const XeInputProgram &program() const;
+
+private:
+    XeInputProgram m_program;
+    /** Filtered values of the mapped axes at the last update() */
+    QVector<float> m_values;
+    quint64 m_buttonRevision;
+    quint64 m_axisRevision;
+    XeBindingProfile *m_profile;
+    quint64 m_profileRevision;
+    quint64 m_deviceRevision;
+    bool m_dirty;
+
+    bool isCurrent() const;
+    bool devicesCurrent() const;
+    const XeButtonInput *leafButton(XeButtonHandle) const;
+    const XeAxisInput *leafAxis(XeAxisHandle) const;
+    void resolveProfile();
 };
 
 extern XE_EXPORT XeInput xe_input;
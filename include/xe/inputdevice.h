@@ -4,6 +4,7 @@
 #include "xe/axisinput.h"
 #include "xe/buttoninput.h"
 #include "xe/global.h"
+#include "xe/inputevent.h"
 #include "xe/updatable.h"
 
 #include <QList>
@@ -46,5 +47,21 @@ public:
       * If no such button exists, returns NULL.
       */
     virtual XeButtonInput *button(const char *id) const = 0;
+
+    /** Gets the timestamped button and axis events this device received
+      * since the last tick
+      */
+    const XeInputEventQueue &events() const;
+    /** Marks the events received since the last call as seen by game code at
+      * the given time (see XeInputEvent::observed), and returns how many there
+      * were. Called by XeInputLatency at the start of each tick
+      */
+    int observe(qint64 when);
+
+protected:
+    /** Devices push an event here for every change they receive, and clear
+      * it in update()
+      */
+    XeInputEventQueue m_events;
 };
 
@@ -0,0 +1,105 @@
+
+#pragma once
+
+#include "xe/global.h"
+
+class XeAxisInput;
+class XeButtonInput;
+
+/** A single change to one of a device's inputs, stamped with the time the
+  * host reported it
+  */
+class XE_EXPORT XeInputEvent
+{
+public:
+    enum Type
+    {
+        /** A button went down */
+        PRESS,
+        /** A button went up */
+        RELEASE,
+        /** An axis moved; value holds the amount it moved by */
+        AXIS,
+    };
+
+    XeInputEvent();
+
+    Type type;
+    /** The button that changed, for PRESS and RELEASE events */
+    const XeButtonInput *button;
+    /** The axis that changed, for AXIS events */
+    const XeAxisInput *axis;
+    /** The amount an axis moved by. Zero for button events */
+    float value;
+    /** When the event was received, in nanoseconds on the clock returned
+      * by XeInputEventQueue::now()
+      */
+    qint64 time;
+    /** When game code first saw the event, on the same clock as time, or 0
+      * if it hasn't yet. Set by XeInputDevice::observe()
+      */
+    qint64 observed;
+};
+
+/** The events a device received since the last tick, oldest first.
+  *
+  * Button and axis state only reflects the latest value at each tick, so
+  * presses and releases that happen within a single tick collapse into one
+  * state change. The queue keeps each of them, along with when it happened
+  * relative to the start of the tick.
+  *
+  * The queue is a fixed-size ring: if more than CAPACITY events arrive
+  * within one tick, the oldest ones are overwritten.
+  */
+class XE_EXPORT XeInputEventQueue
+{
+public:
+    /** The maximum number of events kept per tick */
+    enum { CAPACITY = 256 };
+
+    XeInputEventQueue();
+
+    /** Gets the current time on the monotonic clock used to stamp events,
+      * in nanoseconds
+      */
+    static qint64 now();
+
+    /** Gets the time the queue was last cleared, i.e. the start of the
+      * window its events were received in
+      */
+    qint64 start() const;
+
+    /** Gets the number of events in the queue */
+    int count() const;
+    /** Gets an event; 0 is the oldest */
+    const XeInputEvent &operator[](int i) const;
+
+    /** Gets the total number of events that were overwritten because the
+      * queue was full
+      */
+    quint64 dropped() const;
+
+    /** Appends an event, stamping it with the given time, or with the
+      * current time if it is negative. Devices that coalesce several changes
+      * into one event pass the time of the first change
+      */
+    void push(XeInputEvent::Type type, const XeButtonInput *button, const XeAxisInput *axis = 0,
+              float value = 0.f, qint64 time = -1);
+    /** Stamps all events that haven't been observed yet with the given time.
+      * Returns the number of events stamped; they are the last ones in the
+      * queue
+      */
+    int observe(qint64 when);
+    /** Removes all events and starts a new window. Devices call this once
+      * per tick, after the tick has been processed
+      */
+    void clear();
+
+private:
+    XeInputEvent m_ring[CAPACITY];
+    int m_head;
+    int m_count;
+    int m_observed;
+    quint64 m_dropped;
+    qint64 m_start;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "xe/global.h"
+
+class XeAxisInput;
+class XeButtonInput;
+
+/** A pre-resolved virtual input name: an index into an XeButtonMap or
+  * XeAxisMap. Button and axis handles are distinct types, and neither
+  * converts to or from int implicitly, so one can't be passed where the
+  * other (or a plain number) is expected. A default-constructed handle
+  * refers to no name
+  */
+template<typename T>
+class XE_EXPORT XeInputHandle
+{
+public:
+    XeInputHandle() : index(-1) { }
+    explicit XeInputHandle(int index) : index(index) { }
+
+    /** The handle's index in its map, or -1 for none */
+    int index;
+
+    /** Gets whether the handle was resolved from a name */
+    bool isValid() const { return index >= 0; }
+
+    bool operator==(XeInputHandle other) const { return index == other.index; }
+    bool operator!=(XeInputHandle other) const { return index != other.index; }
+};
+
+/** A pre-resolved virtual button name. See XeButtonMap::handle() */
+typedef XeInputHandle<XeButtonInput> XeButtonHandle;
+/** A pre-resolved virtual axis name. See XeAxisMap::handle() */
+typedef XeInputHandle<XeAxisInput> XeAxisHandle;
@@ -0,0 +1,67 @@
+
+#pragma once
+
+#include "xe/global.h"
+#include "xe/histogram.h"
+#include "xe/inputdevice.h"
+#include "xe/metrics.h"
+#include "xe/updatable.h"
+
+#include <QList>
+
+/** Measures how old input is by the time game code sees it.
+  *
+  * Every input event is stamped when the host delivers it to its device
+  * (XeInputEvent::time). Each tick, update() stamps the events that arrived
+  * since the previous tick as observed (XeInputEvent::observed) and adds the
+  * difference to a latency histogram. Attach it to xe_kernel->preUpdate(),
+  * so it runs right before the screen's update reads the input.
+  *
+  * Every frames() ticks, the percentiles of the latencies measured during
+  * those ticks are published as gauges of an XeMetrics registry, from where
+  * they reach the telemetry reader and metrics logs along with the profiler.
+  */
+class XE_EXPORT XeInputLatency : public XeUpdatable
+{
+public:
+    /** Creates a latency tracker
+      * @param metrics The registry latency gauges are published to, or NULL
+      *                to not publish them
+      * @param frames  The number of ticks each published window covers
+      */
+    XeInputLatency(XeMetrics *metrics = &xe_metrics, int frames = 60);
+
+    /** Gets or sets the number of ticks each published window covers */
+    int frames() const;
+    void setFrames(int);
+
+    /** Gets the latencies measured during the last complete window */
+    const XeHistogram &window() const;
+    /** Gets all latencies measured since the tracker was created or reset */
+    const XeHistogram &total() const;
+    /** Discards all latencies measured so far */
+    void reset();
+
+    /** Stamps new events as observed and records their latency */
+    void update(float dt);
+
+    /** Writes the total latency histogram to xe_trace */
+    void log() const;
+
+private:
+    XeMetrics *m_metrics;
+    XeMetric m_eventsMetric;
+    XeMetric m_p50Metric;
+    XeMetric m_p99Metric;
+    XeMetric m_maxMetric;
+
+    XeHistogram m_current;
+    XeHistogram m_window;
+    XeHistogram m_total;
+    int m_frames;
+    int m_frame;
+
+    QList<XeInputDevice *> m_devices;
+
+    void publish();
+};
@@ -0,0 +1,142 @@
+
+#pragma once
+
+#include "xe/global.h"
+#include "xe/inputhandle.h"
+
+#include <QHash>
+#include <QVector>
+
+class XeAxisInput;
+class XeAxisMap;
+class XeBindingProfile;
+class XeButtonInput;
+class XeButtonMap;
+
+/** Evaluates every mapped button and axis once per tick.
+  *
+  * Composite inputs (XeAndButton, XeOrButton, XeNotButton, XeAxisButton and
+  * XeButtonAxis) evaluate their children through virtual calls each time
+  * they are queried, so a composite may be evaluated many times per tick.
+  * compile() instead flattens the graph behind an XeButtonMap and XeAxisMap
+  * into a linear list of operations, ordered so that every input comes
+  * after the inputs it depends on. Inputs shared by several composites are
+  * evaluated only once. run() evaluates the list into a dense state array
+  * that queries read directly.
+  *
+  * Any other input is a leaf: it is read once per run() through its
+  * virtual isDown() or value(). xe_input owns a program and keeps it up to
+  * date; see XeInput.
+  *
+  * Bindings from an XeBindingProfile are compiled from the profile's node
+  * tables directly, without building composite input objects first.
+  */
+class XE_EXPORT XeInputProgram
+{
+public:
+    XeInputProgram();
+
+    /** Compiles the inputs mapped in the given maps. Handles resolved from
+      * the maps index the compiled program. Names bound by profile use the
+      * profile's binding instead of the map's; device inputs the profile
+      * refers to are looked up through xe_kernel now.
+      *
+      * Buttons that were down at the last run() of the previous program
+      * start out down, so recompiling doesn't make held buttons register as
+      * pressed again. XeInput recompiles whenever the maps change, which
+      * includes resolving a handle for a new name in the middle of a game
+      */
+    void compile(const XeButtonMap &buttons, const XeAxisMap &axes, const XeBindingProfile *profile = 0);
+    /** Discards the compiled program */
+    void clear();
+    /** Gets a value indicating whether compile() has been called since the
+      * last clear()
+      */
+    bool isCompiled() const;
+
+    /** Evaluates the program. Call once per tick; the previous results are
+      * kept for wasDown()
+      */
+    void run();
+
+    /** Gets the number of operations in the program */
+    int size() const;
+
+    /** Gets whether a button was down at the last run(). Returns false for
+      * handles that were unmapped at compile time
+      */
+    bool isDown(XeButtonHandle button) const;
+    /** Gets whether a button was down at the run() before last */
+    bool wasDown(XeButtonHandle button) const;
+    /** Gets an axis's value at the last run(). Returns 0 for handles that
+      * were unmapped at compile time
+      */
+    float value(XeAxisHandle axis) const;
+
+    /** Gets whether a handle was mapped or bound at compile time */
+    bool hasButton(XeButtonHandle button) const;
+    bool hasAxis(XeAxisHandle axis) const;
+    /** Gets the device input a handle reads directly, or NULL if it is
+      * unmapped or a composite
+      */
+    const XeButtonInput *leafButton(XeButtonHandle button) const;
+    const XeAxisInput *leafAxis(XeAxisHandle axis) const;
+
+private:
+    enum Code
+    {
+        LOAD_BUTTON,
+        LOAD_AXIS,
+        AND,
+        OR,
+        NOT,
+        AXIS_BUTTON,
+        BUTTON_AXIS,
+        ZERO,
+    };
+
+    struct Op
+    {
+        Code code;
+        /** The register the result is written to */
+        int dst;
+        /** The first operand (for AND, OR and BUTTON_AXIS), or the input
+          * register (for NOT and AXIS_BUTTON)
+          */
+        int first;
+        /** The number of operands */
+        int count;
+        /** The activation range, for AXIS_BUTTON */
+        float min, max;
+        const XeButtonInput *button;
+        const XeAxisInput *axis;
+    };
+
+    struct Operand
+    {
+        int reg;
+        float up, down;
+    };
+
+    QVector<Op> m_ops;
+    QVector<Operand> m_operands;
+    QVector<float> m_state;
+    QVector<float> m_prevState;
+    /** The register of each handle, or -1 if it isn't mapped. Registers
+      * are also indices into m_ops, as each operation has its own register
+      */
+    QVector<int> m_buttonRegs;
+    QVector<int> m_axisRegs;
+    bool m_compiled;
+
+    // Compile-time only: the register assigned to each input, and inputs
+    // whose compilation is in progress, to detect cycles
+    QHash<const void*, int> m_regs;
+    QHash<const void*, bool> m_visiting;
+
+    int compileButton(const XeButtonInput *);
+    int compileAxis(const XeAxisInput *);
+    int compileButtonAsAxis(const XeButtonInput *);
+    void compileProfile(const XeBindingProfile &, QVector<int> &nodeRegs);
+    int allocate();
+};
@@ -0,0 +1,126 @@
+
+#pragma once
+
+#include "xe/global.h"
+#include "xe/input.h"
+#include "xe/updatable.h"
+
+#include <QExplicitlySharedDataPointer>
+#include <QList>
+#include <QMutex>
+#include <QVector>
+
+class XeInputDevice;
+class XeInputSnapshotData;
+
+/** The state of all input at one tick: every button and axis of every
+  * device, with their pressed/released edges, and every virtual input mapped
+  * in an XeInput.
+  *
+  * Snapshots never change once published, so any thread can read them
+  * without locking while the main thread goes on to the next tick. Copying a
+  * snapshot only bumps a reference count. Get one from
+  * XeInputPublisher::latest().
+  */
+class XE_EXPORT XeInputSnapshot
+{
+public:
+    /** The state of one button of a device */
+    struct Button
+    {
+        const char *deviceID;
+        const char *id;
+        bool down;
+        bool pressed;
+        bool released;
+    };
+
+    /** The state of one axis of a device */
+    struct Axis
+    {
+        const char *deviceID;
+        const char *id;
+        float value;
+    };
+
+    /** Creates an empty snapshot, with no inputs and a tick() of 0 */
+    XeInputSnapshot();
+    XeInputSnapshot(const XeInputSnapshot &);
+    ~XeInputSnapshot();
+    XeInputSnapshot &operator=(const XeInputSnapshot &);
+
+    /** Gets the number of the tick the snapshot was taken at, counting
+      * from 1, or 0 for an empty snapshot
+      */
+    quint64 tick() const;
+    /** Gets the time elapsed since the previous tick, in partial seconds */
+    float dt() const;
+
+    /** Gets the buttons and axes of all devices */
+    int buttonCount() const;
+    const Button &button(int i) const;
+    int axisCount() const;
+    const Axis &axis(int i) const;
+
+    /** Gets the index of a device's button or axis, or -1 if there is none */
+    int findButton(const char *deviceID, const char *id) const;
+    int findAxis(const char *deviceID, const char *id) const;
+
+    /** Gets the state of a virtual input mapped in the XeInput the snapshot
+      * was taken from. Handles must be resolved on the main thread, e.g.
+      * with xe_input.b.handle(); handles the snapshot doesn't know read as
+      * up and 0
+      */
+    bool isDown(XeButtonHandle button) const;
+    bool isUp(XeButtonHandle button) const;
+    bool isPressed(XeButtonHandle button) const;
+    bool isReleased(XeButtonHandle button) const;
+    float value(XeAxisHandle axis) const;
+
+private:
+    QExplicitlySharedDataPointer<XeInputSnapshotData> d;
+
+    friend class XeInputPublisher;
+    explicit XeInputSnapshot(XeInputSnapshotData *);
+};
+
+/** Takes an XeInputSnapshot once per tick.
+  *
+  * Attach the publisher to xe_kernel->preUpdate() after xe_input, so the
+  * snapshot is taken after mapped inputs are evaluated and before the
+  * screen's update. Snapshots are recycled once no one holds them any more,
+  * so as long as readers let go of old snapshots in time, publishing doesn't
+  * allocate; with a single reader, two buffers take turns.
+  */
+class XE_EXPORT XeInputPublisher : public XeUpdatable
+{
+public:
+    /** Creates a publisher
+      * @param input The virtual input maps to include in snapshots, or NULL
+      *              to include device inputs only
+      */
+    XeInputPublisher(XeInput *input = &xe_input);
+    ~XeInputPublisher();
+
+    /** Gets the last snapshot published. Safe to call from any thread */
+    XeInputSnapshot latest() const;
+
+    /** Gets the number of snapshot buffers allocated so far */
+    int poolSize() const;
+
+    /** Takes and publishes a snapshot */
+    void update(float dt);
+
+private:
+    XeInput *m_input;
+    quint64 m_tick;
+
+    QVector<XeInputSnapshotData*> m_pool;
+    XeInputSnapshot m_latest;
+    mutable QMutex m_lock;
+
+    QList<XeInputDevice *> m_devices;
+    QList<const char *> m_ids;
+
+    XeInputSnapshotData *acquire();
+};
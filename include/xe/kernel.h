@@ -7,6 +7,8 @@
 #include "xe/updater.h"
 #include "xe/window.h"
 
+#include <QByteArray>
+#include <QHash>
 #include <QStack>
 
 class XE_EXPORT XeKernel
@@ -15,7 +17,13 @@ public:
 
     enum HostInterface
     {
+        /** A Qt window with OpenGL, mouse and keyboard */
         HOST_QT,
+        /** No window, rendering or native devices; input comes only from
+          * attached devices (see XeSyntheticDevice). For bots, servers and
+          * automated tests
+          */
+        HOST_HEADLESS,
     };
 
     XeKernel(int& argc, char **argv);
@@ -35,8 +43,25 @@ public:
     XeWindow *window() const;
 
     bool hasDevice(const char *id) const;
+    void devices(QList<const char *> &out) const;
+    /** Fills out with all available devices, so callers that visit every
+      * device don't need to look each one up by ID
+      */
+    void devices(QList<XeInputDevice *> &out) const;
+    /** Gets a device by ID. Attached devices are found through a hash, so
+      * this stays cheap with many of them
+      */
     XeInputDevice *device(const char *id) const;
 
+    /** Adds a device that isn't provided by the host interface, e.g. an
+      * XeSyntheticDevice. It is found by ID like the native devices, and
+      * updated with them after each tick. The kernel doesn't take ownership
+      */
+    void attach(XeInputDevice *);
+    void detach(XeInputDevice *);
+    /** Gets a number that changes whenever a device is attached or detached */
+    quint64 deviceRevision() const;
+
     XeUpdater *preUpdate() const;
     XeUpdater *postUpdate() const;
 
@@ -45,6 +70,10 @@ public:
 
 private:
     QStack<XeScreen*> m_screen;
+    QList<XeInputDevice*> m_devices;
+    /** Attached devices by ID; the first one attached wins if IDs collide */
+    QHash<QByteArray, XeInputDevice*> m_deviceIndex;
+    quint64 m_deviceRevision;
 
     HostInterface m_host;
     bool m_executing;
@@ -6,4 +6,8 @@
 #include "xe/vector4.h"
 #include "xe/quaternion.h"
 #include "xe/matrix.h"
+#include "xe/affinematrix.h"
+#include "xe/vector4a.h"
+#include "xe/quaterniona.h"
+#include "xe/matrixa.h"
 
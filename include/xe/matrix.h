@@ -1,13 +1,34 @@
 #ifndef MATRIX_H
 #define MATRIX_H
 
+#include <cmath>   // sqrt(), fabs()
+
 class XeVector2;
 class XeVector3;
 class XeVector4;
 class XeQuaternion;
 
 /**
- * A 4x4 matrix
+ * A 4x4 matrix.
+ *
+ * Multiply(), Invert(), Determinant() and Transpose() use the instruction
+ * set chosen by XE_SIMD. Products and transposes are bit-identical to the
+ * XE_SIMD_SCALAR build, as long as the compiler doesn't contract
+ * multiplies and adds (see XeSimd). Inverses and determinants are computed
+ * from 2x2 blocks instead of cofactors, so they round differently. How far
+ * the two builds can drift apart depends on the matrix: for well-conditioned
+ * ones such as rigid transforms and moderate scales they agree to within a
+ * few units in the last place of the largest entry, but as |det| gets small
+ * relative to the entries the difference grows without bound, and neither
+ * result is accurate. Don't compare inverses of nearly singular matrices
+ * across builds.
+ *
+ * scale(), rotateX(), rotate(), translate() and the other chained
+ * transforms only recompute the columns the transform changes, instead of
+ * building the transform and multiplying by it. They give the same results
+ * as the full product, except that entries that come out as zero may
+ * differ in sign. To build a world matrix from scratch, use
+ * FromScaleRotationTranslation(), which needs no products at all
  * @author Dave Kilian
  * @date 3 February 2011
  */
@@ -28,9 +49,9 @@ public:
     };
 
     /** Gets the identity matrix */
-    static const XeMatrix& Identity();
+    static constexpr XeMatrix Identity();
     /** Gets the all-zeroes matrix */
-    static const XeMatrix& Zero();
+    static constexpr XeMatrix Zero();
 
     /** Computes the up unit vector in a matrix's transformed space */
     static XeVector3 Up(const XeMatrix& m);
@@ -72,6 +93,26 @@ public:
      * @param roll The rotation about the Z axis, in radians
      */
     static XeMatrix FromYawPitchRoll(float yaw, float pitch, float roll);
+    /**
+     * Creates a transformation that scales, then rotates, then translates.
+     * This is Scale(scale) * FromXeQuaternion(rotation) * Translate(translation),
+     * written directly into the matrix
+     * @param scale The scale along each axis
+     * @param rotation The rotation, as a unit quaternion
+     * @param translation The translation
+     */
+    static XeMatrix FromScaleRotationTranslation(const XeVector3& scale, const XeQuaternion& rotation, const XeVector3& translation);
+    /**
+     * Creates an array of scale-rotation-translation transformations, with
+     * the same results as FromScaleRotationTranslation()
+     * @param scales The scale of each transformation
+     * @param rotations The rotation of each transformation
+     * @param translations The translation of each transformation
+     * @param out The transformations; may not overlap the inputs
+     * @param count The number of transformations
+     */
+    static void FromScaleRotationTranslation(const XeVector3* scales, const XeQuaternion* rotations, const XeVector3* translations,
+                                             XeMatrix* out, int count);
     /**
      * Creates a camera transformation
      * @param cameraPos The position of the viewer
@@ -156,9 +197,9 @@ public:
     static XeMatrix Lerp(const XeMatrix& m1, const XeMatrix& m2, float amount);
 
     /** Creates a matrix whose entries are the identity matrix */
-    XeMatrix();
+    constexpr XeMatrix();
     /** Creates a matrix with the given parameters */
-    XeMatrix(float m11, float m12, float m13, float m14,
+    constexpr XeMatrix(float m11, float m12, float m13, float m14,
            float m21, float m22, float m23, float m24,
            float m31, float m32, float m33, float m34,
            float m41, float m42, float m43, float m44);
@@ -182,6 +223,8 @@ public:
     XeMatrix scale(float amount) const;
     /** Creates a matrix consisting of this matrix's transforms followed by a non-uniform scale */
     XeMatrix scale(const XeVector3& amounts) const;
+    /** Creates a matrix consisting of this matrix's transforms followed by a non-uniform scale */
+    XeMatrix scale(float x, float y, float z) const;
     /** Creates a matrix consisting of this matrix's transforms followed by a rotation about the X axis */
     XeMatrix rotateX(float angle) const;
     /** Creates a matrix consisting of this matrix's transforms followed by a rotation about the Y axis */
@@ -248,4 +291,313 @@ XeMatrix operator* (float lhs, const XeMatrix& rhs);
 /** Divides a matrix by a scalar */
 XeMatrix operator/ (float lhs, const XeMatrix& rhs);
 
+constexpr XeMatrix::XeMatrix()
+    : m{1, 0, 0, 0,
+        0, 1, 0, 0,
+        0, 0, 1, 0,
+        0, 0, 0, 1}
+{ }
+
+constexpr XeMatrix::XeMatrix(float m11, float m12, float m13, float m14,
+                             float m21, float m22, float m23, float m24,
+                             float m31, float m32, float m33, float m34,
+                             float m41, float m42, float m43, float m44)
+    : m{m11, m12, m13, m14,
+        m21, m22, m23, m24,
+        m31, m32, m33, m34,
+        m41, m42, m43, m44}
+{ }
+
+constexpr XeMatrix XeMatrix::Identity()
+{
+    return XeMatrix(1, 0, 0, 0,
+                    0, 1, 0, 0,
+                    0, 0, 1, 0,
+                    0, 0, 0, 1);
+}
+
+constexpr XeMatrix XeMatrix::Zero()
+{
+    return XeMatrix(0, 0, 0, 0,
+                    0, 0, 0, 0,
+                    0, 0, 0, 0,
+                    0, 0, 0, 0);
+}
+
+inline XeMatrix XeMatrix::Scale(float a)
+{
+    return XeMatrix(a, 0, 0, 0,
+                  0, a, 0, 0,
+                  0, 0, a, 0,
+                  0, 0, 0, 1);
+}
+
+inline XeMatrix XeMatrix::Scale(float x, float y, float z)
+{
+    return XeMatrix(x, 0, 0, 0,
+                  0, y, 0, 0,
+                  0, 0, z, 0,
+                  0, 0, 0, 1);
+}
+
+inline XeMatrix XeMatrix::Translate(float x, float y)
+{
+    return XeMatrix(1, 0, 0, 0,
+                  0, 1, 0, 0,
+                  0, 0, 1, 0,
+                  x, y, 0, 1);
+}
+
+inline XeMatrix XeMatrix::Translate(float x, float y, float z)
+{
+    return XeMatrix(1, 0, 0, 0,
+                  0, 1, 0, 0,
+                  0, 0, 1, 0,
+                  x, y, z, 1);
+}
+
+inline XeMatrix XeMatrix::Add(const XeMatrix &m1, const XeMatrix &m2)
+{
+    XeMatrix m;
+
+    for (int i = 0; i < 16; ++i)
+        m.m[i] = m1.m[i] + m2.m[i];
+
+    return m;
+}
+
+inline XeMatrix XeMatrix::Subtract(const XeMatrix &m1, const XeMatrix &m2)
+{
+    XeMatrix m;
+
+    for (int i = 0; i < 16; ++i)
+        m.m[i] = m1.m[i] - m2.m[i];
+
+    return m;
+}
+
+inline XeMatrix XeMatrix::Multiply(const XeMatrix &m, float a)
+{
+    XeMatrix out;
+
+    for (int i = 0; i < 16; ++i)
+        out.m[i] = a * m.m[i];
+
+    return out;
+}
+
+inline XeMatrix XeMatrix::Divide(const XeMatrix &m, float amount)
+{
+    return XeMatrix::Multiply(m, 1.f / amount);
+}
+
+inline XeMatrix XeMatrix::Negate(const XeMatrix &m)
+{
+    return XeMatrix::Multiply(m, -1.f);
+}
+
+inline bool XeMatrix::Equal(const XeMatrix &m1, const XeMatrix &m2, float epsilon)
+{
+    for (int i = 0; i < 16; i++)
+        if (fabs(m1.m[i] - m2.m[i]) > epsilon)
+            return false;
+    return true;
+}
+
+inline bool XeMatrix::NotEqual(const XeMatrix &m1, const XeMatrix &m2, float epsilon)
+{
+    return !XeMatrix::Equal(m1, m2, epsilon);
+}
+
+inline XeMatrix XeMatrix::Lerp(const XeMatrix &m1, const XeMatrix &m2, float amount)
+{
+    return XeMatrix::Add(XeMatrix::Multiply(m1, 1.f - amount), XeMatrix::Multiply(m2, amount));
+}
+
+inline XeMatrix XeMatrix::scale(float amount) const
+{
+    return scale(amount, amount, amount);
+}
+
+inline XeMatrix XeMatrix::scale(float x, float y, float z) const
+{
+    XeMatrix r = *this;
+    for (int i = 0; i < 16; i += 4)
+    {
+        r.m[i] = m[i] * x;
+        r.m[i + 1] = m[i + 1] * y;
+        r.m[i + 2] = m[i + 2] * z;
+    }
+
+    return r;
+}
+
+// The rotations only change two columns, each to a combination of both
+
+inline XeMatrix XeMatrix::rotateX(float angle) const
+{
+    float sinTheta = sin(angle);
+    float cosTheta = cos(angle);
+
+    XeMatrix r = *this;
+    for (int i = 0; i < 16; i += 4)
+    {
+        r.m[i + 1] = (m[i + 1] * cosTheta) - (m[i + 2] * sinTheta);
+        r.m[i + 2] = (m[i + 1] * sinTheta) + (m[i + 2] * cosTheta);
+    }
+
+    return r;
+}
+
+inline XeMatrix XeMatrix::rotateY(float angle) const
+{
+    float sinTheta = sin(angle);
+    float cosTheta = cos(angle);
+
+    XeMatrix r = *this;
+    for (int i = 0; i < 16; i += 4)
+    {
+        r.m[i] = (m[i] * cosTheta) + (m[i + 2] * sinTheta);
+        r.m[i + 2] = (m[i + 2] * cosTheta) - (m[i] * sinTheta);
+    }
+
+    return r;
+}
+
+inline XeMatrix XeMatrix::rotateZ(float angle) const
+{
+    float sinTheta = sin(angle);
+    float cosTheta = cos(angle);
+
+    XeMatrix r = *this;
+    for (int i = 0; i < 16; i += 4)
+    {
+        r.m[i] = (m[i] * cosTheta) - (m[i + 1] * sinTheta);
+        r.m[i + 1] = (m[i] * sinTheta) + (m[i + 1] * cosTheta);
+    }
+
+    return r;
+}
+
+inline XeMatrix XeMatrix::translate(float x, float y) const
+{
+    return translate(x, y, 0.f);
+}
+
+inline XeMatrix XeMatrix::translate(float x, float y, float z) const
+{
+    // Adds the last column, scaled by the translation, to the others. For an
+    // affine matrix that only changes the last row
+    XeMatrix r = *this;
+    for (int i = 0; i < 16; i += 4)
+    {
+        r.m[i] = m[i] + (m[i + 3] * x);
+        r.m[i + 1] = m[i + 1] + (m[i + 3] * y);
+        r.m[i + 2] = m[i + 2] + (m[i + 3] * z);
+    }
+
+    return r;
+}
+
+inline float XeMatrix::determinant() const
+{
+    return XeMatrix::Determinant(*this);
+}
+
+inline XeMatrix XeMatrix::invert() const
+{
+    return XeMatrix::Invert(*this);
+}
+
+inline XeMatrix XeMatrix::transpose() const
+{
+    return XeMatrix::Transpose(*this);
+}
+
+inline bool XeMatrix::operator== (const XeMatrix& rhs) const
+{
+    return XeMatrix::Equal(*this, rhs);
+}
+
+inline bool XeMatrix::operator!= (const XeMatrix& rhs) const
+{
+    return XeMatrix::NotEqual(*this, rhs);
+}
+
+inline XeMatrix XeMatrix::operator+ (const XeMatrix& rhs) const
+{
+    return XeMatrix::Add(*this, rhs);
+}
+
+inline XeMatrix XeMatrix::operator- (const XeMatrix& rhs) const
+{
+    return XeMatrix::Subtract(*this, rhs);
+}
+
+inline XeMatrix XeMatrix::operator- () const
+{
+    return XeMatrix::Negate(*this);
+}
+
+inline XeMatrix XeMatrix::operator* (const XeMatrix& rhs) const
+{
+    return XeMatrix::Multiply(*this, rhs);
+}
+
+inline XeMatrix XeMatrix::operator* (float rhs) const
+{
+    return XeMatrix::Multiply(*this, rhs);
+}
+
+inline XeMatrix XeMatrix::operator/ (float rhs) const
+{
+    return XeMatrix::Divide(*this, rhs);
+}
+
+inline XeMatrix& XeMatrix::operator+= (const XeMatrix& rhs)
+{
+    for (int i = 0; i < 16; ++i)
+        m[i] += rhs.m[i];
+
+    return *this;
+}
+
+inline XeMatrix& XeMatrix::operator-= (const XeMatrix& rhs)
+{
+    for (int i = 0; i < 16; ++i)
+        m[i] -= rhs.m[i];
+
+    return *this;
+}
+
+inline XeMatrix& XeMatrix::operator*= (const XeMatrix& rhs)
+{
+    // Every entry reads a whole row of this matrix, so the product can't be
+    // written in place
+    return (*this = XeMatrix::Multiply(*this, rhs));
+}
+
+inline XeMatrix& XeMatrix::operator*= (float rhs)
+{
+    for (int i = 0; i < 16; ++i)
+        m[i] *= rhs;
+
+    return *this;
+}
+
+inline XeMatrix& XeMatrix::operator/= (float rhs)
+{
+    return ((*this) *= (1.f / rhs));
+}
+
+inline XeMatrix operator* (float lhs, const XeMatrix& rhs)
+{
+    return rhs * lhs;
+}
+
+inline XeMatrix operator/ (float lhs, const XeMatrix& rhs)
+{
+    return rhs * (1.f / lhs);
+}
+
 #endif // MATRIX_H
@@ -0,0 +1,148 @@
+#ifndef MATRIXA_H
+#define MATRIXA_H
+
+#include "xe/matrix.h"
+#include "xe/simd.h"
+
+class XeVector4A;
+
+/**
+ * A 4x4 matrix kept in four SIMD registers, one per row, and aligned to 16
+ * bytes. Use it for math on matrices that stay in registers for a while,
+ * e.g. concatenating a chain of transforms, and XeMatrix to store them:
+ * converting between the two is four loads or stores.
+ *
+ * Results are bit-identical to the same operations on XeMatrix. Arrays of
+ * XeMatrixA on the heap need 16-byte aligned allocations, which malloc()
+ * gives on 64-bit platforms
+ */
+class XeMatrixA
+{
+public:
+    /** The rows of the matrix */
+    XeFloat4 r[4];
+
+    /** Gets the identity matrix */
+    static XeMatrixA Identity();
+
+    /** Computes a matrix-matrix multiplication */
+    static XeMatrixA Multiply(const XeMatrixA& m1, const XeMatrixA& m2);
+    /** Computes the determinant of a matrix */
+    static float Determinant(const XeMatrixA& m);
+    /** Computes the inverse of a matrix */
+    static XeMatrixA Invert(const XeMatrixA& m);
+    /** Computes the transpose of a matrix */
+    static XeMatrixA Transpose(const XeMatrixA& m);
+
+    /** Creates the identity matrix */
+    XeMatrixA();
+    /** Loads a packed matrix */
+    XeMatrixA(const XeMatrix& m);
+
+    /** Stores this matrix into a packed matrix */
+    XeMatrix packed() const;
+
+    /** Computes this matrix's determinant */
+    float determinant() const;
+    /** Computes the inverse of this matrix */
+    XeMatrixA invert() const;
+    /** Computes the transpose of this matrix */
+    XeMatrixA transpose() const;
+
+    /** Performs a matrix-matrix multiplication */
+    XeMatrixA operator* (const XeMatrixA& rhs) const;
+    /** Performs a matrix-vector multiplication */
+    XeVector4A operator* (const XeVector4A& rhs) const;
+    /** Multiplies this matrix by another matrix */
+    XeMatrixA& operator*= (const XeMatrixA& rhs);
+};
+
+inline XeMatrixA::XeMatrixA()
+{
+    r[0] = XeSimd::set(1, 0, 0, 0);
+    r[1] = XeSimd::set(0, 1, 0, 0);
+    r[2] = XeSimd::set(0, 0, 1, 0);
+    r[3] = XeSimd::set(0, 0, 0, 1);
+}
+
+inline XeMatrixA::XeMatrixA(const XeMatrix &m)
+{
+    r[0] = XeSimd::load(m.m);
+    r[1] = XeSimd::load(m.m + 4);
+    r[2] = XeSimd::load(m.m + 8);
+    r[3] = XeSimd::load(m.m + 12);
+}
+
+inline XeMatrixA XeMatrixA::Identity()
+{
+    return XeMatrixA();
+}
+
+inline XeMatrixA XeMatrixA::Multiply(const XeMatrixA &m1, const XeMatrixA &m2)
+{
+    // Each row of the product is a sum of m2's rows, scaled by the entries
+    // of m1's row, in the same order as XeMatrix::Multiply()
+    XeMatrixA m;
+    for (int i = 0; i < 4; ++i)
+    {
+        XeFloat4 row = XeSimd::mul(XeSimd::lane<0>(m1.r[i]), m2.r[0]);
+        row = XeSimd::add(row, XeSimd::mul(XeSimd::lane<1>(m1.r[i]), m2.r[1]));
+        row = XeSimd::add(row, XeSimd::mul(XeSimd::lane<2>(m1.r[i]), m2.r[2]));
+        row = XeSimd::add(row, XeSimd::mul(XeSimd::lane<3>(m1.r[i]), m2.r[3]));
+        m.r[i] = row;
+    }
+
+    return m;
+}
+
+inline XeMatrixA XeMatrixA::Transpose(const XeMatrixA &m)
+{
+    XeFloat4 t1 = XeSimd::shuffle<0, 1, 0, 1>(m.r[0], m.r[1]);
+    XeFloat4 t2 = XeSimd::shuffle<2, 3, 2, 3>(m.r[0], m.r[1]);
+    XeFloat4 t3 = XeSimd::shuffle<0, 1, 0, 1>(m.r[2], m.r[3]);
+    XeFloat4 t4 = XeSimd::shuffle<2, 3, 2, 3>(m.r[2], m.r[3]);
+
+    XeMatrixA t;
+    t.r[0] = XeSimd::shuffle<0, 2, 0, 2>(t1, t3);
+    t.r[1] = XeSimd::shuffle<1, 3, 1, 3>(t1, t3);
+    t.r[2] = XeSimd::shuffle<0, 2, 0, 2>(t2, t4);
+    t.r[3] = XeSimd::shuffle<1, 3, 1, 3>(t2, t4);
+    return t;
+}
+
+inline XeMatrix XeMatrixA::packed() const
+{
+    XeMatrix m;
+    XeSimd::store(m.m, r[0]);
+    XeSimd::store(m.m + 4, r[1]);
+    XeSimd::store(m.m + 8, r[2]);
+    XeSimd::store(m.m + 12, r[3]);
+    return m;
+}
+
+inline float XeMatrixA::determinant() const
+{
+    return XeMatrixA::Determinant(*this);
+}
+
+inline XeMatrixA XeMatrixA::invert() const
+{
+    return XeMatrixA::Invert(*this);
+}
+
+inline XeMatrixA XeMatrixA::transpose() const
+{
+    return XeMatrixA::Transpose(*this);
+}
+
+inline XeMatrixA XeMatrixA::operator* (const XeMatrixA& rhs) const
+{
+    return XeMatrixA::Multiply(*this, rhs);
+}
+
+inline XeMatrixA& XeMatrixA::operator*= (const XeMatrixA& rhs)
+{
+    return (*this = XeMatrixA::Multiply(*this, rhs));
+}
+
+#endif // MATRIXA_H
@@ -0,0 +1,120 @@
+
+#pragma once
+
+#include "xe/global.h"
+#include "xe/updatable.h"
+
+#include <QAtomicInteger>
+#include <QAtomicPointer>
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+
+/** A handle to a counter or gauge registered with an XeMetrics registry */
+typedef int XeMetric;
+
+/** A registry of integer counters and gauges, e.g. "entities alive" or
+  * "draw calls". Complements XeProfiler, which only measures time.
+  *
+  * Counters accumulate the increments made during a frame, and are reset
+  * when the frame ends. Increments go to a slot private to the calling
+  * thread, so they are cheap and never contend; the slots are merged once
+  * per frame in update(). Gauges hold a value until it is changed.
+  *
+  * After each update(), value() returns the merged values for the frame
+  * that just ended, and older frames remain available up to history().
+  */
+class XE_EXPORT XeMetrics : public XeUpdatable
+{
+public:
+    enum Type
+    {
+        /** Sums the increments made during each frame */
+        COUNTER,
+        /** Holds the last value it was set to */
+        GAUGE,
+    };
+
+    /** The maximum number of metrics a registry can hold */
+    enum { MAX_METRICS = 256 };
+
+    /** Creates a metrics registry
+      * @param history The number of frames of values to keep
+      */
+    XeMetrics(int history = 120);
+    ~XeMetrics();
+
+    /** Registers a counter, or returns the existing one with this name */
+    XeMetric counter(const char *name);
+    /** Registers a gauge, or returns the existing one with this name */
+    XeMetric gauge(const char *name);
+
+    /** Gets the metric with the given name, or -1 if there is none */
+    XeMetric find(const char *name) const;
+
+    /** Gets the number of registered metrics. Handles range from 0 to count() - 1 */
+    int count() const;
+
+    /** Gets the name a metric was registered with */
+    const char *name(XeMetric) const;
+    /** Gets whether a metric is a counter or a gauge */
+    Type type(XeMetric) const;
+
+    /** Adds to a counter. Safe to call from any thread */
+    void add(XeMetric counter, qint64 amount = 1);
+    /** Sets the value of a gauge. Safe to call from any thread */
+    void set(XeMetric gauge, qint64 value);
+    /** Adds to (or with a negative amount, subtracts from) the value of a
+      * gauge. Safe to call from any thread
+      */
+    void adjust(XeMetric gauge, qint64 amount);
+
+    /** Gets the value of a metric for the last completed frame */
+    qint64 value(XeMetric) const;
+    /** Gets the value of a metric for an earlier frame. A framesAgo of zero
+      * is the last completed frame. Returns 0 for frames older than history()
+      */
+    qint64 value(XeMetric, int framesAgo) const;
+
+    /** Gets the number of frames of values kept */
+    int history() const;
+    /** Gets the number of frames merged so far */
+    quint64 frames() const;
+
+    /** Merges per-thread counter increments and samples gauges, closing
+      * the current frame. The kernel calls this on xe_metrics once per tick
+      */
+    void update(float dt);
+
+    /** Writes the values for the last completed frame to xe_trace */
+    void log() const;
+
+private:
+    struct ThreadSlots
+    {
+        Qt::HANDLE thread;
+        QAtomicInteger<qint64> values[MAX_METRICS];
+        ThreadSlots *next;
+    };
+
+    QAtomicPointer<ThreadSlots> m_threads;
+    /** Unique to this registry, even if another one had the same address */
+    quint64 m_generation;
+    QAtomicInteger<qint64> m_gauges[MAX_METRICS];
+    QByteArray m_names[MAX_METRICS];
+    Type m_types[MAX_METRICS];
+    QAtomicInt m_count;
+
+    QHash<QByteArray, XeMetric> m_lookup;
+    mutable QMutex m_lock;
+
+    qint64 *m_history;
+    int m_historyFrames;
+    quint64 m_frames;
+
+    XeMetric reg(const char *name, Type type);
+    ThreadSlots *threadSlots();
+};
+
+/** The application's metrics registry */
+extern XE_EXPORT XeMetrics xe_metrics;
@@ -4,7 +4,8 @@
 #include "xe/buttoninput.h"
 #include "xe/global.h"
 
-#include <QString>
+#include <QByteArray>
+
 
 /** A button whose isDown() is true if and only if its child's isDown()
   * value is false. Acts like a NOT gate for XeButtonInput::isDown().
@@ -26,7 +27,13 @@ public:
 
 private:
     XeButtonInput *m_child;
-    QString m_id;
-    QString m_name;
+    /** Built by rename() when id() or name() is first asked for after the
+      * inputs change, so rebinding doesn't build or keep any strings
+      */
+    mutable QByteArray m_id;
+    mutable QByteArray m_name;
+    mutable bool m_named;
+
+    void rename() const;
 };
 
@@ -4,19 +4,23 @@
 #include "xe/buttoninput.h"
 #include "xe/global.h"
 
+#include <QByteArray>
 #include <QList>
-#include <QString>
 
 /** A button whose isDown() value is true if and only if one of its child
   * XeButtonInputs is also down. Acts like an OR gate for
   * XeButtonInput::isDown().
   */
-class XE_EXPORT XeOrButton : XeButtonInput
+class XE_EXPORT XeOrButton : public XeButtonInput
 {
 public:
+    XeOrButton();
+
     void attach(XeButtonInput *);
     void detach(XeButtonInput *);
     bool isAttached(XeButtonInput *) const;
+    /** Gets the attached buttons */
+    const QList<XeButtonInput *> &children() const;
 
     const char *id() const;
     const char *name() const;
@@ -26,9 +30,13 @@ public:
 
 private:
     QList<XeButtonInput *> m_children;
-    QString m_id;
-    QString m_name;
-
-    void rename();
+    /** Built by rename() when id() or name() is first asked for after the
+      * inputs change, so rebinding doesn't build or keep any strings
+      */
+    mutable QByteArray m_id;
+    mutable QByteArray m_name;
+    mutable bool m_named;
+
+    void rename() const;
 };
 
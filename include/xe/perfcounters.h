@@ -0,0 +1,94 @@
+
+#pragma once
+
+#include "xe/global.h"
+
+/** A set of CPU event counts. See XePerfCounters */
+class XE_EXPORT XePerfSample
+{
+public:
+    XePerfSample();
+
+    /** CPU cycles (hardware) */
+    quint64 cycles;
+    /** Instructions retired (hardware) */
+    quint64 instructions;
+    /** Last-level cache accesses (hardware) */
+    quint64 cacheReferences;
+    /** Last-level cache misses (hardware) */
+    quint64 cacheMisses;
+    /** Branch instructions retired (hardware) */
+    quint64 branches;
+    /** Mispredicted branches (hardware) */
+    quint64 branchMisses;
+
+    /** CPU time consumed by the thread, in nanoseconds (software) */
+    quint64 taskClock;
+    /** Page faults, minor and major (software) */
+    quint64 pageFaults;
+    /** Voluntary and involuntary context switches (software) */
+    quint64 contextSwitches;
+
+    /** Gets the number of instructions retired per cycle, or 0 if there were no cycles */
+    float ipc() const;
+    /** Gets the fraction of cache references that missed, or 0 if there were none */
+    float cacheMissRate() const;
+    /** Gets the fraction of branches that were mispredicted, or 0 if there were none */
+    float branchMissRate() const;
+
+    /** Gets the counts accumulated between two samples */
+    XePerfSample operator-(const XePerfSample &) const;
+    XePerfSample &operator+=(const XePerfSample &);
+};
+
+/** Reads CPU performance counters for the calling thread, to tell cache
+  * misses and branch mispredicts apart from plain instruction count.
+  *
+  * On Linux, hardware counters are read through perf_event_open(). Where
+  * they are unavailable (e.g. in most virtual machines, or when
+  * kernel.perf_event_paranoid forbids it), only the software counters
+  * (CPU time, page faults, context switches) are collected, from perf
+  * software events or failing that from getrusage(). Elsewhere, no counters
+  * are available and read() returns zeros.
+  *
+  * Counters only count events on the thread that called open(). Enable them
+  * on an XeProfiler with XeProfiler::setPerfCounters().
+  */
+class XE_EXPORT XePerfCounters
+{
+public:
+    enum Mode
+    {
+        /** No counters are open */
+        NONE,
+        /** Hardware and software counters are available */
+        HARDWARE,
+        /** Only the software counters are available */
+        SOFTWARE,
+    };
+
+    XePerfCounters();
+    ~XePerfCounters();
+
+    /** Opens the counters for the calling thread, preferring hardware
+      * counters. Returns the counters that were opened
+      */
+    Mode open();
+    /** Closes all counters */
+    void close();
+
+    /** Gets which counters are available */
+    Mode mode() const;
+
+    /** Reads the current values of all available counters. Counters that
+      * aren't available read as zero
+      */
+    XePerfSample read() const;
+
+private:
+    enum { HW_COUNTERS = 6, SW_COUNTERS = 3 };
+
+    Mode m_mode;
+    int m_hw[HW_COUNTERS];
+    int m_sw[SW_COUNTERS];
+};
@@ -1,19 +1,29 @@
 
 #pragma once
 
+#include "xe/alloctracker.h"
 #include "xe/global.h"
+#include "xe/perfcounters.h"
 #include "xe/updatable.h"
 
+#include <QElapsedTimer>
 #include <QHash>
-#include <QTime>
+#include <QStack>
+#include <QVector>
 
+class XeProfilerOverlay;
 class XeProfilerSection;
 
 /** A lightweight time-based profiler */
 class XE_EXPORT XeProfiler : public XeUpdatable
 {
 public:
-    /** Begins profiling a section of the update loop, e.g. "ai" or "physics" */
+    XeProfiler();
+    ~XeProfiler();
+
+    /** Begins profiling a section of the update loop, e.g. "ai" or "physics".
+      * Sections begun while another section is running are nested inside it
+      */
     void begin(const char *section);
     /** Ends profiling a section and takes a time sample */
     void end(const char *section);
@@ -24,21 +34,54 @@ public:
 
     /** Gets all the sections */
     void sections(QList<XeProfilerSection*> &out) const;
+    /** Gets all the sections, replacing the contents of out. Reuses out's
+      * storage, so it doesn't allocate once the set of sections stops growing
+      */
+    void sections(QVector<XeProfilerSection*> &out) const;
 
     /** Performs per-frame updating required by the profiler */
     void update(float dt);
 
+    /** Gets the number of the frame being profiled. Starts at zero and
+      * increases by one with each update()
+      */
+    quint64 frame() const;
+    /** Gets the duration of the last frame, in partial seconds */
+    float dt() const;
+
     /** Renders the profiler as a set of bars at the upper-left corner of the screen.
-      * Useful for showing CPU usage spikes in real time
+      * Useful for showing CPU usage spikes in real time. Requires a current
+      * GL context; see XeProfilerOverlay to draw the bars without one
       */
     void render(float dt) const;
 
     /** Writes the contents of the profiler to xe_trace */
     void log() const;
 
+    /** Gets the heap allocations made by all threads during the last frame.
+      * Always zero unless XE_ALLOC_TRACKING is enabled
+      */
+    const XeAllocStats &allocations() const;
+
+    /** Enables or disables reading CPU performance counters (cycles,
+      * instructions, cache and branch misses) at section boundaries. The
+      * counters only count events on the thread that enables them, so
+      * sections should be profiled on that thread.
+      * Returns the counters that are available; see XePerfCounters
+      */
+    XePerfCounters::Mode setPerfCounters(bool enabled);
+    /** Gets the performance counters in use, or NULL if they are disabled */
+    const XePerfCounters *perfCounters() const;
+
 private:
     QHash<QString, XeProfilerSection*> m_sections;
+    QStack<XeProfilerSection*> m_stack;
+    XePerfCounters *m_perf;
+    mutable XeProfilerOverlay *m_overlay;
+    quint64 m_frame;
     float m_dt;
+    XeAllocStats m_frameAllocs;
+    XeAllocStats m_threadStart, m_processStart;
 
     XeProfilerSection *get(const char *section);
 };
@@ -57,10 +100,33 @@ public:
 
     float dt() const;
 
+    /** Gets the section this section was nested in when it was last sampled,
+      * or NULL if it was not nested
+      */
+    const XeProfilerSection *parent() const;
+    /** Gets the XeProfiler::frame() the section was last sampled in */
+    quint64 frame() const;
+
+    /** Gets the heap allocations made by the profiling thread during the last
+      * sample. Always zero unless XE_ALLOC_TRACKING is enabled
+      */
+    const XeAllocStats &allocations() const;
+
+    /** Gets the CPU performance counter deltas for the last sample. Always
+      * zero unless XeProfiler::setPerfCounters() is enabled
+      */
+    const XePerfSample &perf() const;
+
 private:
     const char *m_name;
+    const XeProfilerSection *m_parent;
+    quint64 m_frame;
     float m_dt;
-    QTime m_time;
+    QElapsedTimer m_time;
+    XeAllocStats m_allocs;
+    XeAllocStats m_allocStart;
+    XePerfSample m_perf;
+    XePerfSample m_perfStart;
 
     friend class XeProfiler;
 };
@@ -0,0 +1,61 @@
+
+#pragma once
+
+#include "xe/global.h"
+#include "xe/updatable.h"
+
+#include <QFile>
+#include <QList>
+#include <QTextStream>
+
+class XeMetrics;
+class XeProfiler;
+class XeProfilerSection;
+
+/** Streams an XeProfiler's samples to a CSV file, one frame at a time.
+  * Works without a window or GL context, e.g. on headless servers or in
+  * automated performance runs.
+  *
+  * The file has one row per value, with the columns
+  *
+  *     frame,type,name,value
+  *
+  * where type is one of
+  * - dt:      the frame's duration in seconds (name is empty)
+  * - section: a section's time in seconds
+  * - allocs:  the number of allocations a section made (XE_ALLOC_TRACKING only)
+  * - bytes:   the number of bytes a section allocated (XE_ALLOC_TRACKING only)
+  * - metric:  the value of a counter or gauge, if a metrics registry is given
+  *
+  * Nested sections are named by their path, e.g. "Physics/Collision".
+  * Update the writer once per tick, after the profiler (and metrics) have
+  * been updated.
+  */
+class XE_EXPORT XeProfilerCsv : public XeUpdatable
+{
+public:
+    /** Creates a CSV report
+      * @param profiler The profiler to report on
+      * @param path     The path of the file to write. The file is overwritten
+      * @param metrics  A metrics registry to report next to the profiler
+      *                 sections, or NULL
+      */
+    XeProfilerCsv(XeProfiler *profiler, const char *path, XeMetrics *metrics = 0);
+    ~XeProfilerCsv();
+
+    /** Gets a value indicating whether the file was opened successfully */
+    bool isOpen() const;
+
+    /** Appends the profiler's last frame to the file */
+    void update(float dt);
+
+    /** Writes any buffered rows out to the file */
+    void flush();
+
+private:
+    XeProfiler *m_profiler;
+    XeMetrics *m_metrics;
+    QFile m_file;
+    QTextStream m_out;
+    QList<XeProfilerSection*> m_sections;
+};
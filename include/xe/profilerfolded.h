@@ -0,0 +1,43 @@
+
+#pragma once
+
+#include "xe/global.h"
+#include "xe/updatable.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+
+class XeProfiler;
+class XeProfilerSection;
+
+/** Accumulates an XeProfiler's samples into "folded stack" format, the input
+  * format of flamegraph tools. Each line names a stack of nested sections,
+  * outermost first and separated by semicolons, followed by the total time
+  * spent in the innermost section itself (excluding nested sections), in
+  * microseconds.
+  *
+  * Update the accumulator once per tick after the profiler has been updated,
+  * then write() the totals whenever needed.
+  */
+class XE_EXPORT XeProfilerFolded : public XeUpdatable
+{
+public:
+    XeProfilerFolded(XeProfiler *profiler);
+
+    /** Adds the profiler's last frame to the totals */
+    void update(float dt);
+
+    /** Discards the totals accumulated so far */
+    void clear();
+
+    /** Writes the totals to a file, overwriting it. Returns false if the
+      * file could not be written
+      */
+    bool write(const char *path) const;
+
+private:
+    XeProfiler *m_profiler;
+    QHash<QByteArray, quint64> m_stacks;
+    QList<XeProfilerSection*> m_sections;
+};
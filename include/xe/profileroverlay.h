@@ -0,0 +1,54 @@
+
+#pragma once
+
+#include "xe/global.h"
+
+#include <QImage>
+#include <QList>
+
+class XeProfiler;
+class XeProfilerSection;
+
+/** Rasterizes an XeProfiler's last frame into an in-memory image: one bar
+  * per section, scaled against a frame time budget, labelled with the
+  * section's name and time. Text is drawn with a built-in bitmap font, so
+  * this works without a GL context or a running QGuiApplication, e.g. to
+  * save overlay snapshots from a headless server.
+  *
+  * XeProfiler::render() uses this to draw the overlay on screen.
+  */
+class XE_EXPORT XeProfilerOverlay
+{
+public:
+    /** Creates an overlay
+      * @param width The width of the image, in pixels
+      * @param scale The size of one font pixel, in image pixels
+      */
+    XeProfilerOverlay(int width = 320, int scale = 1);
+
+    /** Gets or sets the frame time that spans the full width of a bar, in
+      * partial seconds. Defaults to 1/60 of a second
+      */
+    float budget() const;
+    void setBudget(float);
+
+    /** Redraws the image from the profiler's last frame. The image grows or
+      * shrinks vertically to fit all the sections
+      */
+    void draw(const XeProfiler &profiler);
+
+    /** Gets the image drawn by the last call to draw(), in
+      * QImage::Format_ARGB32
+      */
+    const QImage &image() const;
+
+private:
+    int m_width;
+    int m_scale;
+    float m_budget;
+    QImage m_image;
+    QList<XeProfilerSection*> m_sections;
+
+    void fill(int x, int y, int w, int h, QRgb color);
+    void text(int x, int y, const char *str, QRgb color);
+};
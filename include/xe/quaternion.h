@@ -4,6 +4,8 @@
 #include "xe/matrix.h"
 #include "xe/vector3.h"
 
+#include <cmath>   // sqrt(), fabs()
+
 /**
  * A quaternion. XeQuaternions are good for representing rotations, as they do not suffer from gimbal lock
  * @author Dave Kilian
@@ -19,9 +21,9 @@ public:
     };
 
     /** Gets the identity quaternion */
-    static const XeQuaternion& Identity();
+    static constexpr XeQuaternion Identity();
     /** Gets the all-zeroes quaternion */
-    static const XeQuaternion& Zero();
+    static constexpr XeQuaternion Zero();
 
     /**
      * Creates a quaternion representing the rotation of an angle about an arbitrary axis
@@ -83,9 +85,9 @@ public:
     static XeQuaternion Conjugate(const XeQuaternion& q);
 
     /** Creates the identity quaternion */
-    XeQuaternion();
+    constexpr XeQuaternion();
     /** Creates a quaternion with the specified components */
-    XeQuaternion(float x, float y, float z, float w);
+    constexpr XeQuaternion(float x, float y, float z, float w);
 
     /** Computes the magnitude of this quaternion */
     float length() const;
@@ -140,4 +142,243 @@ XeQuaternion operator* (float lhs, const XeQuaternion& rhs);
 /** Computes a scalar-quaternion quotient */
 XeQuaternion operator/ (float lhs, const XeQuaternion& rhs);
 
+constexpr XeQuaternion::XeQuaternion() : xyzw{0, 0, 0, 1} { }
+
+constexpr XeQuaternion::XeQuaternion(float x, float y, float z, float w) : xyzw{x, y, z, w} { }
+
+constexpr XeQuaternion XeQuaternion::Identity() { return XeQuaternion(0, 0, 0, 1); }
+constexpr XeQuaternion XeQuaternion::Zero() { return XeQuaternion(0, 0, 0, 0); }
+
+inline float XeQuaternion::Length(const XeQuaternion &q)
+{
+    return sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+}
+
+inline float XeQuaternion::LengthSquared(const XeQuaternion &q)
+{
+    return q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w;
+}
+
+inline XeQuaternion XeQuaternion::Normalize(const XeQuaternion &q)
+{
+    float a = 1.f / XeQuaternion::Length(q);
+    return XeQuaternion(q.x * a, q.y * a, q.z * a, q.w * a);
+}
+
+inline XeQuaternion XeQuaternion::Add(const XeQuaternion &q1, const XeQuaternion &q2)
+{
+    return XeQuaternion(q1.x + q2.x, q1.y + q2.y, q1.z + q2.z, q1.w + q2.w);
+}
+
+inline XeQuaternion XeQuaternion::Subtract(const XeQuaternion &q1, const XeQuaternion &q2)
+{
+    return XeQuaternion(q1.x - q2.x, q1.y - q2.y, q1.z - q2.z, q1.w - q2.w);
+}
+
+inline XeQuaternion XeQuaternion::Concatenate(const XeQuaternion &q1, const XeQuaternion &q2)
+{
+    return XeQuaternion::Multiply(q1, q2);
+}
+
+inline XeQuaternion XeQuaternion::Multiply(const XeQuaternion &q1, const XeQuaternion &q2)
+{
+    float t1 = (q1.y * q2.z) - (q1.z * q2.y);
+    float t2 = (q1.z * q2.x) - (q1.x * q2.z);
+    float t3 = (q1.x * q2.y) - (q1.y * q2.x);
+    float t4 = ((q1.x * q2.x) + (q1.y * q2.y)) + (q1.z * q2.z);
+
+    return XeQuaternion(((q1.x * q2.w) + (q2.x * q1.w)) + t1,
+                      ((q1.y * q2.w) + (q2.y * q1.w)) + t2,
+                      ((q1.z * q2.w) + (q2.z * q1.w)) + t3,
+                      (q1.w * q2.w) - t4);
+}
+
+inline XeQuaternion XeQuaternion::Multiply(const XeQuaternion &q, float a)
+{
+    return XeQuaternion(q.x * a, q.y * a, q.z * a, q.w * a);
+}
+
+inline XeQuaternion XeQuaternion::Divide(const XeQuaternion &q, float amount)
+{
+    return XeQuaternion::Multiply(q, 1.f / amount);
+}
+
+inline XeQuaternion XeQuaternion::Negate(const XeQuaternion &q)
+{
+    return XeQuaternion::Multiply(q, -1.f);
+}
+
+inline bool XeQuaternion::Equal(const XeQuaternion &q1, const XeQuaternion &q2, float epsilon)
+{
+    for (int i = 0; i < 4; i++)
+        if (fabs(q1.xyzw[i] - q2.xyzw[i]) > epsilon)
+            return false;
+    return true;
+}
+
+inline bool XeQuaternion::NotEqual(const XeQuaternion &q1, const XeQuaternion &q2, float epsilon)
+{
+    for (int i = 0; i < 4; i++)
+        if (fabs(q1.xyzw[i] - q2.xyzw[i]) > epsilon)
+            return true;
+    return false;
+}
+
+inline float XeQuaternion::Dot(const XeQuaternion &q1, const XeQuaternion &q2)
+{
+    return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+}
+
+inline XeQuaternion XeQuaternion::Lerp(const XeQuaternion &q1, const XeQuaternion &q2, float amount)
+{
+    return XeQuaternion::Add(XeQuaternion::Multiply(q1, 1.f - amount), XeQuaternion::Multiply(q2, amount));
+}
+
+inline XeQuaternion XeQuaternion::Invert(const XeQuaternion &q)
+{
+    float f = -1.f / (q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    return XeQuaternion(f * q.x, f * q.y, f * q.z, q.w);
+}
+
+inline XeQuaternion XeQuaternion::Conjugate(const XeQuaternion &q)
+{
+    return XeQuaternion(-q.x, -q.y, -q.z, q.w);
+}
+
+inline float XeQuaternion::length() const
+{
+    return XeQuaternion::Length(*this);
+}
+
+inline float XeQuaternion::lengthSquared() const
+{
+    return XeQuaternion::LengthSquared(*this);
+}
+
+inline XeQuaternion XeQuaternion::normalize() const
+{
+    return XeQuaternion::Normalize(*this);
+}
+
+inline float XeQuaternion::dot(const XeQuaternion &other) const
+{
+    return XeQuaternion::Dot(*this, other);
+}
+
+inline XeQuaternion XeQuaternion::invert() const
+{
+    return XeQuaternion::Invert(*this);
+}
+
+inline XeQuaternion XeQuaternion::conjugate() const
+{
+    return XeQuaternion::Conjugate(*this);
+}
+
+inline bool XeQuaternion::operator== (const XeQuaternion& rhs) const
+{
+    return XeQuaternion::Equal(*this, rhs);
+}
+
+inline bool XeQuaternion::operator!= (const XeQuaternion& rhs) const
+{
+    return XeQuaternion::NotEqual(*this, rhs);
+}
+
+inline XeQuaternion XeQuaternion::operator+ (const XeQuaternion& rhs) const
+{
+    return XeQuaternion::Add(*this, rhs);
+}
+
+inline XeQuaternion XeQuaternion::operator- (const XeQuaternion& rhs) const
+{
+    return XeQuaternion::Subtract(*this, rhs);
+}
+
+inline XeQuaternion XeQuaternion::operator- () const
+{
+    return XeQuaternion::Negate(*this);
+}
+
+inline XeQuaternion XeQuaternion::operator* (const XeQuaternion& rhs) const
+{
+    return XeQuaternion::Multiply(*this, rhs);
+}
+
+inline XeQuaternion XeQuaternion::operator* (float rhs) const
+{
+    return XeQuaternion::Multiply(*this, rhs);
+}
+
+inline XeQuaternion XeQuaternion::operator/ (const XeQuaternion& rhs) const
+{
+    return XeQuaternion::Divide(*this, rhs);
+}
+
+inline XeQuaternion XeQuaternion::operator/ (float rhs) const
+{
+    return XeQuaternion::Divide(*this, rhs);
+}
+
+inline XeQuaternion& XeQuaternion::operator+= (const XeQuaternion& rhs)
+{
+    x += rhs.x;
+    y += rhs.y;
+    z += rhs.z;
+    w += rhs.w;
+
+    return *this;
+}
+
+inline XeQuaternion& XeQuaternion::operator-= (const XeQuaternion& rhs)
+{
+    x -= rhs.x;
+    y -= rhs.y;
+    z -= rhs.z;
+    w -= rhs.w;
+
+    return *this;
+}
+
+inline XeQuaternion& XeQuaternion::operator*= (const XeQuaternion& rhs)
+{
+    float t1 = (y * rhs.z) - (z * rhs.y);
+    float t2 = (z * rhs.x) - (x * rhs.z);
+    float t3 = (x * rhs.y) - (y * rhs.x);
+    float t4 = ((x * rhs.x) + (y * rhs.y)) + (z * rhs.z);
+
+    x = x * rhs.w + rhs.x * w + t1;
+    y = y * rhs.w + rhs.y * w + t2;
+    z = z * rhs.w + rhs.z * w + t3;
+    w = w * rhs.w - t4;
+
+    return *this;
+}
+
+inline XeQuaternion& XeQuaternion::operator*= (float a)
+{
+    x *= a;
+    y *= a;
+    z *= a;
+    w *= a;
+
+    return *this;
+}
+
+inline XeQuaternion& XeQuaternion::operator/= (float a)
+{
+    *this *= 1.f / a;
+    return *this;
+}
+
+inline XeQuaternion operator* (float lhs, const XeQuaternion& rhs)
+{
+    return XeQuaternion::Multiply(rhs, lhs);
+}
+
+inline XeQuaternion operator/ (float lhs, const XeQuaternion& rhs)
+{
+    return XeQuaternion::Divide(rhs, lhs);
+}
+
 #endif // QUATERNION_H
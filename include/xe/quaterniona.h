@@ -0,0 +1,189 @@
+#ifndef QUATERNIONA_H
+#define QUATERNIONA_H
+
+#include "xe/quaternion.h"
+#include "xe/simd.h"
+
+#include <cmath>   // sqrt()
+
+/**
+ * A quaternion kept in a SIMD register and aligned to 16 bytes. Compute
+ * with it, and store quaternions as XeQuaternion. Results are
+ * bit-identical to the same operations on XeQuaternion
+ */
+class XeQuaternionA
+{
+public:
+    /** (x, y, z, w) */
+    XeFloat4 v;
+
+    /** Gets the identity quaternion */
+    static XeQuaternionA Identity();
+
+    /** Computes the magnitude of a quaternion */
+    static float Length(const XeQuaternionA& q);
+    /** Computes the square of the magnitude of a quaternion */
+    static float LengthSquared(const XeQuaternionA& q);
+    /** Computes the dot product between two quaternions */
+    static float Dot(const XeQuaternionA& q1, const XeQuaternionA& q2);
+    /** Scales a quaternion to unit length */
+    static XeQuaternionA Normalize(const XeQuaternionA& q);
+    /** Computes the conjugate of a quaternion */
+    static XeQuaternionA Conjugate(const XeQuaternionA& q);
+    /** Computes a quaternion-quaternion product */
+    static XeQuaternionA Multiply(const XeQuaternionA& q1, const XeQuaternionA& q2);
+    /**
+     * Computes the linear interpolation between two quaternions
+     * @param q1 The quaternion at amount 0
+     * @param q2 The quaternion at amount 1
+     * @param amount The position between the quaternions
+     */
+    static XeQuaternionA Lerp(const XeQuaternionA& q1, const XeQuaternionA& q2, float amount);
+
+    /** Creates the identity quaternion */
+    XeQuaternionA();
+    /** Creates a quaternion with the specified components */
+    XeQuaternionA(float x, float y, float z, float w);
+    /** Loads a packed quaternion */
+    XeQuaternionA(const XeQuaternion& q);
+    /** Wraps a SIMD register */
+    explicit XeQuaternionA(XeFloat4 v);
+
+    /** Stores this quaternion into a packed quaternion */
+    XeQuaternion packed() const;
+
+    /** Computes the magnitude of this quaternion */
+    float length() const;
+    /** Scales this quaternion to unit length */
+    XeQuaternionA normalize() const;
+    /** Computes the conjugate of this quaternion */
+    XeQuaternionA conjugate() const;
+
+    /** Computes the sum of two quaternions */
+    XeQuaternionA operator+ (const XeQuaternionA& rhs) const;
+    /** Computes the difference between two quaternions */
+    XeQuaternionA operator- (const XeQuaternionA& rhs) const;
+    /** Computes a quaternion-quaternion product */
+    XeQuaternionA operator* (const XeQuaternionA& rhs) const;
+    /** Computes a quaternion-scalar product */
+    XeQuaternionA operator* (float rhs) const;
+
+    /** Multiplies this quaternion by another quaternion */
+    XeQuaternionA& operator*= (const XeQuaternionA& rhs);
+};
+
+inline XeQuaternionA::XeQuaternionA() : v(XeSimd::set(0, 0, 0, 1)) { }
+
+inline XeQuaternionA::XeQuaternionA(float x, float y, float z, float w) : v(XeSimd::set(x, y, z, w)) { }
+
+inline XeQuaternionA::XeQuaternionA(const XeQuaternion &q) : v(XeSimd::load(q.xyzw)) { }
+
+inline XeQuaternionA::XeQuaternionA(XeFloat4 v) : v(v) { }
+
+inline XeQuaternionA XeQuaternionA::Identity()
+{
+    return XeQuaternionA();
+}
+
+inline float XeQuaternionA::Length(const XeQuaternionA &q)
+{
+    return sqrt(XeQuaternionA::Dot(q, q));
+}
+
+inline float XeQuaternionA::LengthSquared(const XeQuaternionA &q)
+{
+    return XeQuaternionA::Dot(q, q);
+}
+
+inline float XeQuaternionA::Dot(const XeQuaternionA &q1, const XeQuaternionA &q2)
+{
+    return XeSimd::sum(XeSimd::mul(q1.v, q2.v));
+}
+
+inline XeQuaternionA XeQuaternionA::Normalize(const XeQuaternionA &q)
+{
+    return XeQuaternionA(XeSimd::mul(q.v, XeSimd::splat(1.f / q.length())));
+}
+
+inline XeQuaternionA XeQuaternionA::Conjugate(const XeQuaternionA &q)
+{
+    return XeQuaternionA(XeSimd::mul(q.v, XeSimd::set(-1.f, -1.f, -1.f, 1.f)));
+}
+
+inline XeQuaternionA XeQuaternionA::Multiply(const XeQuaternionA &q1, const XeQuaternionA &q2)
+{
+    // x, y and z are (q1 q2.w + q2 q1.w) + q1 x q2, and w is
+    // q1.w q2.w - ((q1.x q2.x + q1.y q2.y) + q1.z q2.z), computed in the same
+    // order as XeQuaternion::Multiply()
+    XeFloat4 a = XeSimd::shuffle<1, 2, 0, 3>(q1.v, q1.v);
+    XeFloat4 b = XeSimd::shuffle<2, 0, 1, 3>(q2.v, q2.v);
+    XeFloat4 c = XeSimd::shuffle<2, 0, 1, 3>(q1.v, q1.v);
+    XeFloat4 d = XeSimd::shuffle<1, 2, 0, 3>(q2.v, q2.v);
+    XeFloat4 cross = XeSimd::sub(XeSimd::mul(a, b), XeSimd::mul(c, d));
+
+    XeFloat4 xyz = XeSimd::add(XeSimd::mul(q1.v, XeSimd::lane<3>(q2.v)),
+                               XeSimd::mul(q2.v, XeSimd::lane<3>(q1.v)));
+    xyz = XeSimd::add(xyz, cross);
+
+    XeFloat4 p = XeSimd::mul(q1.v, q2.v);
+    float t = (XeSimd::first(p) + XeSimd::first(XeSimd::lane<1>(p))) + XeSimd::first(XeSimd::lane<2>(p));
+    XeFloat4 w = XeSimd::splat(XeSimd::first(XeSimd::lane<3>(p)) - t);
+
+    // (x, y, z, w)
+    return XeQuaternionA(XeSimd::shuffle<0, 1, 0, 2>(xyz, XeSimd::shuffle<2, 2, 0, 0>(xyz, w)));
+}
+
+inline XeQuaternionA XeQuaternionA::Lerp(const XeQuaternionA &q1, const XeQuaternionA &q2, float amount)
+{
+    return XeQuaternionA(XeSimd::add(XeSimd::mul(q1.v, XeSimd::splat(1.f - amount)),
+                                     XeSimd::mul(q2.v, XeSimd::splat(amount))));
+}
+
+inline XeQuaternion XeQuaternionA::packed() const
+{
+    XeQuaternion q;
+    XeSimd::store(q.xyzw, v);
+    return q;
+}
+
+inline float XeQuaternionA::length() const
+{
+    return XeQuaternionA::Length(*this);
+}
+
+inline XeQuaternionA XeQuaternionA::normalize() const
+{
+    return XeQuaternionA::Normalize(*this);
+}
+
+inline XeQuaternionA XeQuaternionA::conjugate() const
+{
+    return XeQuaternionA::Conjugate(*this);
+}
+
+inline XeQuaternionA XeQuaternionA::operator+ (const XeQuaternionA& rhs) const
+{
+    return XeQuaternionA(XeSimd::add(v, rhs.v));
+}
+
+inline XeQuaternionA XeQuaternionA::operator- (const XeQuaternionA& rhs) const
+{
+    return XeQuaternionA(XeSimd::sub(v, rhs.v));
+}
+
+inline XeQuaternionA XeQuaternionA::operator* (const XeQuaternionA& rhs) const
+{
+    return XeQuaternionA::Multiply(*this, rhs);
+}
+
+inline XeQuaternionA XeQuaternionA::operator* (float rhs) const
+{
+    return XeQuaternionA(XeSimd::mul(v, XeSimd::splat(rhs)));
+}
+
+inline XeQuaternionA& XeQuaternionA::operator*= (const XeQuaternionA& rhs)
+{
+    return (*this = XeQuaternionA::Multiply(*this, rhs));
+}
+
+#endif // QUATERNIONA_H
@@ -0,0 +1,89 @@
+
+#pragma once
+
+#include "xe/global.h"
+
+#include <QAtomicInteger>
+#include <QList>
+#include <QMutex>
+
+/** A statistical profiler that periodically interrupts running threads and
+  * records their call stacks. Complements XeProfiler, whose sections only
+  * show the code that was explicitly wrapped.
+  *
+  * Each sampled thread gets a CPU-time timer that delivers SIGPROF at the
+  * configured rate. The signal handler copies the thread's call stack into
+  * a preallocated buffer without taking any locks; stacks are symbolized
+  * afterwards, when writing the results out.
+  *
+  * Sampling is currently only supported on Linux (glibc). For readable
+  * symbol names, link the application with -rdynamic.
+  */
+class XE_EXPORT XeSamplingProfiler
+{
+public:
+    /** The maximum number of frames recorded per call stack */
+    enum { MAX_DEPTH = 64 };
+
+    /** Creates a sampling profiler
+      * @param capacity The size of the sample buffer, in stack frames.
+      *                 Once it fills up, further samples are dropped
+      */
+    XeSamplingProfiler(int capacity = 1 << 20);
+    ~XeSamplingProfiler();
+
+    /** Gets a value indicating whether sampling is supported on this platform */
+    static bool isSupported();
+
+    /** Starts sampling the calling thread. Only one sampling profiler can be
+      * running at a time; returns false if another one is, or if sampling
+      * is not supported
+      * @param hz The number of samples taken per second of CPU time
+      */
+    bool start(int hz = 1000);
+    /** Stops sampling all threads. Blocks until no thread is still in the
+      * middle of recording a sample
+      */
+    void stop();
+    /** Gets a value indicating whether this profiler is sampling */
+    bool isRunning() const;
+
+    /** Starts sampling the calling thread as well. The profiler must be running */
+    bool attach();
+    /** Stops sampling the calling thread */
+    void detach();
+
+    /** Gets the number of samples recorded so far */
+    int samples() const;
+    /** Gets the number of samples dropped because the buffer was full */
+    int dropped() const;
+    /** Discards all recorded samples. The profiler must be stopped */
+    void clear();
+
+    /** Writes the recorded samples in "folded stack" format, one line per
+      * unique call stack (outermost frame first, separated by semicolons)
+      * followed by the number of times it was sampled. This is the input
+      * format of flamegraph tools. The profiler must be stopped.
+      * Returns false if the file could not be written
+      */
+    bool writeFolded(const char *path) const;
+
+private:
+    void **m_buffer;
+    int m_capacity;
+    QAtomicInt m_used;
+    QAtomicInt m_samples;
+    QAtomicInt m_dropped;
+    int m_interval;
+
+    struct Timer
+    {
+        Qt::HANDLE thread;
+        void *timer;
+    };
+
+    QList<Timer> m_timers;
+    mutable QMutex m_lock;
+
+    friend struct XeSamplingProfilerHandler;
+};
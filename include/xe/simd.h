@@ -0,0 +1,217 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include "xe/config.h"
+
+#if XE_SIMD == XE_SIMD_SSE
+#   include <xmmintrin.h>
+#elif XE_SIMD == XE_SIMD_NEON
+#   include <arm_neon.h>
+#endif
+
+/**
+ * Four floats processed together: an SSE or NEON register, or a plain
+ * array when XE_SIMD is XE_SIMD_SCALAR. Only use it through XeSimd, so
+ * code written against it builds for every instruction set
+ */
+#if XE_SIMD == XE_SIMD_SSE
+typedef __m128 XeFloat4;
+#elif XE_SIMD == XE_SIMD_NEON
+typedef float32x4_t XeFloat4;
+#else
+struct alignas(16) XeFloat4 { float v[4]; };
+#endif
+
+/**
+ * The operations the math library builds on, for each XE_SIMD instruction
+ * set. Multiplies and adds are never fused, so a computation gives the same
+ * result with every instruction set as long as it does its operations in
+ * the same order.
+ *
+ * That includes the scalar code around them, which compilers may contract
+ * into fused multiply-adds when the target has them: GCC does so by default
+ * outside strict ISO mode. The guarantee only holds when contraction is
+ * off, with -ffp-contract=off for GCC and Clang, or /fp:precise for MSVC.
+ * xenon.pro builds the library that way; code that includes the math
+ * headers needs the same flag
+ */
+struct XeSimd
+{
+    /** Loads four floats, which need not be aligned */
+    static inline XeFloat4 load(const float *p);
+    /** Stores four floats, which need not be aligned */
+    static inline void store(float *p, XeFloat4 v);
+    /** Stores the first three floats, leaving p[3] alone */
+    static inline void store3(float *p, XeFloat4 v);
+    /** Creates (x, y, z, w) */
+    static inline XeFloat4 set(float x, float y, float z, float w);
+    /** Creates (s, s, s, s) */
+    static inline XeFloat4 splat(float s);
+
+    static inline XeFloat4 add(XeFloat4 a, XeFloat4 b);
+    static inline XeFloat4 sub(XeFloat4 a, XeFloat4 b);
+    static inline XeFloat4 mul(XeFloat4 a, XeFloat4 b);
+    static inline XeFloat4 div(XeFloat4 a, XeFloat4 b);
+
+    /** Creates (a[X], a[Y], b[Z], b[W]), like _mm_shuffle_ps() */
+    template <int X, int Y, int Z, int W>
+    static inline XeFloat4 shuffle(XeFloat4 a, XeFloat4 b);
+    /** Creates (v[I], v[I], v[I], v[I]) */
+    template <int I>
+    static inline XeFloat4 lane(XeFloat4 v);
+    /** Gets v[0] */
+    static inline float first(XeFloat4 v);
+    /** Computes ((v[0] + v[1]) + v[2]) + v[3], in the order the scalar math
+     * sums dot products
+     */
+    static inline float sum(XeFloat4 v);
+};
+
+#if XE_SIMD == XE_SIMD_SSE
+
+XeFloat4 XeSimd::load(const float *p) { return _mm_loadu_ps(p); }
+void XeSimd::store(float *p, XeFloat4 v) { _mm_storeu_ps(p, v); }
+void XeSimd::store3(float *p, XeFloat4 v)
+{
+    _mm_storel_pi(reinterpret_cast<__m64*>(p), v);
+    _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+}
+XeFloat4 XeSimd::set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+XeFloat4 XeSimd::splat(float s) { return _mm_set1_ps(s); }
+
+XeFloat4 XeSimd::add(XeFloat4 a, XeFloat4 b) { return _mm_add_ps(a, b); }
+XeFloat4 XeSimd::sub(XeFloat4 a, XeFloat4 b) { return _mm_sub_ps(a, b); }
+XeFloat4 XeSimd::mul(XeFloat4 a, XeFloat4 b) { return _mm_mul_ps(a, b); }
+XeFloat4 XeSimd::div(XeFloat4 a, XeFloat4 b) { return _mm_div_ps(a, b); }
+
+template <int X, int Y, int Z, int W>
+XeFloat4 XeSimd::shuffle(XeFloat4 a, XeFloat4 b)
+{
+    return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+}
+
+template <int I>
+XeFloat4 XeSimd::lane(XeFloat4 v)
+{
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(I, I, I, I));
+}
+
+float XeSimd::first(XeFloat4 v) { return _mm_cvtss_f32(v); }
+
+#elif XE_SIMD == XE_SIMD_NEON
+
+XeFloat4 XeSimd::load(const float *p) { return vld1q_f32(p); }
+void XeSimd::store(float *p, XeFloat4 v) { vst1q_f32(p, v); }
+void XeSimd::store3(float *p, XeFloat4 v)
+{
+    vst1_f32(p, vget_low_f32(v));
+    vst1q_lane_f32(p + 2, v, 2);
+}
+XeFloat4 XeSimd::set(float x, float y, float z, float w)
+{
+    float v[4] = { x, y, z, w };
+    return vld1q_f32(v);
+}
+XeFloat4 XeSimd::splat(float s) { return vdupq_n_f32(s); }
+
+XeFloat4 XeSimd::add(XeFloat4 a, XeFloat4 b) { return vaddq_f32(a, b); }
+XeFloat4 XeSimd::sub(XeFloat4 a, XeFloat4 b) { return vsubq_f32(a, b); }
+XeFloat4 XeSimd::mul(XeFloat4 a, XeFloat4 b) { return vmulq_f32(a, b); }
+#   if defined(__aarch64__)
+XeFloat4 XeSimd::div(XeFloat4 a, XeFloat4 b) { return vdivq_f32(a, b); }
+#   else
+XeFloat4 XeSimd::div(XeFloat4 a, XeFloat4 b)
+{
+    // 32-bit NEON has no divide; divide lane by lane for exact results
+    float x[4], y[4];
+    vst1q_f32(x, a);
+    vst1q_f32(y, b);
+    return set(x[0] / y[0], x[1] / y[1], x[2] / y[2], x[3] / y[3]);
+}
+#   endif
+
+template <int X, int Y, int Z, int W>
+XeFloat4 XeSimd::shuffle(XeFloat4 a, XeFloat4 b)
+{
+    XeFloat4 v = vdupq_n_f32(vgetq_lane_f32(a, X));
+    v = vsetq_lane_f32(vgetq_lane_f32(a, Y), v, 1);
+    v = vsetq_lane_f32(vgetq_lane_f32(b, Z), v, 2);
+    return vsetq_lane_f32(vgetq_lane_f32(b, W), v, 3);
+}
+
+template <int I>
+XeFloat4 XeSimd::lane(XeFloat4 v)
+{
+    return vdupq_n_f32(vgetq_lane_f32(v, I));
+}
+
+float XeSimd::first(XeFloat4 v) { return vgetq_lane_f32(v, 0); }
+
+#else
+
+XeFloat4 XeSimd::load(const float *p)
+{
+    XeFloat4 v = { { p[0], p[1], p[2], p[3] } };
+    return v;
+}
+
+void XeSimd::store(float *p, XeFloat4 v)
+{
+    p[0] = v.v[0]; p[1] = v.v[1]; p[2] = v.v[2]; p[3] = v.v[3];
+}
+
+void XeSimd::store3(float *p, XeFloat4 v)
+{
+    p[0] = v.v[0]; p[1] = v.v[1]; p[2] = v.v[2];
+}
+
+XeFloat4 XeSimd::set(float x, float y, float z, float w)
+{
+    XeFloat4 v = { { x, y, z, w } };
+    return v;
+}
+
+XeFloat4 XeSimd::splat(float s) { return set(s, s, s, s); }
+
+XeFloat4 XeSimd::add(XeFloat4 a, XeFloat4 b)
+{
+    return set(a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]);
+}
+
+XeFloat4 XeSimd::sub(XeFloat4 a, XeFloat4 b)
+{
+    return set(a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]);
+}
+
+XeFloat4 XeSimd::mul(XeFloat4 a, XeFloat4 b)
+{
+    return set(a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]);
+}
+
+XeFloat4 XeSimd::div(XeFloat4 a, XeFloat4 b)
+{
+    return set(a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3]);
+}
+
+template <int X, int Y, int Z, int W>
+XeFloat4 XeSimd::shuffle(XeFloat4 a, XeFloat4 b)
+{
+    return set(a.v[X], a.v[Y], b.v[Z], b.v[W]);
+}
+
+template <int I>
+XeFloat4 XeSimd::lane(XeFloat4 v)
+{
+    return splat(v.v[I]);
+}
+
+float XeSimd::first(XeFloat4 v) { return v.v[0]; }
+
+#endif
+
+float XeSimd::sum(XeFloat4 v)
+{
+    return ((first(v) + first(lane<1>(v))) + first(lane<2>(v))) + first(lane<3>(v));
+}
+
+#endif // SIMD_H
@@ -0,0 +1,60 @@
+
+#pragma once
+
+#include "xe/global.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+/** A handle to an interned string. See XeStringTable::id() */
+typedef int XeStringId;
+
+/** Interns strings: stores one copy of each distinct string for the
+  * lifetime of the process, and hands out a pointer to it that never moves
+  * or dangles.
+  *
+  * Inputs and devices return interned strings from id() and name(), so
+  * those calls don't allocate and their results can be kept indefinitely.
+  * Interned strings with the same contents have the same address, so they
+  * can also be compared by pointer. Safe to use from any thread.
+  */
+class XE_EXPORT XeStringTable
+{
+public:
+    XeStringTable();
+    ~XeStringTable();
+
+    /** Gets the interned copy of a string, adding it if necessary */
+    const char *intern(const char *str);
+    const char *intern(const QByteArray &str);
+    const char *intern(const QString &str);
+
+    /** Gets a small integer that identifies a string, interning it if
+      * necessary. IDs are dense, starting at 0
+      */
+    XeStringId id(const char *str);
+    /** Gets the interned string with the given ID, or NULL if there is none */
+    const char *string(XeStringId id) const;
+
+    /** Gets the number of strings interned */
+    int count() const;
+
+private:
+    enum { BLOCK_SIZE = 16384 };
+
+    QHash<QByteArray, XeStringId> m_ids;
+    QVector<const char*> m_strings;
+    QVector<char*> m_blocks;
+    /** The block short strings are packed into, and how much of it is used */
+    char *m_current;
+    int m_blockUsed;
+    mutable QMutex m_lock;
+
+    XeStringId add(const QByteArray &str);
+};
+
+/** The application's string table */
+extern XE_EXPORT XeStringTable xe_strings;
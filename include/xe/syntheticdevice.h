@@ -0,0 +1,102 @@
+
+#pragma once
+
+#include "xe/global.h"
+#include "xe/inputdevice.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+/** An input device whose buttons and axes are driven through code rather
+  * than by the user, e.g. by a bot, an AI agent or an automated test.
+  *
+  * Buttons and axes are added at runtime under any ID, and behave exactly
+  * like those of a real device: they can be mapped in xe_input, isPressed()
+  * and isReleased() work across ticks, and every change is recorded in the
+  * device's event queue. Attach the device with XeKernel::attach() so it is
+  * found by ID and updated with the other devices each tick. It needs no
+  * window, so it works with the XeKernel::HOST_HEADLESS host interface.
+  *
+  * Devices are not thread safe: drive them from the thread that runs the
+  * kernel, e.g. from the screen's update() or an XeUpdatable attached to
+  * xe_kernel->preUpdate().
+  */
+class XE_EXPORT XeSyntheticDevice : public XeInputDevice
+{
+public:
+    /** Creates a device with no inputs
+      * @param id   The unique ID of the device
+      * @param name The human-readable name of the device, or NULL to use the ID
+      */
+    XeSyntheticDevice(const char *id, const char *name = 0);
+    ~XeSyntheticDevice();
+
+    /** Adds a button, or returns the existing button with this ID.
+      * @param name The human-readable name of the button, or NULL to use the ID
+      */
+    XeButtonInput *addButton(const char *id, const char *name = 0);
+    /** Adds an axis, or returns the existing axis with this ID.
+      * @param name     The human-readable name of the axis, or NULL to use the ID
+      * @param relative If true, the axis goes back to 0 after each tick, like
+      *                 mouse motion. Otherwise it holds its value, like a stick
+      */
+    XeAxisInput *addAxis(const char *id, const char *name = 0, bool relative = false);
+
+    /** Presses or releases a button. Pressing a button that is already down
+      * (or releasing one that is up) does nothing
+      */
+    void setDown(const char *id, bool down);
+    void setDown(XeButtonInput *button, bool down);
+    void press(const char *id);
+    void release(const char *id);
+
+    /** Sets the value of an axis */
+    void setAxis(const char *id, float value);
+    void setAxis(XeAxisInput *axis, float value);
+    /** Adds to the value of an axis. For relative axes, moves made within one
+      * tick add up
+      */
+    void moveAxis(const char *id, float delta);
+    void moveAxis(XeAxisInput *axis, float delta);
+
+    /** Releases all buttons and sets all axes to 0 */
+    void reset();
+
+    const char *id() const;
+    const char *name() const;
+
+    bool hasAxis(const char *id) const;
+    bool hasButton(const char *id) const;
+
+    void axes(QList<const char *> &out);
+    void buttons(QList<const char *> &out);
+
+    XeAxisInput *axis(const char *id) const;
+    XeButtonInput *button(const char *id) const;
+
+    void update(float dt);
+
+private:
+    class Button;
+    class Axis;
+
+    // Kept here rather than in xe_strings, so a device can be a global
+    // constructed before the string table
+    QByteArray m_id;
+    QByteArray m_name;
+
+    // Inputs are allocated one by one so pointers to them stay valid as more
+    // are added
+    QVector<Button*> m_buttons;
+    QVector<Axis*> m_axes;
+    QHash<QByteArray, int> m_buttonIndex;
+    QHash<QByteArray, int> m_axisIndex;
+
+    Button *findButton(const char *id) const;
+    Button *findButton(XeButtonInput *) const;
+    Axis *findAxis(const char *id) const;
+    Axis *findAxis(XeAxisInput *) const;
+    void set(Axis *axis, float value);
+};
@@ -0,0 +1,145 @@
+
+#pragma once
+
+#include "xe/global.h"
+#include "xe/updatable.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+class XeMetrics;
+class XeProfiler;
+class XeProfilerSection;
+struct XeTelemetryBlock;
+
+/** One frame of telemetry, as read by XeTelemetryReader */
+class XE_EXPORT XeTelemetryFrame
+{
+public:
+    enum Type
+    {
+        /** A profiler section's time, in seconds */
+        SECTION,
+        /** A metric's value for the frame */
+        METRIC,
+    };
+
+    struct Entry
+    {
+        /** The section path (e.g. "Physics/Collision") or metric name */
+        QByteArray name;
+        Type type;
+        double value;
+    };
+
+    XeTelemetryFrame();
+
+    /** The publisher's sequence number for this frame, starting at zero */
+    quint64 index;
+    /** The profiler's frame number */
+    quint64 frame;
+    /** The duration of the frame, in seconds */
+    float dt;
+    /** The sections and metrics sampled in the frame */
+    QVector<Entry> entries;
+};
+
+/** Publishes an XeProfiler's sections, a metrics registry and frame times
+  * into a ring of frames in POSIX shared memory, so that a separate viewer
+  * process can watch a running instance live (see XeTelemetryReader).
+  *
+  * Publishing one frame is a copy into the shared mapping: no system calls,
+  * locks or allocations. Each frame slot is guarded by a sequence counter,
+  * so readers never block the publisher; they retry instead if a frame was
+  * overwritten while they were copying it.
+  *
+  * The shared memory object is named "xenon-<pid>" by default, so several
+  * instances on one host can be told apart, and is removed when the
+  * publisher is destroyed. Update the publisher once per tick, after the
+  * profiler and metrics have been updated.
+  *
+  * Supported on POSIX platforms only; elsewhere isOpen() is always false.
+  */
+class XE_EXPORT XeTelemetry : public XeUpdatable
+{
+public:
+    /** The maximum number of entries (sections and metrics) per frame.
+      * Any more are left out
+      */
+    enum { MAX_ENTRIES = 128 };
+    /** The maximum length of an entry name, including the terminator.
+      * Longer names are truncated
+      */
+    enum { MAX_NAME = 52 };
+
+    /** Creates the shared memory object and starts publishing
+      * @param profiler The profiler to publish
+      * @param metrics  A metrics registry to publish as well, or NULL
+      * @param name     The name of the shared memory object, or NULL for
+      *                 "xenon-<pid>"
+      * @param frames   The number of frames kept in the ring
+      */
+    XeTelemetry(XeProfiler *profiler, XeMetrics *metrics = 0, const char *name = 0, int frames = 256);
+    ~XeTelemetry();
+
+    /** Gets a value indicating whether the shared memory object was created */
+    bool isOpen() const;
+    /** Gets the name of the shared memory object */
+    const QByteArray &name() const;
+
+    /** Publishes the profiler's last frame */
+    void update(float dt);
+
+private:
+    XeProfiler *m_profiler;
+    XeMetrics *m_metrics;
+    QByteArray m_name;
+    XeTelemetryBlock *m_block;
+    size_t m_size;
+    QVector<XeProfilerSection*> m_sections;
+};
+
+/** Reads the frames published by an XeTelemetry, typically from another
+  * process. Reading has no effect on the publisher
+  */
+class XE_EXPORT XeTelemetryReader
+{
+public:
+    XeTelemetryReader();
+    ~XeTelemetryReader();
+
+    /** Gets the process IDs of the running instances publishing telemetry
+      * under the default name. Only implemented on Linux
+      */
+    static QList<qint64> instances();
+
+    /** Attaches to the default telemetry of the process with the given ID */
+    bool open(qint64 pid);
+    /** Attaches to a shared memory object by name */
+    bool open(const char *name);
+    /** Detaches from the shared memory object */
+    void close();
+    /** Gets a value indicating whether the reader is attached */
+    bool isOpen() const;
+
+    /** Gets the process ID of the publisher */
+    qint64 pid() const;
+    /** Gets the number of frames kept in the ring */
+    int capacity() const;
+    /** Gets the number of frames published so far. The last one has index
+      * published() - 1, and only the last capacity() frames can be read
+      */
+    quint64 published() const;
+
+    /** Reads the frame with the given index. Returns false if it hasn't been
+      * published yet or has already been overwritten
+      */
+    bool read(quint64 index, XeTelemetryFrame &out) const;
+    /** Reads the most recently published frame. Returns false if there is none */
+    bool latest(XeTelemetryFrame &out) const;
+
+private:
+    const XeTelemetryBlock *m_block;
+    size_t m_size;
+};
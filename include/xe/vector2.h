@@ -3,6 +3,8 @@
 
 #include "xe/matrix.h"
 
+#include <cmath>   // sqrt(), fabs()
+
 /**
  * A 2D vector
  * @author Dave Kilian
@@ -18,13 +20,13 @@ public:
     };
 
     /** Gets the vector (0, 0) */
-    static const XeVector2& Zero();
+    static constexpr XeVector2 Zero();
     /** Gets the vector (1, 1) */
-    static const XeVector2& One();
+    static constexpr XeVector2 One();
     /** Gets the vector (1, 0) */
-    static const XeVector2& UnitX();
+    static constexpr XeVector2 UnitX();
     /** Gets the vector (0, 1) */
-    static const XeVector2& UnitY();
+    static constexpr XeVector2 UnitY();
 
     /**
      * Computes the magnitude of a vector
@@ -185,13 +187,13 @@ public:
     /**
      * Creates a new vector with (x, y) = (0, 0)
      */
-    XeVector2();
+    constexpr XeVector2();
     /**
      * Creates a vector
      * @param x The X component to assign to the vector created
      * @param y The Y component to assign to the vector created
      */
-    XeVector2(float x, float y);
+    constexpr XeVector2(float x, float y);
 
     /** Computes the magnitude of this vector */
     float length() const;
@@ -250,4 +252,275 @@ public:
 /** Computes a scalar-vector multiplication */
 XeVector2 operator* (float lhs, const XeVector2& rhs);
 
+constexpr XeVector2::XeVector2() : xy{0, 0} { }
+
+constexpr XeVector2::XeVector2(float x, float y) : xy{x, y} { }
+
+constexpr XeVector2 XeVector2::Zero() { return XeVector2(0, 0); }
+constexpr XeVector2 XeVector2::One() { return XeVector2(1, 1); }
+constexpr XeVector2 XeVector2::UnitX() { return XeVector2(1, 0); }
+constexpr XeVector2 XeVector2::UnitY() { return XeVector2(0, 1); }
+
+inline float XeVector2::Length(const XeVector2 &v)
+{
+    return sqrt(v.x * v.x + v.y * v.y);
+}
+
+inline float XeVector2::LengthSquared(const XeVector2 &v)
+{
+    return v.x * v.x + v.y * v.y;
+}
+
+inline float XeVector2::Dot(const XeVector2 &v1, const XeVector2 &v2)
+{
+    return v1.x * v2.x + v1.y * v2.y;
+}
+
+inline float XeVector2::Distance(const XeVector2 &v1, const XeVector2 &v2)
+{
+    return sqrt((v1.x - v2.x) * (v1.x - v2.x) + (v1.y - v2.y) * (v1.y - v2.y));
+}
+
+inline float XeVector2::DistanceSquared(const XeVector2 &v1, const XeVector2 &v2)
+{
+    return (v1.x - v2.x) * (v1.x - v2.x) + (v1.y - v2.y) * (v1.y - v2.y);
+}
+
+inline float XeVector2::ManhattanDistance(const XeVector2 &v1, const XeVector2 &v2)
+{
+    return fabs(v1.x - v2.x) + fabs(v1.y - v2.y);
+}
+
+inline XeVector2 XeVector2::Normalize(const XeVector2 &v)
+{
+    return XeVector2::Multiply(v, 1.0f / v.length());
+}
+
+inline XeVector2 XeVector2::Reflect(const XeVector2 &v, const XeVector2 &n)
+{
+    float dot = XeVector2::Dot(v, n);
+
+    XeVector2 r;
+    r.x = v.x - (2.f * dot) * n.x;
+    r.y = v.y - (2.f * dot) * n.y;
+    return r;
+}
+
+inline bool XeVector2::Equal(const XeVector2 &v1, const XeVector2 &v2, float epsilon)
+{
+    return fabs(v1.x - v2.x) < epsilon && fabs(v1.y - v2.y) < epsilon;
+}
+
+inline bool XeVector2::NotEqual(const XeVector2 &v1, const XeVector2 &v2, float epsilon)
+{
+    return !XeVector2::Equal(v1, v2, epsilon);
+}
+
+inline XeVector2 XeVector2::Add(const XeVector2 &v1, const XeVector2 &v2)
+{
+    return XeVector2(v1.x + v2.x, v1.y + v2.y);
+}
+
+inline XeVector2 XeVector2::Subtract(const XeVector2 &v1, const XeVector2 &v2)
+{
+    return XeVector2(v1.x - v2.x, v1.y - v2.y);
+}
+
+inline XeVector2 XeVector2::Negate(const XeVector2 &v)
+{
+    return XeVector2(-v.x, -v.y);
+}
+
+inline XeVector2 XeVector2::Multiply(const XeVector2 &v, float amount)
+{
+    return XeVector2(amount * v.x, amount * v.y);
+}
+
+inline XeVector2 XeVector2::Divide(const XeVector2 &v, float amount)
+{
+    return XeVector2::Multiply(v, 1.0f / amount);
+}
+
+inline XeVector2 XeVector2::Lerp(const XeVector2 &v1, const XeVector2 &v2, float amount)
+{
+    return XeVector2((1.f - amount) * v1.x + amount * v2.x,
+                     (1.f - amount) * v1.y + amount * v2.y);
+}
+
+inline XeVector2 XeVector2::Clamp(const XeVector2 &v, const XeVector2 &min, const XeVector2 &max)
+{
+    XeVector2 c = v;
+    if (min.x > c.x) c.x = min.x;
+    if (min.y > c.y) c.y = min.y;
+    if (max.x < c.x) c.x = max.x;
+    if (max.y < c.y) c.y = max.y;
+    return c;
+}
+
+inline XeVector2 XeVector2::Min(const XeVector2 &v1, const XeVector2 &v2)
+{
+    XeVector2 c = v1;
+    if (c.x > v2.x) c.x = v2.x;
+    if (c.y > v2.y) c.y = v2.y;
+    return c;
+}
+
+inline XeVector2 XeVector2::Max(const XeVector2 &v1, const XeVector2 &v2)
+{
+    XeVector2 c = v1;
+    if (c.x < v2.x) c.x = v2.x;
+    if (c.y < v2.y) c.y = v2.y;
+    return c;
+}
+
+inline XeVector2 XeVector2::Transform(const XeMatrix &m, const XeVector2 &v)
+{
+    return XeVector2(v.x * m.m11 + v.y * m.m21 + m.m41,
+                   v.x * m.m12 + v.y * m.m22 + m.m42);
+}
+
+inline XeVector2 XeVector2::TransformNormal(const XeMatrix &m, const XeVector2 &v)
+{
+    return XeVector2(v.x * m.m11 + v.y * m.m21,
+                   v.x * m.m12 + v.y * m.m22);
+}
+
+inline float XeVector2::length() const
+{
+    return XeVector2::Length(*this);
+}
+
+inline float XeVector2::lengthSquared() const
+{
+    return XeVector2::LengthSquared(*this);
+}
+
+inline float XeVector2::dot(const XeVector2 &other) const
+{
+    return XeVector2::Dot(*this, other);
+}
+
+inline float XeVector2::distanceTo(const XeVector2 &other) const
+{
+    return XeVector2::Distance(*this, other);
+}
+
+inline float XeVector2::distanceSquaredTo(const XeVector2 &other) const
+{
+    return XeVector2::DistanceSquared(*this, other);
+}
+
+inline float XeVector2::manhattanDistanceTo(const XeVector2 &other) const
+{
+    return XeVector2::ManhattanDistance(*this, other);
+}
+
+inline XeVector2 XeVector2::normalize() const
+{
+    return XeVector2::Normalize(*this);
+}
+
+inline XeVector2 XeVector2::reflect(const XeVector2 &n) const
+{
+    return XeVector2::Reflect(*this, n);
+}
+
+inline XeVector2 XeVector2::operator+ (const XeVector2& rhs) const
+{
+    return XeVector2::Add(*this, rhs);
+}
+
+inline XeVector2 XeVector2::operator- (const XeVector2& rhs) const
+{
+    return XeVector2::Subtract(*this, rhs);
+}
+
+inline XeVector2 XeVector2::operator- () const
+{
+    return XeVector2::Negate(*this);
+}
+
+inline XeVector2 XeVector2::operator* (float rhs) const
+{
+    return XeVector2::Multiply(*this, rhs);
+}
+
+inline XeVector2 XeVector2::operator/ (float rhs) const
+{
+    return XeVector2::Divide(*this, rhs);
+}
+
+inline XeVector2& XeVector2::operator+= (const XeVector2& rhs)
+{
+    x += rhs.x;
+    y += rhs.y;
+
+    return *this;
+}
+
+inline XeVector2& XeVector2::operator-= (const XeVector2& rhs)
+{
+    x -= rhs.x;
+    y -= rhs.y;
+
+    return *this;
+}
+
+inline XeVector2& XeVector2::operator*= (float rhs)
+{
+    x *= rhs;
+    y *= rhs;
+
+    return *this;
+}
+
+inline XeVector2& XeVector2::operator/= (float rhs)
+{
+    *this *= 1.f / rhs;
+    return *this;
+}
+
+inline bool XeVector2::operator== (const XeVector2& rhs) const
+{
+    return XeVector2::Equal(*this, rhs);
+}
+
+inline bool XeVector2::operator!= (const XeVector2& rhs) const
+{
+    return XeVector2::NotEqual(*this, rhs);
+}
+
+inline XeVector2 XeVector2::clamp(const XeVector2 &min, const XeVector2 &max)
+{
+    return XeVector2::Clamp(*this, min, max);
+}
+
+inline XeVector2 XeVector2::transform(const XeMatrix &m)
+{
+    return XeVector2::Transform(m, *this);
+}
+
+inline XeVector2 XeVector2::transformNormal(const XeMatrix &m)
+{
+    return XeVector2::TransformNormal(m, *this);
+}
+
+inline XeVector2 operator* (float lhs, const XeVector2& rhs)
+{
+    return XeVector2::Multiply(rhs, lhs);
+}
+
+inline XeMatrix XeMatrix::Translate(const XeVector2 &a)
+{
+    return XeMatrix(  1,   0, 0, 0,
+                    0,   1, 0, 0,
+                    0,   0, 1, 0,
+                  a.x, a.y, 0, 1);
+}
+
+inline XeMatrix XeMatrix::translate(const XeVector2 &amount) const
+{
+    return translate(amount.x, amount.y, 0.f);
+}
+
 #endif // VECTOR2_H
@@ -3,6 +3,8 @@
 
 #include "xe/matrix.h"
 
+#include <cmath>   // sqrt(), fabs()
+
 /**
  * A 3D vector
  * @author Dave Kilian
@@ -18,15 +20,15 @@ public:
     };
 
     /** Gets the vector (0, 0, 0) */
-    static const XeVector3& Zero();
+    static constexpr XeVector3 Zero();
     /** Gets the vector (1, 1, 1) */
-    static const XeVector3& One();
+    static constexpr XeVector3 One();
     /** Gets the vector (1, 0, 0) */
-    static const XeVector3& UnitX();
+    static constexpr XeVector3 UnitX();
     /** Gets the vector (0, 1, 0) */
-    static const XeVector3& UnitY();
+    static constexpr XeVector3 UnitY();
     /** Gets the vector (0, 0, 1) */
-    static const XeVector3& UnitZ();
+    static constexpr XeVector3 UnitZ();
 
     /**
      * Computes the magnitude of a vector
@@ -190,17 +192,79 @@ public:
      */
     static XeVector3 TransformNormal(const XeMatrix& m, const XeVector3& v);
 
+    /**
+     * Transforms an array of points, with the same results as Transform()
+     * @param m The matrix to transform by
+     * @param in The points to transform
+     * @param out Receives the transformed points. May be the same array as in
+     * @param count The number of points
+     */
+    static void Transform(const XeMatrix& m, const XeVector3* in, XeVector3* out, int count);
+    /**
+     * Transforms an array of normals, with the same results as TransformNormal()
+     * @param m The matrix to transform by
+     * @param in The normals to transform
+     * @param out Receives the transformed normals. May be the same array as in
+     * @param count The number of normals
+     */
+    static void TransformNormal(const XeMatrix& m, const XeVector3* in, XeVector3* out, int count);
+    /**
+     * Transforms points stored with a stride, e.g. the positions in an array of vertices
+     * @param m The matrix to transform by
+     * @param in The X component of the first point; Y and Z follow it
+     * @param inStride The distance between two points in in, in bytes
+     * @param out Receives the X, Y and Z components of the first transformed point.
+     *            May overlap in if both have the same stride
+     * @param outStride The distance between two points in out, in bytes
+     * @param count The number of points
+     */
+    static void Transform(const XeMatrix& m, const float* in, int inStride, float* out, int outStride, int count);
+    /**
+     * Transforms normals stored with a stride, like the strided Transform()
+     */
+    static void TransformNormal(const XeMatrix& m, const float* in, int inStride, float* out, int outStride, int count);
+    /**
+     * Transforms points stored as separate arrays of X, Y and Z components. Four points are
+     * transformed at a time, so this is the fastest way to transform many points
+     * @param m The matrix to transform by
+     * @param x, y, z The components of the points to transform
+     * @param outX, outY, outZ Receive the components of the transformed points. May be the
+     *                         same arrays as x, y and z
+     * @param count The number of points
+     */
+    static void TransformSoA(const XeMatrix& m, const float* x, const float* y, const float* z,
+                             float* outX, float* outY, float* outZ, int count);
+    /**
+     * Transforms normals stored as separate arrays of components, like TransformSoA()
+     */
+    static void TransformNormalSoA(const XeMatrix& m, const float* x, const float* y, const float* z,
+                                   float* outX, float* outY, float* outZ, int count);
+    /**
+     * Projects an array of points to screen coordinates
+     * @param m The combined world, view and projection matrix
+     * @param x The left edge of the viewport
+     * @param y The top edge of the viewport
+     * @param width The width of the viewport
+     * @param height The height of the viewport
+     * @param in The points to project
+     * @param out Receives the screen positions of the points, with Y pointing down, and their
+     *            depth after the projection in Z. May be the same array as in
+     * @param count The number of points
+     */
+    static void Project(const XeMatrix& m, float x, float y, float width, float height,
+                        const XeVector3* in, XeVector3* out, int count);
+
     /**
      * Creates a new vector with (x, y) = (0, 0)
      */
-    XeVector3();
+    constexpr XeVector3();
     /**
      * Creates a vector
      * @param x The X component to assign to the vector created
      * @param y The Y component to assign to the vector created
      * @param z The Z component to assign to the vector created
      */
-    XeVector3(float x, float y, float z);
+    constexpr XeVector3(float x, float y, float z);
 
     /** Computes the magnitude of this vector */
     float length() const;
@@ -261,4 +325,409 @@ public:
 /** Computes a scalar-vector multiplication */
 XeVector3 operator* (float lhs, const XeVector3& rhs);
 
+constexpr XeVector3::XeVector3() : xyz{0, 0, 0} { }
+
+constexpr XeVector3::XeVector3(float x, float y, float z) : xyz{x, y, z} { }
+
+constexpr XeVector3 XeVector3::Zero() { return XeVector3(0, 0, 0); }
+constexpr XeVector3 XeVector3::One() { return XeVector3(1, 1, 1); }
+constexpr XeVector3 XeVector3::UnitX() { return XeVector3(1, 0, 0); }
+constexpr XeVector3 XeVector3::UnitY() { return XeVector3(0, 1, 0); }
+constexpr XeVector3 XeVector3::UnitZ() { return XeVector3(0, 0, 1); }
+
+inline float XeVector3::Length(const XeVector3 &v)
+{
+    return sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+}
+
+inline float XeVector3::LengthSquared(const XeVector3 &v)
+{
+    return v.x * v.x + v.y * v.y + v.z * v.z;
+}
+
+inline float XeVector3::Dot(const XeVector3 &v1, const XeVector3 &v2)
+{
+    return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+}
+
+inline XeVector3 XeVector3::Cross(const XeVector3 &v1, const XeVector3 &v2)
+{
+    XeVector3 v;
+    v.x = (v1.y * v2.z) - (v1.z * v2.y);
+    v.y = (v1.z * v2.x) - (v1.x * v2.z);
+    v.z = (v1.x * v2.y) - (v1.y * v2.x);
+    return v;
+}
+
+inline float XeVector3::Distance(const XeVector3 &v1, const XeVector3 &v2)
+{
+    return sqrt((v1.x - v2.x) * (v1.x - v2.x) + (v1.y - v2.y) * (v1.y - v2.y) + (v1.z - v2.z) * (v1.z - v2.z));
+}
+
+inline float XeVector3::DistanceSquared(const XeVector3 &v1, const XeVector3 &v2)
+{
+    return (v1.x - v2.x) * (v1.x - v2.x) + (v1.y - v2.y) * (v1.y - v2.y) + (v1.z - v2.z) * (v1.z - v2.z);
+}
+
+inline float XeVector3::ManhattanDistance(const XeVector3 &v1, const XeVector3 &v2)
+{
+    return fabs(v1.x - v2.x) + fabs(v1.y - v2.y) + fabs(v1.z - v2.z);
+}
+
+inline XeVector3 XeVector3::Normalize(const XeVector3 &v)
+{
+    return XeVector3::Multiply(v, 1.0f / v.length());
+}
+
+inline XeVector3 XeVector3::Reflect(const XeVector3 &v, const XeVector3 &n)
+{
+    float dot = XeVector3::Dot(v, n);
+
+    XeVector3 r;
+    r.x = v.x - (2.f * dot) * n.x;
+    r.y = v.y - (2.f * dot) * n.y;
+    r.z = v.z - (2.f * dot) * n.z;
+
+    return r;
+}
+
+inline bool XeVector3::Equal(const XeVector3 &v1, const XeVector3 &v2, float epsilon)
+{
+    return fabs(v1.x - v2.x) < epsilon && fabs(v1.y - v2.y) < epsilon && fabs(v1.z - v2.z) < epsilon;
+}
+
+inline bool XeVector3::NotEqual(const XeVector3 &v1, const XeVector3 &v2, float epsilon)
+{
+    return !XeVector3::Equal(v1, v2, epsilon);
+}
+
+inline XeVector3 XeVector3::Add(const XeVector3 &v1, const XeVector3 &v2)
+{
+    return XeVector3(v1.x + v2.x, v1.y + v2.y, v1.z + v2.z);
+}
+
+inline XeVector3 XeVector3::Subtract(const XeVector3 &v1, const XeVector3 &v2)
+{
+    return XeVector3(v1.x - v2.x, v1.y - v2.y, v1.z - v2.z);
+}
+
+inline XeVector3 XeVector3::Negate(const XeVector3 &v)
+{
+    return XeVector3(-v.x, -v.y, -v.z);
+}
+
+inline XeVector3 XeVector3::Multiply(const XeVector3 &v, float amount)
+{
+    return XeVector3(amount * v.x, amount * v.y, amount * v.z);
+}
+
+inline XeVector3 XeVector3::Divide(const XeVector3 &v, float amount)
+{
+    return XeVector3::Multiply(v, 1.0f / amount);
+}
+
+inline XeVector3 XeVector3::Lerp(const XeVector3 &v1, const XeVector3 &v2, float amount)
+{
+    XeVector3 v;
+    v.x = (1.f - amount) * v1.x + amount * v2.x;
+    v.y = (1.f - amount) * v1.y + amount * v2.y;
+    v.z = (1.f - amount) * v1.z + amount * v2.z;
+
+    return v;
+}
+
+inline XeVector3 XeVector3::Clamp(const XeVector3 &v, const XeVector3 &min, const XeVector3 &max)
+{
+    XeVector3 c = v;
+    if (min.x > c.x) c.x = min.x;
+    if (min.y > c.y) c.y = min.y;
+    if (min.z > c.z) c.z = min.z;
+    if (max.x < c.x) c.x = max.x;
+    if (max.y < c.y) c.y = max.y;
+    if (max.z < c.z) c.z = max.z;
+    return c;
+}
+
+inline XeVector3 XeVector3::Min(const XeVector3 &v1, const XeVector3 &v2)
+{
+    XeVector3 c = v1;
+    if (c.x > v2.x) c.x = v2.x;
+    if (c.y > v2.y) c.y = v2.y;
+    if (c.z > v2.z) c.z = v2.z;
+    return c;
+}
+
+inline XeVector3 XeVector3::Max(const XeVector3 &v1, const XeVector3 &v2)
+{
+    XeVector3 c = v1;
+    if (c.x < v2.x) c.x = v2.x;
+    if (c.y < v2.y) c.y = v2.y;
+    if (c.z < v2.z) c.z = v2.z;
+    return c;
+}
+
+inline XeVector3 XeVector3::Transform(const XeMatrix &m, const XeVector3 &v)
+{
+    return XeVector3(v.x * m.m11 + v.y * m.m21 + v.z * m.m31 + m.m41,
+                   v.x * m.m12 + v.y * m.m22 + v.z * m.m32 + m.m42,
+                   v.x * m.m13 + v.y * m.m23 + v.z * m.m33 + m.m43);
+}
+
+inline XeVector3 XeVector3::TransformNormal(const XeMatrix &m, const XeVector3 &v)
+{
+    return XeVector3(v.x * m.m11 + v.y * m.m21 + v.z * m.m31,
+                   v.x * m.m12 + v.y * m.m22 + v.z * m.m32,
+                   v.x * m.m13 + v.y * m.m23 + v.z * m.m33);
+}
+
+inline float XeVector3::length() const
+{
+    return XeVector3::Length(*this);
+}
+
+inline float XeVector3::lengthSquared() const
+{
+    return XeVector3::LengthSquared(*this);
+}
+
+inline float XeVector3::dot(const XeVector3 &other) const
+{
+    return XeVector3::Dot(*this, other);
+}
+
+inline XeVector3 XeVector3::cross(const XeVector3 &other) const
+{
+    return XeVector3::Cross(*this, other);
+}
+
+inline float XeVector3::distanceTo(const XeVector3 &other) const
+{
+    return XeVector3::Distance(*this, other);
+}
+
+inline float XeVector3::distanceSquaredTo(const XeVector3 &other) const
+{
+    return XeVector3::DistanceSquared(*this, other);
+}
+
+inline float XeVector3::manhattanDistanceTo(const XeVector3 &other) const
+{
+    return XeVector3::ManhattanDistance(*this, other);
+}
+
+inline XeVector3 XeVector3::normalize() const
+{
+    return XeVector3::Normalize(*this);
+}
+
+inline XeVector3 XeVector3::reflect(const XeVector3 &n) const
+{
+    return XeVector3::Reflect(*this, n);
+}
+
+inline XeVector3 XeVector3::operator+ (const XeVector3& rhs) const
+{
+    return XeVector3::Add(*this, rhs);
+}
+
+inline XeVector3 XeVector3::operator- (const XeVector3& rhs) const
+{
+    return XeVector3::Subtract(*this, rhs);
+}
+
+inline XeVector3 XeVector3::operator- () const
+{
+    return XeVector3::Negate(*this);
+}
+
+inline XeVector3 XeVector3::operator* (float rhs) const
+{
+    return XeVector3::Multiply(*this, rhs);
+}
+
+inline XeVector3 XeVector3::operator/ (float rhs) const
+{
+    return XeVector3::Divide(*this, rhs);
+}
+
+inline XeVector3& XeVector3::operator+= (const XeVector3& rhs)
+{
+    x += rhs.x;
+    y += rhs.y;
+    z += rhs.z;
+
+    return *this;
+}
+
+inline XeVector3& XeVector3::operator-= (const XeVector3& rhs)
+{
+    x -= rhs.x;
+    y -= rhs.y;
+    z -= rhs.z;
+
+    return *this;
+}
+
+inline XeVector3& XeVector3::operator*= (float rhs)
+{
+    x *= rhs;
+    y *= rhs;
+    z *= rhs;
+
+    return *this;
+}
+
+inline XeVector3& XeVector3::operator/= (float rhs)
+{
+    *this *= 1.f / rhs;
+    return *this;
+}
+
+inline bool XeVector3::operator== (const XeVector3& rhs) const
+{
+    return XeVector3::Equal(*this, rhs);
+}
+
+inline bool XeVector3::operator!= (const XeVector3& rhs) const
+{
+    return XeVector3::NotEqual(*this, rhs);
+}
+
+inline XeVector3 XeVector3::clamp(const XeVector3 &min, const XeVector3 &max)
+{
+    return XeVector3::Clamp(*this, min, max);
+}
+
+inline XeVector3 XeVector3::transform(const XeMatrix &m)
+{
+    return XeVector3::Transform(m, *this);
+}
+
+inline XeVector3 XeVector3::transformNormal(const XeMatrix &m)
+{
+    return XeVector3::TransformNormal(m, *this);
+}
+
+inline XeVector3 operator* (float lhs, const XeVector3& rhs)
+{
+    return XeVector3::Multiply(rhs, lhs);
+}
+
+inline XeVector3 XeMatrix::Up(const XeMatrix &m)
+{
+    return XeVector3(m.m21, m.m22, m.m23);
+}
+
+inline XeVector3 XeMatrix::Down(const XeMatrix &m)
+{
+    return XeVector3(-m.m21, -m.m22, -m.m23);
+}
+
+inline XeVector3 XeMatrix::Left(const XeMatrix &m)
+{
+    return XeVector3(-m.m11, -m.m12, -m.m13);
+}
+
+inline XeVector3 XeMatrix::Right(const XeMatrix &m)
+{
+    return XeVector3(m.m11, m.m12, m.m13);
+}
+
+inline XeVector3 XeMatrix::Forward(const XeMatrix &m)
+{
+    return XeVector3(-m.m31, -m.m32, -m.m33);
+}
+
+inline XeVector3 XeMatrix::Backward(const XeMatrix &m)
+{
+    return XeVector3(m.m31, m.m32, m.m33);
+}
+
+inline XeVector3 XeMatrix::Translation(const XeMatrix &m)
+{
+    return XeVector3(m.m41, m.m42, m.m43);
+}
+
+inline XeMatrix XeMatrix::Scale(const XeVector3 &a)
+{
+    return XeMatrix(a.x, 0,   0,   0,
+                  0,   a.y, 0,   0,
+                  0,   0,   a.z, 0,
+                  0,   0,   0,   1);
+}
+
+inline XeMatrix XeMatrix::Translate(const XeVector3 &a)
+{
+    return XeMatrix(  1,   0,   0, 0,
+                    0,   1,   0, 0,
+                    0,   0,   1, 0,
+                  a.x, a.y, a.z, 1);
+}
+
+inline XeVector3 XeMatrix::up() const
+{
+    return XeMatrix::Up(*this);
+}
+
+inline XeVector3 XeMatrix::down() const
+{
+    return XeMatrix::Down(*this);
+}
+
+inline XeVector3 XeMatrix::left() const
+{
+    return XeMatrix::Left(*this);
+}
+
+inline XeVector3 XeMatrix::right() const
+{
+    return XeMatrix::Right(*this);
+}
+
+inline XeVector3 XeMatrix::forward() const
+{
+    return XeMatrix::Forward(*this);
+}
+
+inline XeVector3 XeMatrix::backward() const
+{
+    return XeMatrix::Backward(*this);
+}
+
+inline XeVector3 XeMatrix::translation() const
+{
+    return XeMatrix::Translation(*this);
+}
+
+inline XeMatrix XeMatrix::scale(const XeVector3 &amounts) const
+{
+    return scale(amounts.x, amounts.y, amounts.z);
+}
+
+inline XeMatrix XeMatrix::rotate(const XeVector3 &axis, float angle) const
+{
+    // The rotation only mixes the first three columns
+    XeMatrix t = XeMatrix::FromAxisAngle(axis, angle);
+
+    XeMatrix r = *this;
+    for (int i = 0; i < 16; i += 4)
+    {
+        r.m[i] = ((m[i] * t.m11) + (m[i + 1] * t.m21)) + (m[i + 2] * t.m31);
+        r.m[i + 1] = ((m[i] * t.m12) + (m[i + 1] * t.m22)) + (m[i + 2] * t.m32);
+        r.m[i + 2] = ((m[i] * t.m13) + (m[i + 1] * t.m23)) + (m[i + 2] * t.m33);
+    }
+
+    return r;
+}
+
+inline XeMatrix XeMatrix::translate(const XeVector3 &amount) const
+{
+    return translate(amount.x, amount.y, amount.z);
+}
+
+inline XeVector3 XeMatrix::operator* (const XeVector3& rhs) const
+{
+    return XeVector3::Transform(*this, rhs);
+}
+
 #endif // XeVector3_H
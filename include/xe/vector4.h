@@ -4,6 +4,8 @@
 #include "xe/matrix.h"
 #include "xe/vector3.h"
 
+#include <cmath>   // sqrt(), fabs()
+
 /**
  * A 4D vector
  * @author Dave Kilian
@@ -19,17 +21,17 @@ public:
     };
 
     /** Gets the vector (0, 0, 0, 0) */
-    static const XeVector4& Zero();
+    static constexpr XeVector4 Zero();
     /** Gets the vector (1, 1, 1, 0) */
-    static const XeVector4& One();
+    static constexpr XeVector4 One();
     /** Gets the vector (1, 0, 0, 0) */
-    static const XeVector4& UnitX();
+    static constexpr XeVector4 UnitX();
     /** Gets the vector (0, 1, 0, 0) */
-    static const XeVector4& UnitY();
+    static constexpr XeVector4 UnitY();
     /** Gets the vector (0, 0, 1, 0) */
-    static const XeVector4& UnitZ();
+    static constexpr XeVector4 UnitZ();
     /** Gets the vector (0, 0, 0, 1) */
-    static const XeVector4& UnitW();
+    static constexpr XeVector4 UnitW();
 
     /**
      * Computes the magnitude of a vector
@@ -185,11 +187,30 @@ public:
      * @return The matrix-vector product
      */
     static XeVector4 Transform(const XeMatrix& m, const XeVector4& v);
+    /**
+     * Transforms an array of vectors, with the same results as Transform()
+     * @param m The matrix to transform by
+     * @param in The vectors to transform
+     * @param out Receives the transformed vectors. May be the same array as in
+     * @param count The number of vectors
+     */
+    static void Transform(const XeMatrix& m, const XeVector4* in, XeVector4* out, int count);
+    /**
+     * Transforms vectors stored with a stride, e.g. in an array of vertices
+     * @param m The matrix to transform by
+     * @param in The X component of the first vector; Y, Z and W follow it
+     * @param inStride The distance between two vectors in in, in bytes
+     * @param out Receives the components of the first transformed vector.
+     *            May overlap in if both have the same stride
+     * @param outStride The distance between two vectors in out, in bytes
+     * @param count The number of vectors
+     */
+    static void Transform(const XeMatrix& m, const float* in, int inStride, float* out, int outStride, int count);
 
     /**
      * Creates a new vector with (x, y) = (0, 0)
      */
-    XeVector4();
+    constexpr XeVector4();
     /**
      * Creates a vector
      * @param x The X component to assign to the vector created
@@ -197,7 +218,7 @@ public:
      * @param z The Z component to assign to the vector created
      * @param w The W component to assign to the vector created
      */
-    XeVector4(float x, float y, float z, float w);
+    constexpr XeVector4(float x, float y, float z, float w);
     /**
      * Creates a 4D vector representing the given 3D vector in hyperspace
      */
@@ -260,4 +281,309 @@ public:
 /** Computes a scalar-vector multiplication */
 XeVector4 operator* (float lhs, const XeVector4& rhs);
 
+constexpr XeVector4::XeVector4() : xywz{0, 0, 0, 0} { }
+
+constexpr XeVector4::XeVector4(float x, float y, float z, float w) : xywz{x, y, z, w} { }
+
+constexpr XeVector4 XeVector4::Zero() { return XeVector4(0, 0, 0, 0); }
+constexpr XeVector4 XeVector4::One() { return XeVector4(1, 1, 1, 1); }
+constexpr XeVector4 XeVector4::UnitX() { return XeVector4(1, 0, 0, 0); }
+constexpr XeVector4 XeVector4::UnitY() { return XeVector4(0, 1, 0, 0); }
+constexpr XeVector4 XeVector4::UnitZ() { return XeVector4(0, 0, 1, 0); }
+constexpr XeVector4 XeVector4::UnitW() { return XeVector4(0, 0, 0, 1); }
+
+inline float XeVector4::Length(const XeVector4 &v)
+{
+    return sqrt(v.x * v.x + v.y * v.y + v.z * v.z + v.w * v.w);
+}
+
+inline float XeVector4::LengthSquared(const XeVector4 &v)
+{
+    return v.x * v.x + v.y * v.y + v.z * v.z + v.w * v.w;
+}
+
+inline float XeVector4::Dot(const XeVector4 &v1, const XeVector4 &v2)
+{
+    return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w;
+}
+
+inline XeVector4 XeVector4::Cross(const XeVector4 &v1, const XeVector4 &v2)
+{
+    XeVector4 v;
+    v.x = (v1.y * v2.z) - (v1.z * v2.y);
+    v.y = (v1.z * v2.x) - (v1.x * v2.z);
+    v.z = (v1.x * v2.y) - (v1.y * v2.x);
+    return v;
+}
+
+inline float XeVector4::Distance(const XeVector4 &v1, const XeVector4 &v2)
+{
+    return sqrt((v1.x - v2.x) * (v1.x - v2.x) + (v1.y - v2.y) * (v1.y - v2.y) + (v1.z - v2.z) * (v1.z - v2.z) + (v1.w - v2.w) * (v1.w - v2.w));
+}
+
+inline float XeVector4::DistanceSquared(const XeVector4 &v1, const XeVector4 &v2)
+{
+    return (v1.x - v2.x) * (v1.x - v2.x) + (v1.y - v2.y) * (v1.y - v2.y) + (v1.z - v2.z) * (v1.z - v2.z) + (v1.w - v2.w) * (v1.w - v2.w);
+}
+
+inline float XeVector4::ManhattanDistance(const XeVector4 &v1, const XeVector4 &v2)
+{
+    return fabs(v1.x - v2.x) + fabs(v1.y - v2.y) + fabs(v1.z - v2.z) + fabs(v1.w - v2.w);
+}
+
+inline XeVector4 XeVector4::Normalize(const XeVector4 &v)
+{
+    return XeVector4::Multiply(v, 1.0f / v.length());
+}
+
+inline XeVector4 XeVector4::Reflect(const XeVector4 &v, const XeVector4 &n)
+{
+    float dot = XeVector4::Dot(v, n);
+
+    XeVector4 r;
+    r.x = v.x - 2.f * dot * n.x;
+    r.y = v.y - 2.f * dot * n.y;
+    r.z = v.z - 2.f * dot * n.z;
+    r.w = v.w - 2.f * dot * n.w;
+
+    return r;
+}
+
+inline bool XeVector4::Equal(const XeVector4 &v1, const XeVector4 &v2, float epsilon)
+{
+    return fabs(v1.x - v2.x) < epsilon && fabs(v1.y - v2.y) < epsilon && fabs(v1.z - v2.z) < epsilon;
+}
+
+inline bool XeVector4::NotEqual(const XeVector4 &v1, const XeVector4 &v2, float epsilon)
+{
+    return !XeVector4::Equal(v1, v2, epsilon);
+}
+
+inline XeVector4 XeVector4::Add(const XeVector4 &v1, const XeVector4 &v2)
+{
+    return XeVector4(v1.x + v2.x, v1.y + v2.y, v1.z + v2.z, v1.w + v2.w);
+}
+
+inline XeVector4 XeVector4::Subtract(const XeVector4 &v1, const XeVector4 &v2)
+{
+    return XeVector4(v1.x - v2.x, v1.y - v2.y, v1.z - v2.z, v1.w - v2.w);
+}
+
+inline XeVector4 XeVector4::Negate(const XeVector4 &v)
+{
+    return XeVector4(-v.x, -v.y, -v.z, -v.w);
+}
+
+inline XeVector4 XeVector4::Multiply(const XeVector4 &v, float amount)
+{
+    return XeVector4(amount * v.x, amount * v.y, amount * v.z, amount * v.w);
+}
+
+inline XeVector4 XeVector4::Divide(const XeVector4 &v, float amount)
+{
+    return XeVector4::Multiply(v, 1.0f / amount);
+}
+
+inline XeVector4 XeVector4::Lerp(const XeVector4 &v1, const XeVector4 &v2, float amount)
+{
+    XeVector4 v;
+    v.x = (1.f - amount) * v1.x + amount * v2.x;
+    v.y = (1.f - amount) * v1.y + amount * v2.y;
+    v.z = (1.f - amount) * v1.z + amount * v2.z;
+    v.w = (1.f - amount) * v1.w + amount * v2.w;
+
+    return v;
+}
+
+inline XeVector4 XeVector4::Clamp(const XeVector4 &v, const XeVector4 &min, const XeVector4 &max)
+{
+    XeVector4 c = v;
+    if (min.x > c.x) c.x = min.x;
+    if (min.y > c.y) c.y = min.y;
+    if (min.z > c.z) c.z = min.z;
+    if (min.w > c.w) c.w = min.w;
+    if (max.x < c.x) c.x = max.x;
+    if (max.y < c.y) c.y = max.y;
+    if (max.z < c.z) c.z = max.z;
+    if (max.w < c.w) c.w = max.w;
+    return c;
+}
+
+inline XeVector4 XeVector4::Min(const XeVector4 &v1, const XeVector4 &v2)
+{
+    XeVector4 c = v1;
+    if (c.x > v2.x) c.x = v2.x;
+    if (c.y > v2.y) c.y = v2.y;
+    if (c.z > v2.z) c.z = v2.z;
+    if (c.w > v2.w) c.w = v2.w;
+    return c;
+}
+
+inline XeVector4 XeVector4::Max(const XeVector4 &v1, const XeVector4 &v2)
+{
+    XeVector4 c = v1;
+    if (c.x < v2.x) c.x = v2.x;
+    if (c.y < v2.y) c.y = v2.y;
+    if (c.z < v2.z) c.z = v2.z;
+    if (c.w < v2.w) c.w = v2.w;
+    return c;
+}
+
+inline XeVector4 XeVector4::Transform(const XeMatrix &m, const XeVector4 &v)
+{
+    return XeVector4(v.x * m.m11 + v.y * m.m21 + v.z * m.m31 + v.w * m.m41,
+                   v.x * m.m12 + v.y * m.m22 + v.z * m.m32 + v.w * m.m42,
+                   v.x * m.m13 + v.y * m.m23 + v.z * m.m33 + v.w * m.m43,
+                   v.x * m.m14 + v.y * m.m24 + v.z * m.m34 + v.w * m.m44);
+}
+
+inline float XeVector4::length() const
+{
+    return XeVector4::Length(*this);
+}
+
+inline float XeVector4::lengthSquared() const
+{
+    return XeVector4::LengthSquared(*this);
+}
+
+inline float XeVector4::dot(const XeVector4 &other) const
+{
+    return XeVector4::Dot(*this, other);
+}
+
+inline XeVector4 XeVector4::cross(const XeVector4 &other) const
+{
+    return XeVector4::Cross(*this, other);
+}
+
+inline float XeVector4::distanceTo(const XeVector4 &other) const
+{
+    return XeVector4::Distance(*this, other);
+}
+
+inline float XeVector4::distanceSquaredTo(const XeVector4 &other) const
+{
+    return XeVector4::DistanceSquared(*this, other);
+}
+
+inline float XeVector4::manhattanDistanceTo(const XeVector4 &other) const
+{
+    return XeVector4::ManhattanDistance(*this, other);
+}
+
+inline XeVector4 XeVector4::normalize() const
+{
+    return XeVector4::Normalize(*this);
+}
+
+inline XeVector4 XeVector4::reflect(const XeVector4 &n) const
+{
+    return XeVector4::Reflect(*this, n);
+}
+
+inline XeVector4 XeVector4::operator+ (const XeVector4& rhs) const
+{
+    return XeVector4::Add(*this, rhs);
+}
+
+inline XeVector4 XeVector4::operator- (const XeVector4& rhs) const
+{
+    return XeVector4::Subtract(*this, rhs);
+}
+
+inline XeVector4 XeVector4::operator- () const
+{
+    return XeVector4::Negate(*this);
+}
+
+inline XeVector4 XeVector4::operator* (float rhs) const
+{
+    return XeVector4::Multiply(*this, rhs);
+}
+
+inline XeVector4 XeVector4::operator/ (float rhs) const
+{
+    return XeVector4::Divide(*this, rhs);
+}
+
+inline XeVector4& XeVector4::operator+= (const XeVector4& rhs)
+{
+    x += rhs.x;
+    y += rhs.y;
+    z += rhs.z;
+    w += rhs.w;
+
+    return *this;
+}
+
+inline XeVector4& XeVector4::operator-= (const XeVector4& rhs)
+{
+    x -= rhs.x;
+    y -= rhs.y;
+    z -= rhs.z;
+    w -= rhs.w;
+
+    return *this;
+}
+
+inline XeVector4& XeVector4::operator*= (float rhs)
+{
+    x *= rhs;
+    y *= rhs;
+    z *= rhs;
+    w *= rhs;
+
+    return *this;
+}
+
+inline XeVector4& XeVector4::operator/= (float rhs)
+{
+    *this *= 1.f / rhs;
+    return *this;
+}
+
+inline bool XeVector4::operator== (const XeVector4& rhs) const
+{
+    return XeVector4::Equal(*this, rhs);
+}
+
+inline bool XeVector4::operator!= (const XeVector4& rhs) const
+{
+    return XeVector4::NotEqual(*this, rhs);
+}
+
+inline XeVector4 XeVector4::clamp(const XeVector4 &min, const XeVector4 &max)
+{
+    return XeVector4::Clamp(*this, min, max);
+}
+
+inline XeVector4 XeVector4::transform(const XeMatrix &m)
+{
+    return XeVector4::Transform(m, *this);
+}
+
+inline XeVector4 operator* (float lhs, const XeVector4& rhs)
+{
+    return XeVector4::Multiply(rhs, lhs);
+}
+
+inline XeMatrix XeMatrix::Translate(const XeVector4 &a)
+{
+    return XeMatrix(  1,   0,   0, 0,
+                    0,   1,   0, 0,
+                    0,   0,   1, 0,
+                  a.x, a.y, a.z, 1);
+}
+
+inline XeMatrix XeMatrix::translate(const XeVector4 &amount) const
+{
+    return translate(amount.x, amount.y, amount.z);
+}
+
+inline XeVector4 XeMatrix::operator* (const XeVector4& rhs) const
+{
+    return XeVector4::Transform(*this, rhs);
+}
+
 #endif // XeVector4_H
@@ -0,0 +1,243 @@
+#ifndef VECTOR4A_H
+#define VECTOR4A_H
+
+#include "xe/matrixa.h"
+#include "xe/vector3.h"
+#include "xe/vector4.h"
+
+#include <cmath>   // sqrt()
+
+/**
+ * A 4D vector kept in a SIMD register and aligned to 16 bytes. Compute
+ * with it, and store vectors as XeVector4 or XeVector3. Results are
+ * bit-identical to the same operations on XeVector4
+ */
+class XeVector4A
+{
+public:
+    XeFloat4 v;
+
+    /** Gets the vector (0, 0, 0, 0) */
+    static XeVector4A Zero();
+
+    /** Computes the magnitude of a vector */
+    static float Length(const XeVector4A& v);
+    /** Computes the square of the magnitude of a vector */
+    static float LengthSquared(const XeVector4A& v);
+    /** Computes the dot product between two vectors */
+    static float Dot(const XeVector4A& v1, const XeVector4A& v2);
+    /** Scales a vector to unit length */
+    static XeVector4A Normalize(const XeVector4A& v);
+    /**
+     * Computes the linear interpolation between two vectors
+     * @param v1 The vector at amount 0
+     * @param v2 The vector at amount 1
+     * @param amount The position between the vectors
+     */
+    static XeVector4A Lerp(const XeVector4A& v1, const XeVector4A& v2, float amount);
+    /** Transforms a vector by a matrix */
+    static XeVector4A Transform(const XeMatrixA& m, const XeVector4A& v);
+
+    /** Creates the vector (0, 0, 0, 0) */
+    XeVector4A();
+    /** Creates a vector with the specified components */
+    XeVector4A(float x, float y, float z, float w);
+    /** Loads a packed vector */
+    XeVector4A(const XeVector4& v);
+    /** Loads a packed 3D vector, e.g. with w = 1 for a point or 0 for a direction */
+    XeVector4A(const XeVector3& v, float w);
+    /** Wraps a SIMD register */
+    explicit XeVector4A(XeFloat4 v);
+
+    /** Stores this vector into a packed vector */
+    XeVector4 packed() const;
+    /** Stores the x, y and z components of this vector into a packed vector */
+    XeVector3 packed3() const;
+
+    float x() const;
+    float y() const;
+    float z() const;
+    float w() const;
+
+    /** Computes the magnitude of this vector */
+    float length() const;
+    /** Computes the square of the magnitude of this vector */
+    float lengthSquared() const;
+    /** Computes the dot product of this vector with another */
+    float dot(const XeVector4A& other) const;
+    /** Scales this vector to unit length */
+    XeVector4A normalize() const;
+
+    /** Computes the sum of two vectors */
+    XeVector4A operator+ (const XeVector4A& rhs) const;
+    /** Computes the difference between two vectors */
+    XeVector4A operator- (const XeVector4A& rhs) const;
+    /** Computes the negation of a vector */
+    XeVector4A operator- () const;
+    /** Computes a vector-scalar product */
+    XeVector4A operator* (float rhs) const;
+    /** Computes a vector-scalar quotient */
+    XeVector4A operator/ (float rhs) const;
+
+    /** Adds another vector to this vector */
+    XeVector4A& operator+= (const XeVector4A& rhs);
+    /** Subtracts another vector from this vector */
+    XeVector4A& operator-= (const XeVector4A& rhs);
+    /** Multiplies this vector by a scalar */
+    XeVector4A& operator*= (float rhs);
+    /** Divides this vector by a scalar */
+    XeVector4A& operator/= (float rhs);
+};
+
+/** Computes a scalar-vector product */
+XeVector4A operator* (float lhs, const XeVector4A& rhs);
+
+inline XeVector4A::XeVector4A() : v(XeSimd::splat(0.f)) { }
+
+inline XeVector4A::XeVector4A(float x, float y, float z, float w) : v(XeSimd::set(x, y, z, w)) { }
+
+inline XeVector4A::XeVector4A(const XeVector4 &v) : v(XeSimd::load(v.xywz)) { }
+
+inline XeVector4A::XeVector4A(const XeVector3 &v, float w) : v(XeSimd::set(v.x, v.y, v.z, w)) { }
+
+inline XeVector4A::XeVector4A(XeFloat4 v) : v(v) { }
+
+inline XeVector4A XeVector4A::Zero()
+{
+    return XeVector4A();
+}
+
+inline float XeVector4A::Length(const XeVector4A &v)
+{
+    return sqrt(XeVector4A::Dot(v, v));
+}
+
+inline float XeVector4A::LengthSquared(const XeVector4A &v)
+{
+    return XeVector4A::Dot(v, v);
+}
+
+inline float XeVector4A::Dot(const XeVector4A &v1, const XeVector4A &v2)
+{
+    return XeSimd::sum(XeSimd::mul(v1.v, v2.v));
+}
+
+inline XeVector4A XeVector4A::Normalize(const XeVector4A &v)
+{
+    return v * (1.f / v.length());
+}
+
+inline XeVector4A XeVector4A::Lerp(const XeVector4A &v1, const XeVector4A &v2, float amount)
+{
+    return XeVector4A(XeSimd::add(XeSimd::mul(XeSimd::splat(1.f - amount), v1.v),
+                                  XeSimd::mul(XeSimd::splat(amount), v2.v)));
+}
+
+inline XeVector4A XeVector4A::Transform(const XeMatrixA &m, const XeVector4A &v)
+{
+    // Sums in the same order as XeVector4::Transform()
+    XeFloat4 o = XeSimd::mul(XeSimd::lane<0>(v.v), m.r[0]);
+    o = XeSimd::add(o, XeSimd::mul(XeSimd::lane<1>(v.v), m.r[1]));
+    o = XeSimd::add(o, XeSimd::mul(XeSimd::lane<2>(v.v), m.r[2]));
+    o = XeSimd::add(o, XeSimd::mul(XeSimd::lane<3>(v.v), m.r[3]));
+    return XeVector4A(o);
+}
+
+inline XeVector4 XeVector4A::packed() const
+{
+    XeVector4 p;
+    XeSimd::store(p.xywz, v);
+    return p;
+}
+
+inline XeVector3 XeVector4A::packed3() const
+{
+    XeVector3 p;
+    XeSimd::store3(p.xyz, v);
+    return p;
+}
+
+inline float XeVector4A::x() const { return XeSimd::first(v); }
+inline float XeVector4A::y() const { return XeSimd::first(XeSimd::lane<1>(v)); }
+inline float XeVector4A::z() const { return XeSimd::first(XeSimd::lane<2>(v)); }
+inline float XeVector4A::w() const { return XeSimd::first(XeSimd::lane<3>(v)); }
+
+inline float XeVector4A::length() const
+{
+    return XeVector4A::Length(*this);
+}
+
+inline float XeVector4A::lengthSquared() const
+{
+    return XeVector4A::LengthSquared(*this);
+}
+
+inline float XeVector4A::dot(const XeVector4A &other) const
+{
+    return XeVector4A::Dot(*this, other);
+}
+
+inline XeVector4A XeVector4A::normalize() const
+{
+    return XeVector4A::Normalize(*this);
+}
+
+inline XeVector4A XeVector4A::operator+ (const XeVector4A& rhs) const
+{
+    return XeVector4A(XeSimd::add(v, rhs.v));
+}
+
+inline XeVector4A XeVector4A::operator- (const XeVector4A& rhs) const
+{
+    return XeVector4A(XeSimd::sub(v, rhs.v));
+}
+
+inline XeVector4A XeVector4A::operator- () const
+{
+    return XeVector4A(XeSimd::mul(v, XeSimd::splat(-1.f)));
+}
+
+inline XeVector4A XeVector4A::operator* (float rhs) const
+{
+    return XeVector4A(XeSimd::mul(XeSimd::splat(rhs), v));
+}
+
+inline XeVector4A XeVector4A::operator/ (float rhs) const
+{
+    return (*this) * (1.f / rhs);
+}
+
+inline XeVector4A& XeVector4A::operator+= (const XeVector4A& rhs)
+{
+    v = XeSimd::add(v, rhs.v);
+    return *this;
+}
+
+inline XeVector4A& XeVector4A::operator-= (const XeVector4A& rhs)
+{
+    v = XeSimd::sub(v, rhs.v);
+    return *this;
+}
+
+inline XeVector4A& XeVector4A::operator*= (float rhs)
+{
+    v = XeSimd::mul(XeSimd::splat(rhs), v);
+    return *this;
+}
+
+inline XeVector4A& XeVector4A::operator/= (float rhs)
+{
+    return ((*this) *= (1.f / rhs));
+}
+
+inline XeVector4A operator* (float lhs, const XeVector4A& rhs)
+{
+    return rhs * lhs;
+}
+
+inline XeVector4A XeMatrixA::operator* (const XeVector4A& rhs) const
+{
+    return XeVector4A::Transform(*this, rhs);
+}
+
+#endif // VECTOR4A_H
@@ -33,5 +33,14 @@ public:
     virtual bool isFullscreen() const = 0;
     virtual void setFullscreen(bool) = 0;
     virtual void toggleFullscreen() = 0;
+
+    /** Gets or sets whether the mouse is in relative mode (the default).
+      * In relative mode the cursor is hidden and kept inside the window, so
+      * the mouse axes can keep reporting motion no matter how far the mouse
+      * moves. Otherwise the cursor is visible and free to leave the window.
+      * Either way, the axes report the total motion of each tick
+      */
+    virtual bool isRelativeMouse() const = 0;
+    virtual void setRelativeMouse(bool) = 0;
 };
 
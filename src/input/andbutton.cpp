@@ -1,16 +1,18 @@
 
 #include "xe/andbutton.h"
 
+XeAndButton::XeAndButton() : m_named(false) { }
+
 void XeAndButton::attach(XeButtonInput *b)
 {
     m_children.append(b);
-    rename();
+    m_named = false;
 }
 
 void XeAndButton::detach(XeButtonInput *b)
 {
     m_children.removeOne(b);
-    rename();
+    m_named = false;
 }
 
 bool XeAndButton::isAttached(XeButtonInput *b) const
@@ -18,6 +20,11 @@ bool XeAndButton::isAttached(XeButtonInput *b) const
     return m_children.contains(b);
 }
 
+const QList<XeButtonInput *> &XeAndButton::children() const
+{
+    return m_children;
+}
+
 bool XeAndButton::isDown() const
 {
     foreach (XeButtonInput *b, m_children)
@@ -29,12 +36,16 @@ bool XeAndButton::isDown() const
 
 const char *XeAndButton::id() const
 {
-    return m_id.toUtf8().data();
+    if (!m_named)
+        rename();
+    return m_id.constData();
 }
 
 const char *XeAndButton::name() const
 {
-    return m_name.toUtf8().data();
+    if (!m_named)
+        rename();
+    return m_name.constData();
 }
 
 const char *XeAndButton::deviceID() const
@@ -42,20 +53,24 @@ const char *XeAndButton::deviceID() const
     return "anonymous";
 }
 
-void XeAndButton::rename()
+void XeAndButton::rename() const
 {
     m_id = "and";
-    m_name = "";
+    m_name.clear();
 
     for (int i = 0; i < m_children.count(); ++i)
     {
         XeButtonInput *b = m_children[i];
-        
-        m_id += QString("-") + b->id();
 
-        if (i > 0) 
+        m_id += '-';
+        m_id += b->id();
+
+        if (i > 0)
             m_name += " + ";
-        m_name += QString("(") + b->name() + ")";
+        m_name += '(';
+        m_name += b->name();
+        m_name += ')';
     }
-}
 
+    m_named = true;
+}
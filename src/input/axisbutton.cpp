@@ -1,7 +1,8 @@
 
 #include "xe/axisbutton.h"
 
-XeAxisButton::XeAxisButton(XeAxisInput *child, const XeRangeF &active) : m_axis(child), m_range(active) { }
+XeAxisButton::XeAxisButton(XeAxisInput *child, const XeRangeF &active)
+    : m_axis(child), m_range(active), m_named(false) { }
 
 XeAxisInput *XeAxisButton::child() const
 {
@@ -11,8 +12,7 @@ XeAxisInput *XeAxisButton::child() const
 void XeAxisButton::setChild(XeAxisInput *child) 
 {
     m_axis = child;
-    m_name = child->name();
-    m_id = child->id();
+    m_named = false;
 }
 
 const XeRangeF &XeAxisButton::activationRange() const
@@ -27,12 +27,16 @@ void XeAxisButton::setActivationRange(const XeRangeF &range)
 
 const char *XeAxisButton::id() const
 {
-    return m_id.toUtf8().data();
+    if (!m_named)
+        rename();
+    return m_id.constData();
 }
 
 const char *XeAxisButton::name() const
 {
-    return m_name.toUtf8().data();
+    if (!m_named)
+        rename();
+    return m_name.constData();
 }
 
 const char *XeAxisButton::deviceID() const
@@ -45,3 +49,9 @@ bool XeAxisButton::isDown() const
     return m_range.contains(m_axis->value());
 }
 
+void XeAxisButton::rename() const
+{
+    m_id = m_axis ? m_axis->id() : "<nil>";
+    m_name = m_axis ? m_axis->name() : "<nil>";
+    m_named = true;
+}
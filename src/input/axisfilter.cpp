@@ -0,0 +1,203 @@
+
+#include "xe/axisfilter.h"
+#include "xe/trace.h"
+
+#include <cmath>
+
+XeAxisFilters::XeAxisFilters() { }
+
+XeAxisFilters::Stage XeAxisFilters::stage(Type type, int axis)
+{
+    Stage s;
+    s.type = type;
+    s.axis = axis;
+    s.axis2 = -1;
+    s.a = s.b = s.state = 0.f;
+    s.first = s.points = 0;
+    return s;
+}
+
+qint64 XeAxisFilters::order(const Stage &s)
+{
+    return (qint64)(s.type != RADIAL_DEADZONE) << 32 | s.axis;
+}
+
+void XeAxisFilters::add(const Stage &s)
+{
+    if (s.axis < 0)
+    {
+        xe_trace.warn << "XeAxisFilters: stage added to an invalid axis handle";
+        return;
+    }
+
+    // Keep the stages of each axis together and in the order they were
+    // added, so run() is a single pass. Radial dead zones read and write two
+    // axes, so they all come first
+    int i = m_stages.count();
+    while (i > 0 && order(m_stages[i - 1]) > order(s))
+        --i;
+
+    m_stages.insert(i, s);
+}
+
+void XeAxisFilters::deadZone(XeAxisHandle axis, float size)
+{
+    Stage s = stage(DEADZONE, axis.index);
+    s.a = qBound(0.f, size, .99f);
+    add(s);
+}
+
+void XeAxisFilters::radialDeadZone(XeAxisHandle x, XeAxisHandle y, float size)
+{
+    Stage s = stage(RADIAL_DEADZONE, x.index);
+    s.axis2 = y.index;
+    s.a = qBound(0.f, size, .99f);
+    add(s);
+}
+
+void XeAxisFilters::exponent(XeAxisHandle axis, float power)
+{
+    Stage s = stage(EXPONENT, axis.index);
+    s.a = power;
+    add(s);
+}
+
+void XeAxisFilters::curve(XeAxisHandle axis, const QVector<float> &points)
+{
+    if (points.count() < 2)
+    {
+        xe_trace.warn << "XeAxisFilters: a curve needs at least two points";
+        return;
+    }
+
+    Stage s = stage(CURVE, axis.index);
+    s.first = m_points.count();
+    s.points = points.count();
+    m_points += points;
+    add(s);
+}
+
+void XeAxisFilters::smooth(XeAxisHandle axis, float seconds)
+{
+    Stage s = stage(SMOOTH, axis.index);
+    s.a = seconds;
+    add(s);
+}
+
+void XeAxisFilters::accelerate(XeAxisHandle axis, float gain, float limit)
+{
+    Stage s = stage(ACCELERATE, axis.index);
+    s.a = gain;
+    s.b = limit;
+    add(s);
+}
+
+void XeAxisFilters::clear(XeAxisHandle axis)
+{
+    for (int i = m_stages.count() - 1; i >= 0; --i)
+    {
+        Stage s = m_stages[i];
+        if (s.axis != axis.index && s.axis2 != axis.index)
+            continue;
+
+        m_stages.remove(i);
+
+        // Give back the curve's points, and close the gap in the ranges of
+        // the curves that come after it
+        if (s.type == CURVE)
+        {
+            m_points.remove(s.first, s.points);
+            for (int j = 0; j < m_stages.count(); ++j)
+                if (m_stages[j].type == CURVE && m_stages[j].first > s.first)
+                    m_stages[j].first -= s.points;
+        }
+    }
+}
+
+void XeAxisFilters::clear()
+{
+    m_stages.clear();
+    m_points.clear();
+}
+
+int XeAxisFilters::count() const
+{
+    return m_stages.count();
+}
+
+static inline float sign_of(float v)
+{
+    return v < 0.f ? -1.f : 1.f;
+}
+
+void XeAxisFilters::run(float *values, int count, float dt)
+{
+    Stage *stages = m_stages.data();
+    const float *points = m_points.constData();
+
+    for (int i = 0, n = m_stages.count(); i < n; ++i)
+    {
+        Stage &s = stages[i];
+        if (s.axis >= count)
+        {
+            if (s.type == RADIAL_DEADZONE)
+                continue;
+            break;
+        }
+
+        float v = values[s.axis];
+        float m = fabsf(v);
+
+        switch (s.type)
+        {
+        case DEADZONE:
+            v = m <= s.a ? 0.f : sign_of(v) * (m - s.a) / (1.f - s.a);
+            break;
+
+        case RADIAL_DEADZONE:
+        {
+            if (s.axis2 < 0 || s.axis2 >= count)
+                break;
+
+            float y = values[s.axis2];
+            float len = sqrtf(v * v + y * y);
+            float scale = len <= s.a ? 0.f : (len - s.a) / (1.f - s.a) / len;
+
+            v *= scale;
+            values[s.axis2] = y * scale;
+            break;
+        }
+
+        case EXPONENT:
+            v = sign_of(v) * powf(m, s.a);
+            break;
+
+        case CURVE:
+        {
+            // Inputs beyond 1 stay on the last segment's value
+            float x = qMin(m, 1.f) * (s.points - 1);
+            int p = qMin((int)x, s.points - 2);
+            float t = x - p;
+            const float *c = points + s.first;
+
+            v = sign_of(v) * (c[p] + (c[p + 1] - c[p]) * t);
+            break;
+        }
+
+        case SMOOTH:
+            if (s.a > 0.f)
+            {
+                s.state += (v - s.state) * (1.f - expf(-dt / s.a));
+                v = s.state;
+            }
+            break;
+
+        case ACCELERATE:
+            if (dt > 0.f)
+                v *= qMin(1.f + s.a * m / dt, s.b);
+            break;
+        }
+
+        values[s.axis] = v;
+    }
+}
@@ -0,0 +1,490 @@
+
+#include "xe/bindingprofile.h"
+#include "xe/strings.h"
+#include "xe/trace.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QList>
+
+typedef XeBindingProfile::Node Node;
+typedef XeBindingProfile::Operand Operand;
+
+// Parses one line of a profile at a time into flat node and operand tables.
+// Each node is appended after the nodes it refers to, so the tables can be
+// compiled in order
+class ProfileParser
+{
+public:
+    ProfileParser(QVector<Node> &nodes, QVector<Operand> &operands)
+        : m_nodes(nodes), m_operands(operands), m_p(0) { }
+
+    QString error;
+
+    // Parses "button|axis name = expression". Returns false on error; a
+    // blank or comment line leaves kind empty
+    bool line(const char *text, QByteArray &kind, QByteArray &name, int &node)
+    {
+        m_p = text;
+        kind.clear();
+
+        if (atEnd())
+            return true;
+
+        if (!id(kind) || (kind != "button" && kind != "axis"))
+            return fail("expected 'button' or 'axis'");
+        if (!id(name))
+            return fail("expected a name");
+        if (!accept('='))
+            return fail("expected '='");
+
+        node = kind == "button" ? orExpr() : axisExpr();
+        if (node < 0)
+            return false;
+
+        return atEnd() || fail("unexpected text after the expression");
+    }
+
+private:
+    QVector<Node> &m_nodes;
+    QVector<Operand> &m_operands;
+    const char *m_p;
+
+    bool fail(const char *message)
+    {
+        if (error.isEmpty())
+            error = message;
+        return false;
+    }
+
+    int failNode(const char *message)
+    {
+        fail(message);
+        return -1;
+    }
+
+    void skip()
+    {
+        while (*m_p == ' ' || *m_p == '\t' || *m_p == '\r')
+            ++m_p;
+    }
+
+    bool atEnd()
+    {
+        skip();
+        return *m_p == '\0' || *m_p == '#';
+    }
+
+    bool accept(char c)
+    {
+        skip();
+        if (*m_p != c)
+            return false;
+
+        ++m_p;
+        return true;
+    }
+
+    bool id(QByteArray &out)
+    {
+        skip();
+        out.clear();
+
+        if (*m_p == '"')
+        {
+            const char *start = ++m_p;
+            while (*m_p && *m_p != '"')
+                ++m_p;
+            if (*m_p != '"')
+                return fail("unterminated quote");
+
+            out = QByteArray(start, m_p++ - start);
+            return !out.isEmpty();
+        }
+
+        const char *start = m_p;
+        while ((*m_p >= 'a' && *m_p <= 'z') || (*m_p >= 'A' && *m_p <= 'Z') ||
+               (*m_p >= '0' && *m_p <= '9') || *m_p == '_')
+            ++m_p;
+
+        out = QByteArray(start, m_p - start);
+        return !out.isEmpty();
+    }
+
+    static bool digit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    // Scans the number first and converts it with QByteArray, which always
+    // uses '.' as the decimal point; strtod() would follow the locale
+    bool number(float &out)
+    {
+        skip();
+        const char *start = m_p;
+
+        if (*m_p == '-' || *m_p == '+')
+            ++m_p;
+        while (digit(*m_p) || *m_p == '.')
+            ++m_p;
+        if ((*m_p == 'e' || *m_p == 'E') && (digit(m_p[1]) || ((m_p[1] == '-' || m_p[1] == '+') && digit(m_p[2]))))
+        {
+            m_p += 2;
+            while (digit(*m_p))
+                ++m_p;
+        }
+
+        bool ok = false;
+        out = QByteArray::fromRawData(start, m_p - start).toFloat(&ok);
+        if (!ok)
+        {
+            m_p = start;
+            return fail("expected a number");
+        }
+
+        return true;
+    }
+
+    int add(const Node &n)
+    {
+        m_nodes.append(n);
+        return m_nodes.count() - 1;
+    }
+
+    static Node node(XeBindingProfile::NodeType type)
+    {
+        Node n;
+        n.type = type;
+        n.device = n.input = 0;
+        n.first = n.count = 0;
+        n.min = n.max = 0.f;
+        return n;
+    }
+
+    // device.input
+    int ref(XeBindingProfile::NodeType type)
+    {
+        QByteArray device, input;
+        if (!id(device))
+            return failNode("expected a device ID");
+        if (!accept('.'))
+            return failNode("expected '.' after the device ID");
+        if (!id(input))
+            return failNode("expected an input ID");
+
+        Node n = node(type);
+        n.device = xe_strings.intern(device);
+        n.input = xe_strings.intern(input);
+        return add(n);
+    }
+
+    int list(XeBindingProfile::NodeType type, const QVector<int> &children)
+    {
+        if (children.count() == 1)
+            return children[0];
+
+        Node n = node(type);
+        n.first = m_operands.count();
+        n.count = children.count();
+        foreach (int c, children)
+        {
+            Operand o = { c, 0.f };
+            m_operands.append(o);
+        }
+
+        return add(n);
+    }
+
+    int orExpr()
+    {
+        QVector<int> children;
+        do
+        {
+            int c = andExpr();
+            if (c < 0)
+                return -1;
+            children.append(c);
+        }
+        while (accept('|'));
+
+        return list(XeBindingProfile::OR, children);
+    }
+
+    int andExpr()
+    {
+        QVector<int> children;
+        do
+        {
+            int c = unary();
+            if (c < 0)
+                return -1;
+            children.append(c);
+        }
+        while (accept('&'));
+
+        return list(XeBindingProfile::AND, children);
+    }
+
+    int unary()
+    {
+        if (accept('!'))
+        {
+            int c = unary();
+            if (c < 0)
+                return -1;
+
+            Node n = node(XeBindingProfile::NOT);
+            n.first = c;
+            return add(n);
+        }
+
+        if (accept('('))
+        {
+            int c = orExpr();
+            if (c < 0)
+                return -1;
+            if (!accept(')'))
+                return failNode("expected ')'");
+            return c;
+        }
+
+        // A reference followed by a range is an axis acting as a button
+        int r = ref(XeBindingProfile::BUTTON);
+        if (r < 0 || !accept('['))
+            return r;
+
+        m_nodes[r].type = XeBindingProfile::AXIS;
+
+        Node n = node(XeBindingProfile::AXIS_BUTTON);
+        n.first = r;
+        if (!number(n.min) || !accept(',') || !number(n.max) || !accept(']'))
+            return failNode("expected [min, max]");
+
+        return add(n);
+    }
+
+    int axisExpr()
+    {
+        // A single device input is an axis; anything else is a sum of buttons
+        const char *start = m_p;
+        int nodes = m_nodes.count();
+
+        int r = ref(XeBindingProfile::AXIS);
+        if (r >= 0 && atEnd())
+            return r;
+
+        m_p = start;
+        m_nodes.resize(nodes);
+        error.clear();
+
+        QVector<Operand> terms;
+        float sign = accept('-') ? -1.f : 1.f;
+        do
+        {
+            int c = unary();
+            if (c < 0)
+                return -1;
+
+            Operand o = { c, sign };
+            if (accept('*'))
+            {
+                float w;
+                if (!number(w))
+                    return -1;
+                o.weight *= w;
+            }
+            terms.append(o);
+
+            if (accept('+'))
+                sign = 1.f;
+            else if (accept('-'))
+                sign = -1.f;
+            else
+                break;
+        }
+        while (true);
+
+        Node n = node(XeBindingProfile::BUTTON_AXIS);
+        n.first = m_operands.count();
+        n.count = terms.count();
+        m_operands += terms;
+
+        return add(n);
+    }
+};
+
+XeBindingProfile::XeBindingProfile()
+        : m_revision(0), m_path(""), m_pollInterval(1.f), m_sincePoll(0.f)
+{ }
+
+bool XeBindingProfile::parse(const QByteArray &text, QString *error)
+{
+    return parse(text, "<text>", error);
+}
+
+bool XeBindingProfile::parse(const QByteArray &text, const char *source, QString *error)
+{
+    QVector<Node> nodes;
+    QVector<Operand> operands;
+    QVector<Binding> buttons, axes;
+    QHash<QByteArray, int> buttonIndex, axisIndex;
+
+    ProfileParser parser(nodes, operands);
+    QList<QByteArray> lines = text.split('\n');
+
+    for (int i = 0; i < lines.count(); ++i)
+    {
+        QByteArray kind, name;
+        int node = -1;
+
+        if (!parser.line(lines[i].constData(), kind, name, node))
+        {
+            QString message = QString("XeBindingProfile: %1 line %2: %3")
+                              .arg(source).arg(i + 1).arg(parser.error);
+            xe_trace.error << message;
+            if (error)
+                *error = message;
+            return false;
+        }
+
+        if (kind.isEmpty())
+            continue;
+
+        // A name bound twice keeps its last binding
+        Binding b = { xe_strings.intern(name), node };
+        QVector<Binding> &list = kind == "button" ? buttons : axes;
+        QHash<QByteArray, int> &index = kind == "button" ? buttonIndex : axisIndex;
+
+        if (index.contains(name))
+        {
+            list[index[name]] = b;
+        }
+        else
+        {
+            index[name] = list.count();
+            list.append(b);
+        }
+    }
+
+    m_nodes = nodes;
+    m_operands = operands;
+    m_buttons = buttons;
+    m_axes = axes;
+    m_buttonIndex = buttonIndex;
+    m_axisIndex = axisIndex;
+    ++m_revision;
+
+    return true;
+}
+
+bool XeBindingProfile::load(const char *path)
+{
+    QFile file(QString::fromUtf8(path));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        xe_trace.error << QString("XeBindingProfile: can't open %1").arg(path);
+        return false;
+    }
+
+    QDateTime modified = QFileInfo(file).lastModified();
+    m_sincePoll = 0.f;
+
+    // The file is only remembered once it parses, so a broken file is
+    // tried again at the next poll, even if the fix kept its mtime
+    if (!parse(file.readAll(), path, 0))
+        return false;
+
+    m_path = xe_strings.intern(path);
+    m_modified = modified;
+    return true;
+}
+
+const char *XeBindingProfile::path() const
+{
+    return m_path;
+}
+
+bool XeBindingProfile::reload()
+{
+    if (!*m_path)
+        return false;
+
+    // A file that's being rewritten may briefly be missing; try again later
+    QFileInfo info(QString::fromUtf8(m_path));
+    if (!info.exists() || info.lastModified() == m_modified)
+        return false;
+
+    quint64 revision = m_revision;
+    load(m_path);
+
+    return m_revision != revision;
+}
+
+float XeBindingProfile::pollInterval() const
+{
+    return m_pollInterval;
+}
+
+void XeBindingProfile::setPollInterval(float seconds)
+{
+    m_pollInterval = seconds;
+}
+
+void XeBindingProfile::clear()
+{
+    m_nodes.clear();
+    m_operands.clear();
+    m_buttons.clear();
+    m_axes.clear();
+    m_buttonIndex.clear();
+    m_axisIndex.clear();
+    ++m_revision;
+}
+
+quint64 XeBindingProfile::revision() const
+{
+    return m_revision;
+}
+
+const QVector<Node> &XeBindingProfile::nodes() const
+{
+    return m_nodes;
+}
+
+const QVector<Operand> &XeBindingProfile::operands() const
+{
+    return m_operands;
+}
+
+const QVector<XeBindingProfile::Binding> &XeBindingProfile::buttons() const
+{
+    return m_buttons;
+}
+
+const QVector<XeBindingProfile::Binding> &XeBindingProfile::axes() const
+{
+    return m_axes;
+}
+
+int XeBindingProfile::findButton(const char *name) const
+{
+    return m_buttonIndex.value(QByteArray::fromRawData(name, qstrlen(name)), -1);
+}
+
+int XeBindingProfile::findAxis(const char *name) const
+{
+    return m_axisIndex.value(QByteArray::fromRawData(name, qstrlen(name)), -1);
+}
+
+void XeBindingProfile::update(float dt)
+{
+    if (m_pollInterval <= 0.f || !*m_path)
+        return;
+
+    m_sincePoll += dt;
+    if (m_sincePoll < m_pollInterval)
+        return;
+
+    m_sincePoll = 0.f;
+    reload();
+}
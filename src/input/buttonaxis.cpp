@@ -1,21 +1,12 @@
 
 #include "xe/buttonaxis.h"
 
+XeButtonAxis::XeButtonAxis() : m_named(false) { }
+
 void XeButtonAxis::attach(XeButtonInput *button, float upval, float downval)
 {
     m_buttons.append(ButtonValue(button, upval, downval));
-
-    m_id = "";
-    m_name = "";
-
-    for (int i = 0; i < m_buttons.count(); ++i)
-    {
-        if (i > 0) m_id += "-";
-        m_id += m_buttons[i].button->id();
-
-        if (i > 0) m_name += ", ";
-        m_name += m_buttons[i].button->name();
-    }
+    m_named = false;
 }
 
 void XeButtonAxis::detach(XeButtonInput *button)
@@ -25,6 +16,7 @@ void XeButtonAxis::detach(XeButtonInput *button)
         if (m_buttons[i].button == button)
         {
             m_buttons.removeAt(i);
+            m_named = false;
             break;
         }
     }
@@ -39,14 +31,23 @@ bool XeButtonAxis::isAttached(XeButtonInput *button) const
     return false;
 }
 
+const QList<XeButtonAxis::ButtonValue> &XeButtonAxis::buttons() const
+{
+    return m_buttons;
+}
+
 const char *XeButtonAxis::id() const
 {
-    return m_id.toUtf8().data();
+    if (!m_named)
+        rename();
+    return m_id.constData();
 }
 
 const char *XeButtonAxis::name() const
 {
-    return m_name.toUtf8().data();
+    if (!m_named)
+        rename();
+    return m_name.constData();
 }
 
 const char *XeButtonAxis::deviceID() const
@@ -63,3 +64,19 @@ float XeButtonAxis::value() const
     return val;
 }
 
+void XeButtonAxis::rename() const
+{
+    m_id.clear();
+    m_name.clear();
+
+    for (int i = 0; i < m_buttons.count(); ++i)
+    {
+        if (i > 0) m_id += '-';
+        m_id += m_buttons[i].button->id();
+
+        if (i > 0) m_name += ", ";
+        m_name += m_buttons[i].button->name();
+    }
+
+    m_named = true;
+}
@@ -0,0 +1,264 @@
+
+#include "xe/combo.h"
+#include "xe/inputdevice.h"
+#include "xe/kernel.h"
+#include "xe/trace.h"
+
+#include <algorithm>
+
+// Times presses are compared against; far enough in the past that any
+// window has expired
+static const double never = -1e9;
+
+XeComboMatcher::XeComboMatcher() : m_time(0.) { }
+
+int XeComboMatcher::button(XeButtonInput *input)
+{
+    int i = m_index.value(input, -1);
+    if (i != -1)
+        return i;
+
+    QByteArray deviceID(input->deviceID());
+    if (!m_devices.contains(deviceID))
+        m_devices.append(deviceID);
+
+    Button b;
+    b.input = input;
+    b.down = input->isDown();
+    b.downSince = b.down ? m_time : never;
+    b.lastPress = never;
+    m_index[input] = m_buttons.count();
+    m_buttons.append(b);
+
+    return m_buttons.count() - 1;
+}
+
+XeCombo XeComboMatcher::add(Type type, const char *name, const QList<XeButtonInput*> &buttons,
+                            float window, float hold)
+{
+    if (buttons.isEmpty() || buttons.contains(0))
+    {
+        xe_trace.error << QString("XeComboMatcher: combo %1 has no buttons, or a NULL button").arg(name);
+        return -1;
+    }
+
+    XeCombo c = m_combos.count();
+
+    Combo combo;
+    combo.type = type;
+    combo.name = name;
+    combo.window = window;
+    combo.hold = hold;
+    combo.step = 0;
+    combo.start = never;
+    combo.chargedUntil = never;
+    combo.fired = false;
+
+    foreach (XeButtonInput *input, buttons)
+    {
+        int b = button(input);
+        combo.buttons.append(b);
+
+        // A button that appears in a combo more than once (e.g. a double
+        // tap) still only notifies it once per press
+        if (!m_buttons[b].combos.contains(c))
+            m_buttons[b].combos.append(c);
+    }
+
+    m_combos.append(combo);
+    return c;
+}
+
+XeCombo XeComboMatcher::sequence(const char *name, const QList<XeButtonInput*> &buttons, float window)
+{
+    return add(SEQUENCE, name, buttons, window, 0.f);
+}
+
+XeCombo XeComboMatcher::chord(const char *name, const QList<XeButtonInput*> &buttons, float window)
+{
+    return add(CHORD, name, buttons, window, 0.f);
+}
+
+XeCombo XeComboMatcher::charge(const char *name, XeButtonInput *hold, float seconds, XeButtonInput *release,
+                               float window)
+{
+    QList<XeButtonInput*> buttons;
+    buttons << hold << release;
+    return add(CHARGE, name, buttons, window, seconds);
+}
+
+void XeComboMatcher::clear()
+{
+    m_combos.clear();
+    m_buttons.clear();
+    m_index.clear();
+    m_devices.clear();
+    m_completed.clear();
+}
+
+int XeComboMatcher::count() const
+{
+    return m_combos.count();
+}
+
+const char *XeComboMatcher::name(XeCombo c) const
+{
+    return c >= 0 && c < m_combos.count() ? m_combos[c].name.constData() : "";
+}
+
+bool XeComboMatcher::fired(XeCombo c) const
+{
+    return c >= 0 && c < m_combos.count() && m_combos[c].fired;
+}
+
+const QList<XeCombo> &XeComboMatcher::completed() const
+{
+    return m_completed;
+}
+
+void XeComboMatcher::fire(XeCombo c)
+{
+    if (!m_combos[c].fired)
+    {
+        m_combos[c].fired = true;
+        m_completed.append(c);
+    }
+}
+
+void XeComboMatcher::press(XeCombo c, int b, double time)
+{
+    Combo &combo = m_combos[c];
+
+    switch (combo.type)
+    {
+    case SEQUENCE:
+        if (combo.step > 0 && time - combo.start > combo.window)
+            combo.step = 0;
+
+        if (combo.buttons[combo.step] == b)
+        {
+            if (combo.step == 0)
+                combo.start = time;
+
+            if (++combo.step == combo.buttons.count())
+            {
+                combo.step = 0;
+                fire(c);
+            }
+        }
+        else
+        {
+            // Out of order: the press may still start the sequence over
+            combo.step = 0;
+            if (combo.buttons[0] == b)
+            {
+                combo.start = time;
+                combo.step = 1;
+            }
+        }
+        break;
+
+    case CHORD:
+        foreach (int i, combo.buttons)
+            if (!m_buttons[i].down || time - m_buttons[i].lastPress > combo.window)
+                return;
+
+        // Each press completes the chord at most once
+        foreach (int i, combo.buttons)
+            m_buttons[i].lastPress = never;
+        fire(c);
+        break;
+
+    case CHARGE:
+    {
+        if (b != combo.buttons[1])
+            return;
+
+        const Button &hold = m_buttons[combo.buttons[0]];
+        bool held = hold.down && time - hold.downSince >= combo.hold;
+
+        if (held || time <= combo.chargedUntil)
+        {
+            combo.chargedUntil = never;
+            fire(c);
+        }
+        break;
+    }
+    }
+}
+
+void XeComboMatcher::transition(int i, bool down, double time)
+{
+    Button &b = m_buttons[i];
+    if (down == b.down)
+        return;
+
+    b.down = down;
+
+    if (down)
+    {
+        b.downSince = time;
+        b.lastPress = time;
+
+        foreach (XeCombo c, b.combos)
+            press(c, i, time);
+    }
+    else
+    {
+        // Letting go of a charged button keeps the charge for a while
+        foreach (XeCombo c, b.combos)
+        {
+            Combo &combo = m_combos[c];
+            if (combo.type == CHARGE && combo.buttons[0] == i && time - b.downSince >= combo.hold)
+                combo.chargedUntil = time + combo.window;
+        }
+    }
+}
+
+void XeComboMatcher::update(float dt)
+{
+    double start = m_time;
+    m_time += dt;
+
+    foreach (XeCombo c, m_completed)
+        m_combos[c].fired = false;
+    m_completed.clear();
+
+    // Collect the presses and releases of the combos' buttons since the last
+    // tick, walking each device's queue once, so presses within one tick
+    // keep their order and timing
+    m_events.clear();
+    foreach (const QByteArray &id, m_devices)
+    {
+        XeInputDevice *device = xe_kernel ? xe_kernel->device(id.constData()) : 0;
+        if (!device)
+            continue;
+
+        const XeInputEventQueue &events = device->events();
+        for (int j = 0; j < events.count(); ++j)
+        {
+            const XeInputEvent &ev = events[j];
+            int i = ev.type == XeInputEvent::AXIS ? -1 : m_index.value(ev.button, -1);
+            if (i == -1)
+                continue;
+
+            // Place the event within this tick by how far into the queue's
+            // window it arrived
+            double offset = qBound(0., (ev.time - events.start()) * 1e-9, (double)dt);
+            Event e = { start + offset, i, ev.type == XeInputEvent::PRESS };
+            m_events.append(e);
+        }
+    }
+
+    std::stable_sort(m_events.begin(), m_events.end(),
+                     [](const Event &a, const Event &b) { return a.time < b.time; });
+
+    foreach (const Event &e, m_events)
+        transition(e.button, e.down, e.time);
+
+    // Composite buttons have no events and are sampled instead, and if a
+    // queue overflowed a button may have changed without one; catch up at
+    // the end of the tick with the buttons whose state still differs
+    for (int i = 0; i < m_buttons.count(); ++i)
+        transition(i, m_buttons[i].input->isDown(), m_time);
+}
@@ -1,28 +1,89 @@
 
+#include "xe/bindingprofile.h"
 #include "xe/input.h"
+#include "xe/kernel.h"
 #include "xe/trace.h"
 
 XeInput xe_input;
 
+// Gets the event queue of the device an input belongs to, or NULL if the
+// input isn't attached directly to a device
+static const XeInputEventQueue *device_events(const char *deviceID)
+{
+    XeInputDevice *device = xe_kernel ? xe_kernel->device(deviceID) : 0;
+    return device ? &device->events() : 0;
+}
+
+// Collects a button's events (or only its presses) from its device's queue
+static int button_events(const XeButtonInput *button, QList<XeInputEvent> *out, bool pressesOnly)
+{
+    const XeInputEventQueue *events = button ? device_events(button->deviceID()) : 0;
+    if (!events)
+        return 0;
+
+    int n = 0;
+    for (int i = 0; i < events->count(); ++i)
+    {
+        const XeInputEvent &ev = (*events)[i];
+        if (ev.button != button || (pressesOnly && ev.type != XeInputEvent::PRESS))
+            continue;
+
+        if (out)
+            out->append(ev);
+        ++n;
+    }
+
+    return n;
+}
+
+static int axis_events(const XeAxisInput *axis, QList<XeInputEvent> &out)
+{
+    const XeInputEventQueue *events = axis ? device_events(axis->deviceID()) : 0;
+    if (!events)
+        return 0;
+
+    int n = 0;
+    for (int i = 0; i < events->count(); ++i)
+    {
+        if ((*events)[i].axis == axis)
+        {
+            out.append((*events)[i]);
+            ++n;
+        }
+    }
+
+    return n;
+}
+
+XeButtonMap::XeButtonMap() : m_revision(0) { }
+
 void XeButtonMap::map(const char *name, XeButtonInput *button)
 {
-    m_map[name] = button;
+    ++m_revision;
+    m_buttons[handle(name).index] = button;
 }
 
 void XeButtonMap::unmap(const char *name)
 {
-    m_map.remove(name);
+    // The handle stays reserved, so handles resolved earlier remain valid
+    int h = m_handles.value(QByteArray(name), -1);
+    if (h != -1)
+    {
+        m_buttons[h] = 0;
+        ++m_revision;
+    }
 }
 
 XeButtonInput *XeButtonMap::get(const char *name) const
 {
-    if (!m_map.contains(name))
+    int h = m_handles.value(QByteArray(name), -1);
+    if (h == -1 || !m_buttons[h])
     {
         xe_trace.warn("Unknown button input [%s] in XeButtonMap::get", name);
         return 0;
     }
 
-    return m_map[name];
+    return m_buttons[h];
 }
 
 XeButtonInput *XeButtonMap::operator[](const char *name) const
@@ -30,25 +91,81 @@ XeButtonInput *XeButtonMap::operator[](const char *name) const
     return get(name);
 }
 
+XeButtonHandle XeButtonMap::handle(const char *name)
+{
+    QByteArray key(name);
+    int h = m_handles.value(key, -1);
+    if (h == -1)
+    {
+        h = m_buttons.count();
+        m_handles[key] = h;
+        m_buttons.append(0);
+        m_names.append(key);
+        ++m_revision;
+    }
+
+    return XeButtonHandle(h);
+}
+
+XeButtonInput *XeButtonMap::get(XeButtonHandle h) const
+{
+    return h.index >= 0 && h.index < m_buttons.count() ? m_buttons[h.index] : 0;
+}
+
+XeButtonInput *XeButtonMap::operator[](XeButtonHandle h) const
+{
+    return get(h);
+}
+
+XeButtonHandle XeButtonMap::find(const char *name) const
+{
+    return XeButtonHandle(m_handles.value(QByteArray(name), -1));
+}
+
+const char *XeButtonMap::name(XeButtonHandle h) const
+{
+    return h.index >= 0 && h.index < m_names.count() ? m_names[h.index].constData() : "";
+}
+
+int XeButtonMap::count() const
+{
+    return m_buttons.count();
+}
+
+quint64 XeButtonMap::revision() const
+{
+    return m_revision;
+}
+
+XeAxisMap::XeAxisMap() : m_revision(0) { }
+
 void XeAxisMap::map(const char *name, XeAxisInput *button)
 {
-    m_map[name] = button;
+    ++m_revision;
+    m_axes[handle(name).index] = button;
 }
 
 void XeAxisMap::unmap(const char *name)
 {
-    m_map.remove(name);
+    // The handle stays reserved, so handles resolved earlier remain valid
+    int h = m_handles.value(QByteArray(name), -1);
+    if (h != -1)
+    {
+        m_axes[h] = 0;
+        ++m_revision;
+    }
 }
 
 XeAxisInput *XeAxisMap::get(const char *name) const
 {
-    if (!m_map.contains(name))
+    int h = m_handles.value(QByteArray(name), -1);
+    if (h == -1 || !m_axes[h])
     {
         xe_trace.warn("Unknown axis input [%s] in XeAxisMap::get", name);
         return 0;
     }
 
-    return m_map[name];
+    return m_axes[h];
 }
 
 XeAxisInput *XeAxisMap::operator[](const char *name) const
@@ -56,75 +173,367 @@ XeAxisInput *XeAxisMap::operator[](const char *name) const
     return get(name);
 }
 
+XeAxisHandle XeAxisMap::handle(const char *name)
+{
+    QByteArray key(name);
+    int h = m_handles.value(key, -1);
+    if (h == -1)
+    {
+        h = m_axes.count();
+        m_handles[key] = h;
+        m_axes.append(0);
+        m_names.append(key);
+        ++m_revision;
+    }
+
+    return XeAxisHandle(h);
+}
+
+XeAxisInput *XeAxisMap::get(XeAxisHandle h) const
+{
+    return h.index >= 0 && h.index < m_axes.count() ? m_axes[h.index] : 0;
+}
+
+XeAxisInput *XeAxisMap::operator[](XeAxisHandle h) const
+{
+    return get(h);
+}
+
+XeAxisHandle XeAxisMap::find(const char *name) const
+{
+    return XeAxisHandle(m_handles.value(QByteArray(name), -1));
+}
+
+const char *XeAxisMap::name(XeAxisHandle h) const
+{
+    return h.index >= 0 && h.index < m_names.count() ? m_names[h.index].constData() : "";
+}
+
+int XeAxisMap::count() const
+{
+    return m_axes.count();
+}
+
+quint64 XeAxisMap::revision() const
+{
+    return m_revision;
+}
+
+XeInput::XeInput()
+        : m_buttonRevision(0), m_axisRevision(0), m_profile(0), m_profileRevision(0), m_deviceRevision(0), m_dirty(true) { }
+
 bool XeInput::isDown(const char *name) const
 {
-    XeButtonInput *button = b[name];
-    if (!button)
+    XeButtonHandle h = b.find(name);
+    if (!h.isValid())
     {
         xe_trace.warn("XeInput::isDown(): button [%s] isn't mapped", name);
         return false;
     }
 
-    return button->isDown();
+    return isDown(h);
 }
 
 bool XeInput::isUp(const char *name) const
 {
-    XeButtonInput *button = b[name];
-    if (!button)
+    XeButtonHandle h = b.find(name);
+    if (!h.isValid())
     {
         xe_trace.warn("XeInput::isUp(): button [%s] isn't mapped", name);
         return false;
     }
 
-    return button->isUp();
+    return isUp(h);
 }
 
 bool XeInput::isPressed(const char *name) const
 {
-    XeButtonInput *button = b[name];
-    if (!button)
+    XeButtonHandle h = b.find(name);
+    if (!h.isValid())
     {
         xe_trace.warn("XeInput::isPressed(): button [%s] isn't mapped", name);
         return false;
     }
 
-    return button->isPressed();
+    return isPressed(h);
 }
 
 bool XeInput::isReleased(const char *name) const
 {
-    XeButtonInput *button = b[name];
-    if (!button)
+    XeButtonHandle h = b.find(name);
+    if (!h.isValid())
     {
         xe_trace.warn("XeInput::isReleased(): button [%s] isn't mapped", name);
         return false;
     }
 
-    return button->isReleased();
+    return isReleased(h);
 }
 
 float XeInput::value(const char *name) const
 {
-    XeAxisInput *axis = a[name];
-    if (!axis)
+    XeAxisHandle h = a.find(name);
+    if (!h.isValid())
     {
         xe_trace.warn("XeInput::value(): axis [%s] isn't mapped", name);
         return 0.f;
     }
 
-    return axis->value();
+    return value(h);
 }
 
 float XeInput::value(const char *name, float min, float max) const
 {
-    XeAxisInput *axis = a[name];
-    if (!axis)
+    XeAxisHandle h = a.find(name);
+    if (!h.isValid())
     {
         xe_trace.warn("XeInput::value(): axis [%s] isn't mapped", name);
         return 0.f;
     }
 
+    return value(h, min, max);
+}
+
+bool XeInput::isDown(XeButtonHandle h) const
+{
+    XeButtonInput *button = b[h];
+    if (m_program.hasButton(h) && (isCurrent() || !button))
+        return m_program.isDown(h);
+
+    if (!button)
+    {
+        xe_trace.warn("XeInput::isDown(): button [%s] isn't mapped", b.name(h));
+        return false;
+    }
+
+    return button->isDown();
+}
+
+bool XeInput::isUp(XeButtonHandle h) const
+{
+    XeButtonInput *button = b[h];
+    if (m_program.hasButton(h) && (isCurrent() || !button))
+        return !m_program.isDown(h);
+
+    if (!button)
+    {
+        xe_trace.warn("XeInput::isUp(): button [%s] isn't mapped", b.name(h));
+        return false;
+    }
+
+    return button->isUp();
+}
+
+bool XeInput::isPressed(XeButtonHandle h) const
+{
+    XeButtonInput *button = b[h];
+    if (m_program.hasButton(h) && (isCurrent() || !button))
+        return m_program.isDown(h) && !m_program.wasDown(h);
+
+    if (!button)
+    {
+        xe_trace.warn("XeInput::isPressed(): button [%s] isn't mapped", b.name(h));
+        return false;
+    }
+
+    return button->isPressed();
+}
+
+bool XeInput::isReleased(XeButtonHandle h) const
+{
+    XeButtonInput *button = b[h];
+    if (m_program.hasButton(h) && (isCurrent() || !button))
+        return !m_program.isDown(h) && m_program.wasDown(h);
+
+    if (!button)
+    {
+        xe_trace.warn("XeInput::isReleased(): button [%s] isn't mapped", b.name(h));
+        return false;
+    }
+
+    return button->isReleased();
+}
+
+// Axes are served from the values filtered at the last update(), even once
+// the maps have changed: like the filters, new bindings take effect at the
+// next update(). Only axes mapped since then read their input directly
+float XeInput::value(XeAxisHandle h) const
+{
+    if (m_program.hasAxis(h) && h.index < m_values.count())
+        return m_values[h.index];
+
+    XeAxisInput *axis = a[h];
+    if (!axis)
+    {
+        xe_trace.warn("XeInput::value(): axis [%s] isn't mapped", a.name(h));
+        return 0.f;
+    }
+
+    return axis->value();
+}
+
+float XeInput::value(XeAxisHandle h, float min, float max) const
+{
+    if (m_program.hasAxis(h) && h.index < m_values.count())
+        return min + (max - min) * m_values[h.index];
+
+    XeAxisInput *axis = a[h];
+    if (!axis)
+    {
+        xe_trace.warn("XeInput::value(): axis [%s] isn't mapped", a.name(h));
+        return 0.f;
+    }
+
     return axis->value(min, max);
 }
 
+int XeInput::buttonEvents(const char *name, QList<XeInputEvent> &out) const
+{
+    XeButtonHandle h = b.find(name);
+    if (!h.isValid())
+    {
+        xe_trace.warn("XeInput::buttonEvents(): button [%s] isn't mapped", name);
+        return 0;
+    }
+
+    return buttonEvents(h, out);
+}
+
+// Profile bindings have no button object; a binding to a single device
+// button still has events, through the program
+int XeInput::buttonEvents(XeButtonHandle h, QList<XeInputEvent> &out) const
+{
+    const XeButtonInput *button = b[h];
+    return button_events(button ? button : leafButton(h), &out, false);
+}
+
+int XeInput::axisEvents(const char *name, QList<XeInputEvent> &out) const
+{
+    XeAxisHandle h = a.find(name);
+    if (!h.isValid())
+    {
+        xe_trace.warn("XeInput::axisEvents(): axis [%s] isn't mapped", name);
+        return 0;
+    }
+
+    return axisEvents(h, out);
+}
+
+int XeInput::axisEvents(XeAxisHandle h, QList<XeInputEvent> &out) const
+{
+    const XeAxisInput *axis = a[h];
+    return axis_events(axis ? axis : leafAxis(h), out);
+}
+
+int XeInput::presses(const char *name) const
+{
+    XeButtonHandle h = b.find(name);
+    if (!h.isValid())
+    {
+        xe_trace.warn("XeInput::presses(): button [%s] isn't mapped", name);
+        return 0;
+    }
+
+    return presses(h);
+}
+
+int XeInput::presses(XeButtonHandle h) const
+{
+    const XeButtonInput *button = b[h];
+    return button_events(button ? button : leafButton(h), 0, true);
+}
+
+// Queries are served from the program only while it matches the maps; if
+// they change mid-tick, queries evaluate the inputs directly until the next
+// update() recompiles it
+bool XeInput::isCurrent() const
+{
+    return !m_dirty && m_program.isCompiled() && devicesCurrent() &&
+           m_buttonRevision == b.revision() && m_axisRevision == a.revision();
+}
+
+// Profile bindings look up device inputs when they are compiled, so devices
+// attached or detached since then need a recompile
+bool XeInput::devicesCurrent() const
+{
+    return !xe_kernel || m_deviceRevision == xe_kernel->deviceRevision();
+}
+
+// The program's leaf inputs may belong to a device that has been detached
+// since it was compiled
+const XeButtonInput *XeInput::leafButton(XeButtonHandle h) const
+{
+    return devicesCurrent() ? m_program.leafButton(h) : 0;
+}
+
+const XeAxisInput *XeInput::leafAxis(XeAxisHandle h) const
+{
+    return devicesCurrent() ? m_program.leafAxis(h) : 0;
+}
+
+void XeInput::update(float dt)
+{
+    // The old program keeps serving queries until the new profile is
+    // compiled here, so a reload never shows a half-applied profile
+    if (m_profile && m_profile->revision() != m_profileRevision)
+    {
+        resolveProfile();
+        m_profileRevision = m_profile->revision();
+        m_dirty = true;
+    }
+
+    if (!isCurrent())
+    {
+        m_program.compile(b, a, m_profile);
+        m_buttonRevision = b.revision();
+        m_axisRevision = a.revision();
+        m_deviceRevision = xe_kernel ? xe_kernel->deviceRevision() : 0;
+        m_dirty = false;
+    }
+
+    m_program.run();
+
+    // Filters run once over all axes, so queries are plain reads
+    int n = a.count();
+    m_values.resize(n);
+    for (int i = 0; i < n; ++i)
+        m_values[i] = m_program.value(XeAxisHandle(i));
+
+    filters.run(m_values.data(), n, dt);
+}
+
+void XeInput::setProfile(XeBindingProfile *profile)
+{
+    m_profile = profile;
+    m_profileRevision = profile ? profile->revision() : 0;
+    m_dirty = true;
+
+    if (m_profile)
+        resolveProfile();
+}
+
+XeBindingProfile *XeInput::profile() const
+{
+    return m_profile;
+}
+
+// Gives every name the profile binds a handle, so it can be queried like a
+// mapped name
+void XeInput::resolveProfile()
+{
+    foreach (const XeBindingProfile::Binding &binding, m_profile->buttons())
+        b.handle(binding.name);
+
+    foreach (const XeBindingProfile::Binding &binding, m_profile->axes())
+        a.handle(binding.name);
+}
+
+void XeInput::recompile()
+{
+    m_dirty = true;
+}
+
+const XeInputProgram &XeInput::program() const
+{
+    return m_program;
+}
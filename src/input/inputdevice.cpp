@@ -6,3 +6,12 @@ bool XeInputDevice::hasInput(const char *id) const
     return hasAxis(id) || hasButton(id);
 }
 
+const XeInputEventQueue &XeInputDevice::events() const
+{
+    return m_events;
+}
+
+int XeInputDevice::observe(qint64 when)
+{
+    return m_events.observe(when);
+}
@@ -0,0 +1,89 @@
+
+#include "xe/inputevent.h"
+#include "xe/trace.h"
+
+#include <QElapsedTimer>
+
+XeInputEvent::XeInputEvent() : type(PRESS), button(0), axis(0), value(0.f), time(0), observed(0) { }
+
+XeInputEventQueue::XeInputEventQueue() : m_head(0), m_count(0), m_observed(0), m_dropped(0), m_start(now()) { }
+
+qint64 XeInputEventQueue::now()
+{
+    // All queues share one clock, so events from different devices can be
+    // ordered against each other
+    static QElapsedTimer clock;
+    static bool started = (clock.start(), true);
+    (void)started;
+
+    return clock.nsecsElapsed();
+}
+
+qint64 XeInputEventQueue::start() const
+{
+    return m_start;
+}
+
+int XeInputEventQueue::count() const
+{
+    return m_count;
+}
+
+const XeInputEvent &XeInputEventQueue::operator[](int i) const
+{
+    xe_assert(i >= 0 && i < m_count, "XeInputEventQueue: event index out of range");
+    return m_ring[(m_head + i) % CAPACITY];
+}
+
+quint64 XeInputEventQueue::dropped() const
+{
+    return m_dropped;
+}
+
+void XeInputEventQueue::push(XeInputEvent::Type type, const XeButtonInput *button, const XeAxisInput *axis,
+                             float value, qint64 time)
+{
+    int at;
+    if (m_count == CAPACITY)
+    {
+        // Overwrite the oldest event
+        at = m_head;
+        m_head = (m_head + 1) % CAPACITY;
+        ++m_dropped;
+
+        if (m_observed > 0)
+            --m_observed;
+    }
+    else
+    {
+        at = (m_head + m_count++) % CAPACITY;
+    }
+
+    XeInputEvent &ev = m_ring[at];
+    ev.type = type;
+    ev.button = button;
+    ev.axis = axis;
+    ev.value = value;
+    ev.time = time < 0 ? now() : time;
+    ev.observed = 0;
+}
+
+int XeInputEventQueue::observe(qint64 when)
+{
+    // Events are observed in order, so the unobserved ones are always at the
+    // end of the queue
+    int n = m_count - m_observed;
+    for (int i = m_observed; i < m_count; ++i)
+        m_ring[(m_head + i) % CAPACITY].observed = when;
+
+    m_observed = m_count;
+    return n;
+}
+
+void XeInputEventQueue::clear()
+{
+    m_head = 0;
+    m_count = 0;
+    m_observed = 0;
+    m_start = now();
+}
@@ -0,0 +1,93 @@
+
+#include "xe/inputlatency.h"
+#include "xe/kernel.h"
+
+XeInputLatency::XeInputLatency(XeMetrics *metrics, int frames)
+        : m_metrics(metrics), m_eventsMetric(-1), m_p50Metric(-1), m_p99Metric(-1), m_maxMetric(-1),
+          m_frames(frames > 0 ? frames : 1), m_frame(0)
+{
+    if (m_metrics)
+    {
+        m_eventsMetric = m_metrics->counter("input events");
+        m_p50Metric = m_metrics->gauge("input latency p50 (us)");
+        m_p99Metric = m_metrics->gauge("input latency p99 (us)");
+        m_maxMetric = m_metrics->gauge("input latency max (us)");
+    }
+}
+
+int XeInputLatency::frames() const
+{
+    return m_frames;
+}
+
+void XeInputLatency::setFrames(int frames)
+{
+    m_frames = frames > 0 ? frames : 1;
+}
+
+const XeHistogram &XeInputLatency::window() const
+{
+    return m_window;
+}
+
+const XeHistogram &XeInputLatency::total() const
+{
+    return m_total;
+}
+
+void XeInputLatency::reset()
+{
+    m_current.clear();
+    m_window.clear();
+    m_total.clear();
+    m_frame = 0;
+}
+
+void XeInputLatency::update(float)
+{
+    if (!xe_kernel)
+        return;
+
+    // One timestamp for the whole tick: game code sees all the events at once
+    qint64 now = XeInputEventQueue::now();
+
+    m_devices.clear();
+    xe_kernel->devices(m_devices);
+
+    int total = 0;
+    foreach (XeInputDevice *device, m_devices)
+    {
+        int n = device->observe(now);
+        const XeInputEventQueue &events = device->events();
+        for (int i = events.count() - n; i < events.count(); ++i)
+            m_current.add(now - events[i].time);
+
+        total += n;
+    }
+
+    if (m_metrics && total)
+        m_metrics->add(m_eventsMetric, total);
+
+    if (++m_frame >= m_frames)
+        publish();
+}
+
+void XeInputLatency::publish()
+{
+    m_window = m_current;
+    m_total.merge(m_current);
+    m_current.clear();
+    m_frame = 0;
+
+    if (m_metrics)
+    {
+        m_metrics->set(m_p50Metric, m_window.percentile(.5f) / 1000);
+        m_metrics->set(m_p99Metric, m_window.percentile(.99f) / 1000);
+        m_metrics->set(m_maxMetric, m_window.max() / 1000);
+    }
+}
+
+void XeInputLatency::log() const
+{
+    m_total.log("XeInputLatency");
+}
@@ -0,0 +1,444 @@
+
+#include "xe/andbutton.h"
+#include "xe/axisbutton.h"
+#include "xe/bindingprofile.h"
+#include "xe/buttonaxis.h"
+#include "xe/input.h"
+#include "xe/inputprogram.h"
+#include "xe/kernel.h"
+#include "xe/notbutton.h"
+#include "xe/orbutton.h"
+#include "xe/trace.h"
+
+XeInputProgram::XeInputProgram() : m_compiled(false) { }
+
+int XeInputProgram::allocate()
+{
+    m_state.append(0.f);
+    return m_state.count() - 1;
+}
+
+int XeInputProgram::compileButton(const XeButtonInput *b)
+{
+    if (!b)
+        return -1;
+    if (m_regs.contains(b))
+        return m_regs[b];
+
+    if (m_visiting.contains(b))
+    {
+        xe_trace.error << QString("XeInputProgram: %1 contains itself; it will never be down").arg(b->id());
+        return -1;
+    }
+    m_visiting[b] = true;
+
+    // Children are compiled first, so their operations come earlier in the
+    // program than the operations that read them
+    Op op;
+    op.code = LOAD_BUTTON;
+    op.first = op.count = 0;
+    op.min = op.max = 0.f;
+    op.button = b;
+    op.axis = 0;
+
+    if (const XeAndButton *and_ = dynamic_cast<const XeAndButton*>(b))
+    {
+        QVector<int> children;
+        foreach (XeButtonInput *child, and_->children())
+            children.append(compileButton(child));
+
+        op.code = AND;
+        op.first = m_operands.count();
+        op.count = children.count();
+        foreach (int r, children)
+        {
+            Operand o = { r, 0.f, 0.f };
+            m_operands.append(o);
+        }
+    }
+    else if (const XeOrButton *or_ = dynamic_cast<const XeOrButton*>(b))
+    {
+        QVector<int> children;
+        foreach (XeButtonInput *child, or_->children())
+            children.append(compileButton(child));
+
+        op.code = OR;
+        op.first = m_operands.count();
+        op.count = children.count();
+        foreach (int r, children)
+        {
+            Operand o = { r, 0.f, 0.f };
+            m_operands.append(o);
+        }
+    }
+    else if (const XeNotButton *not_ = dynamic_cast<const XeNotButton*>(b))
+    {
+        op.code = NOT;
+        op.first = compileButton(not_->child());
+    }
+    else if (const XeAxisButton *axis = dynamic_cast<const XeAxisButton*>(b))
+    {
+        // Without an axis (or one in a cycle) it is never down
+        op.code = AXIS_BUTTON;
+        op.first = compileAxis(axis->child());
+        op.min = axis->activationRange().min;
+        op.max = axis->activationRange().max;
+        if (op.first < 0)
+            op.code = ZERO;
+    }
+
+    m_visiting.remove(b);
+
+    op.dst = allocate();
+    m_regs[b] = op.dst;
+    m_ops.append(op);
+
+    return op.dst;
+}
+
+int XeInputProgram::compileAxis(const XeAxisInput *a)
+{
+    if (!a)
+        return -1;
+    if (m_regs.contains(a))
+        return m_regs[a];
+
+    if (m_visiting.contains(a))
+    {
+        xe_trace.error << QString("XeInputProgram: %1 contains itself; its value will be 0").arg(a->id());
+        return -1;
+    }
+    m_visiting[a] = true;
+
+    Op op;
+    op.code = LOAD_AXIS;
+    op.first = op.count = 0;
+    op.min = op.max = 0.f;
+    op.button = 0;
+    op.axis = a;
+
+    if (const XeButtonAxis *axis = dynamic_cast<const XeButtonAxis*>(a))
+    {
+        QVector<Operand> children;
+        foreach (const XeButtonAxis::ButtonValue &bv, axis->buttons())
+        {
+            Operand o = { compileButton(bv.button), bv.upval, bv.downval };
+            children.append(o);
+        }
+
+        op.code = BUTTON_AXIS;
+        op.first = m_operands.count();
+        op.count = children.count();
+        m_operands += children;
+    }
+
+    m_visiting.remove(a);
+
+    op.dst = allocate();
+    m_regs[a] = op.dst;
+    m_ops.append(op);
+
+    return op.dst;
+}
+
+// A button bound on its own as an axis: 1 while down, 0 otherwise
+int XeInputProgram::compileButtonAsAxis(const XeButtonInput *b)
+{
+    Operand o = { compileButton(b), 0.f, 1.f };
+
+    Op op;
+    op.code = BUTTON_AXIS;
+    op.first = m_operands.count();
+    op.count = 1;
+    op.min = op.max = 0.f;
+    op.button = 0;
+    op.axis = 0;
+    m_operands.append(o);
+
+    op.dst = allocate();
+    m_ops.append(op);
+    return op.dst;
+}
+
+void XeInputProgram::compileProfile(const XeBindingProfile &profile, QVector<int> &nodeRegs)
+{
+    const QVector<XeBindingProfile::Node> &nodes = profile.nodes();
+    const QVector<XeBindingProfile::Operand> &operands = profile.operands();
+    nodeRegs.resize(nodes.count());
+
+    // Nodes only refer to earlier nodes, so a single pass in order compiles
+    // each node after its operands
+    for (int i = 0; i < nodes.count(); ++i)
+    {
+        const XeBindingProfile::Node &n = nodes[i];
+
+        if (n.type == XeBindingProfile::BUTTON || n.type == XeBindingProfile::AXIS)
+        {
+            XeInputDevice *device = xe_kernel ? xe_kernel->device(n.device) : 0;
+            XeButtonInput *button = device ? device->button(n.input) : 0;
+            XeAxisInput *axis = device ? device->axis(n.input) : 0;
+            int reg = -1;
+
+            if (n.type == XeBindingProfile::BUTTON && button)
+                reg = compileButton(button);
+            else if (n.type == XeBindingProfile::AXIS && axis)
+                reg = compileAxis(axis);
+            else if (n.type == XeBindingProfile::AXIS && button)
+                reg = compileButtonAsAxis(button);
+            else if (axis)
+                xe_trace.error << QString("XeInputProgram: profile uses axis %1.%2 as a button; "
+                                          "give it a range, e.g. %1.%2[0.5, 1]").arg(n.device).arg(n.input);
+            else
+                xe_trace.warn << QString("XeInputProgram: profile refers to unknown input %1.%2")
+                                 .arg(n.device).arg(n.input);
+
+            nodeRegs[i] = qMax(reg, 0);
+            continue;
+        }
+
+        Op op;
+        op.first = op.count = 0;
+        op.min = op.max = 0.f;
+        op.button = 0;
+        op.axis = 0;
+
+        switch (n.type)
+        {
+        case XeBindingProfile::AND:
+        case XeBindingProfile::OR:
+            op.code = n.type == XeBindingProfile::AND ? AND : OR;
+            op.first = m_operands.count();
+            op.count = n.count;
+            for (int j = n.first; j < n.first + n.count; ++j)
+            {
+                Operand o = { nodeRegs[operands[j].node], 0.f, 0.f };
+                m_operands.append(o);
+            }
+            break;
+
+        case XeBindingProfile::NOT:
+            op.code = NOT;
+            op.first = nodeRegs[n.first];
+            break;
+
+        case XeBindingProfile::AXIS_BUTTON:
+            op.code = AXIS_BUTTON;
+            op.first = nodeRegs[n.first];
+            op.min = n.min;
+            op.max = n.max;
+            break;
+
+        default:
+            op.code = BUTTON_AXIS;
+            op.first = m_operands.count();
+            op.count = n.count;
+            for (int j = n.first; j < n.first + n.count; ++j)
+            {
+                Operand o = { nodeRegs[operands[j].node], 0.f, operands[j].weight };
+                m_operands.append(o);
+            }
+            break;
+        }
+
+        op.dst = allocate();
+        m_ops.append(op);
+        nodeRegs[i] = op.dst;
+    }
+}
+
+void XeInputProgram::compile(const XeButtonMap &buttons, const XeAxisMap &axes, const XeBindingProfile *profile)
+{
+    // clear() zeroes the state, which would make every held button read as
+    // pressed at the next run(); remember which handles were down
+    QVector<bool> wasDown(m_buttonRegs.count());
+    for (int i = 0; i < m_buttonRegs.count(); ++i)
+        wasDown[i] = isDown(XeButtonHandle(i));
+
+    clear();
+
+    // Register 0 always reads as zero; failed and missing inputs point at it
+    Op zero;
+    zero.code = ZERO;
+    zero.dst = allocate();
+    zero.first = zero.count = 0;
+    zero.min = zero.max = 0.f;
+    zero.button = 0;
+    zero.axis = 0;
+    m_ops.append(zero);
+
+    QVector<int> nodeRegs;
+    if (profile)
+        compileProfile(*profile, nodeRegs);
+
+    // Unmapped handles get no register; mapped inputs that fail to compile
+    // read register 0
+    for (int i = 0; i < buttons.count(); ++i)
+    {
+        XeButtonHandle h(i);
+        int binding = profile ? profile->findButton(buttons.name(h)) : -1;
+        if (binding != -1)
+            m_buttonRegs.append(nodeRegs[profile->buttons()[binding].node]);
+        else
+            m_buttonRegs.append(buttons.get(h) ? qMax(compileButton(buttons.get(h)), 0) : -1);
+    }
+
+    for (int i = 0; i < axes.count(); ++i)
+    {
+        XeAxisHandle h(i);
+        int binding = profile ? profile->findAxis(axes.name(h)) : -1;
+        if (binding != -1)
+            m_axisRegs.append(nodeRegs[profile->axes()[binding].node]);
+        else
+            m_axisRegs.append(axes.get(h) ? qMax(compileAxis(axes.get(h)), 0) : -1);
+    }
+
+    // Inputs that failed to compile (cycles) also read register 0
+    for (int i = 0; i < m_ops.count(); ++i)
+    {
+        if (m_ops[i].code == NOT || m_ops[i].code == AXIS_BUTTON)
+            m_ops[i].first = qMax(m_ops[i].first, 0);
+    }
+    for (int i = 0; i < m_operands.count(); ++i)
+        m_operands[i].reg = qMax(m_operands[i].reg, 0);
+
+    // Handles that were down stay down, whether their binding changed or not
+    for (int i = 0; i < wasDown.count() && i < m_buttonRegs.count(); ++i)
+        if (wasDown[i] && m_buttonRegs[i] > 0)
+            m_state[m_buttonRegs[i]] = 1.f;
+
+    m_prevState = m_state;
+    m_regs.clear();
+    m_visiting.clear();
+    m_compiled = true;
+}
+
+void XeInputProgram::clear()
+{
+    m_ops.clear();
+    m_operands.clear();
+    m_state.clear();
+    m_prevState.clear();
+    m_buttonRegs.clear();
+    m_axisRegs.clear();
+    m_compiled = false;
+}
+
+bool XeInputProgram::isCompiled() const
+{
+    return m_compiled;
+}
+
+int XeInputProgram::size() const
+{
+    return m_ops.count();
+}
+
+void XeInputProgram::run()
+{
+    m_prevState = m_state;
+
+    float *state = m_state.data();
+    const Operand *operands = m_operands.constData();
+    const Op *ops = m_ops.constData();
+    int n = m_ops.count();
+
+    for (int i = 0; i < n; ++i)
+    {
+        const Op &op = ops[i];
+        float v = 0.f;
+
+        switch (op.code)
+        {
+        case LOAD_BUTTON:
+            v = op.button->isDown() ? 1.f : 0.f;
+            break;
+
+        case LOAD_AXIS:
+            v = op.axis->value();
+            break;
+
+        case AND:
+            v = 1.f;
+            for (int j = op.first; j < op.first + op.count; ++j)
+                if (state[operands[j].reg] == 0.f)
+                {
+                    v = 0.f;
+                    break;
+                }
+            break;
+
+        case OR:
+            for (int j = op.first; j < op.first + op.count; ++j)
+                if (state[operands[j].reg] != 0.f)
+                {
+                    v = 1.f;
+                    break;
+                }
+            break;
+
+        case NOT:
+            // Like XeNotButton, a NOT without a child is never down
+            v = op.first != 0 && state[op.first] == 0.f ? 1.f : 0.f;
+            break;
+
+        case AXIS_BUTTON:
+            // A missing axis reads register 0, and must not count as down
+            // just because the range contains 0
+            v = op.first != 0 && op.min <= state[op.first] && state[op.first] <= op.max ? 1.f : 0.f;
+            break;
+
+        case BUTTON_AXIS:
+            for (int j = op.first; j < op.first + op.count; ++j)
+                v += state[operands[j].reg] != 0.f ? operands[j].down : operands[j].up;
+            break;
+
+        case ZERO:
+            break;
+        }
+
+        state[op.dst] = v;
+    }
+}
+
+bool XeInputProgram::isDown(XeButtonHandle h) const
+{
+    return hasButton(h) && m_state[m_buttonRegs[h.index]] != 0.f;
+}
+
+bool XeInputProgram::wasDown(XeButtonHandle h) const
+{
+    return hasButton(h) && m_prevState[m_buttonRegs[h.index]] != 0.f;
+}
+
+float XeInputProgram::value(XeAxisHandle h) const
+{
+    return hasAxis(h) ? m_state[m_axisRegs[h.index]] : 0.f;
+}
+
+bool XeInputProgram::hasButton(XeButtonHandle h) const
+{
+    return h.index >= 0 && h.index < m_buttonRegs.count() && m_buttonRegs[h.index] >= 0;
+}
+
+bool XeInputProgram::hasAxis(XeAxisHandle h) const
+{
+    return h.index >= 0 && h.index < m_axisRegs.count() && m_axisRegs[h.index] >= 0;
+}
+
+const XeButtonInput *XeInputProgram::leafButton(XeButtonHandle h) const
+{
+    if (!hasButton(h))
+        return 0;
+
+    const Op &op = m_ops[m_buttonRegs[h.index]];
+    return op.code == LOAD_BUTTON ? op.button : 0;
+}
+
+const XeAxisInput *XeInputProgram::leafAxis(XeAxisHandle h) const
+{
+    if (!hasAxis(h))
+        return 0;
+
+    const Op &op = m_ops[m_axisRegs[h.index]];
+    return op.code == LOAD_AXIS ? op.axis : 0;
+}
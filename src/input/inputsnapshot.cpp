@@ -0,0 +1,259 @@
+
+#include "xe/inputsnapshot.h"
+#include "xe/kernel.h"
+
+#include <QMutexLocker>
+
+#include <cstring>
+
+enum
+{
+    MAPPED_DOWN = 1,
+    MAPPED_PRESSED = 2,
+    MAPPED_RELEASED = 4,
+};
+
+class XeInputSnapshotData : public QSharedData
+{
+public:
+    XeInputSnapshotData() : tick(0), dt(0.f) { }
+
+    quint64 tick;
+    float dt;
+    QVector<XeInputSnapshot::Button> buttons;
+    QVector<XeInputSnapshot::Axis> axes;
+    /** MAPPED_* flags per XeButtonHandle index */
+    QVector<quint8> mappedButtons;
+    /** Values per XeAxisHandle index */
+    QVector<float> mappedAxes;
+};
+
+// Shared by all default-constructed snapshots, so they never need a null
+// check. It holds a reference to itself so the last snapshot to let go of
+// it never deletes it
+class XeEmptySnapshotData : public XeInputSnapshotData
+{
+public:
+    XeEmptySnapshotData() { ref.ref(); }
+};
+
+static XeInputSnapshotData *empty_data()
+{
+    // Initialized once, even if snapshots are first made on several threads
+    static XeEmptySnapshotData empty;
+    return &empty;
+}
+
+XeInputSnapshot::XeInputSnapshot() : d(empty_data()) { }
+
+XeInputSnapshot::XeInputSnapshot(XeInputSnapshotData *data) : d(data) { }
+
+XeInputSnapshot::XeInputSnapshot(const XeInputSnapshot &other) : d(other.d) { }
+
+XeInputSnapshot::~XeInputSnapshot() { }
+
+XeInputSnapshot &XeInputSnapshot::operator=(const XeInputSnapshot &other)
+{
+    d = other.d;
+    return *this;
+}
+
+quint64 XeInputSnapshot::tick() const
+{
+    return d->tick;
+}
+
+float XeInputSnapshot::dt() const
+{
+    return d->dt;
+}
+
+int XeInputSnapshot::buttonCount() const
+{
+    return d->buttons.count();
+}
+
+const XeInputSnapshot::Button &XeInputSnapshot::button(int i) const
+{
+    return d->buttons[i];
+}
+
+int XeInputSnapshot::axisCount() const
+{
+    return d->axes.count();
+}
+
+const XeInputSnapshot::Axis &XeInputSnapshot::axis(int i) const
+{
+    return d->axes[i];
+}
+
+int XeInputSnapshot::findButton(const char *deviceID, const char *id) const
+{
+    for (int i = 0; i < d->buttons.count(); ++i)
+    {
+        const Button &b = d->buttons[i];
+        if (!strcmp(b.id, id) && !strcmp(b.deviceID, deviceID))
+            return i;
+    }
+
+    return -1;
+}
+
+int XeInputSnapshot::findAxis(const char *deviceID, const char *id) const
+{
+    for (int i = 0; i < d->axes.count(); ++i)
+    {
+        const Axis &a = d->axes[i];
+        if (!strcmp(a.id, id) && !strcmp(a.deviceID, deviceID))
+            return i;
+    }
+
+    return -1;
+}
+
+bool XeInputSnapshot::isDown(XeButtonHandle button) const
+{
+    return button.index >= 0 && button.index < d->mappedButtons.count() && (d->mappedButtons[button.index] & MAPPED_DOWN);
+}
+
+bool XeInputSnapshot::isUp(XeButtonHandle button) const
+{
+    return !isDown(button);
+}
+
+bool XeInputSnapshot::isPressed(XeButtonHandle button) const
+{
+    return button.index >= 0 && button.index < d->mappedButtons.count() && (d->mappedButtons[button.index] & MAPPED_PRESSED);
+}
+
+bool XeInputSnapshot::isReleased(XeButtonHandle button) const
+{
+    return button.index >= 0 && button.index < d->mappedButtons.count() && (d->mappedButtons[button.index] & MAPPED_RELEASED);
+}
+
+float XeInputSnapshot::value(XeAxisHandle axis) const
+{
+    return axis.index >= 0 && axis.index < d->mappedAxes.count() ? d->mappedAxes[axis.index] : 0.f;
+}
+
+XeInputPublisher::XeInputPublisher(XeInput *input) : m_input(input), m_tick(0) { }
+
+XeInputPublisher::~XeInputPublisher()
+{
+    // Buffers still held by readers are freed when the last of them lets go
+    foreach (XeInputSnapshotData *data, m_pool)
+        if (!data->ref.deref())
+            delete data;
+}
+
+XeInputSnapshot XeInputPublisher::latest() const
+{
+    QMutexLocker lock(&m_lock);
+    return m_latest;
+}
+
+int XeInputPublisher::poolSize() const
+{
+    return m_pool.count();
+}
+
+XeInputSnapshotData *XeInputPublisher::acquire()
+{
+    // The pool holds one reference to each buffer; a buffer nobody else
+    // holds can't be reached by any reader, and can be refilled. The acquire
+    // pairs with the release of a reader's last deref, so its reads of the
+    // buffer are done before it is written again
+    foreach (XeInputSnapshotData *data, m_pool)
+        if (data->ref.loadAcquire() == 1)
+            return data;
+
+    XeInputSnapshotData *data = new XeInputSnapshotData();
+    data->ref.ref();
+    m_pool.append(data);
+
+    return data;
+}
+
+void XeInputPublisher::update(float dt)
+{
+    XeInputSnapshotData *data = acquire();
+
+    data->tick = ++m_tick;
+    data->dt = dt;
+    data->buttons.clear();
+    data->axes.clear();
+    data->mappedButtons.clear();
+    data->mappedAxes.clear();
+
+    if (xe_kernel)
+    {
+        m_devices.clear();
+        xe_kernel->devices(m_devices);
+
+        foreach (XeInputDevice *device, m_devices)
+        {
+            m_ids.clear();
+            device->buttons(m_ids);
+            foreach (const char *id, m_ids)
+            {
+                XeButtonInput *input = device->button(id);
+                if (!input)
+                    continue;
+
+                XeInputSnapshot::Button b;
+                b.deviceID = device->id();
+                b.id = input->id();
+                b.down = input->isDown();
+                b.pressed = input->isPressed();
+                b.released = input->isReleased();
+                data->buttons.append(b);
+            }
+
+            m_ids.clear();
+            device->axes(m_ids);
+            foreach (const char *id, m_ids)
+            {
+                XeAxisInput *input = device->axis(id);
+                if (!input)
+                    continue;
+
+                XeInputSnapshot::Axis a;
+                a.deviceID = device->id();
+                a.id = input->id();
+                a.value = input->value();
+                data->axes.append(a);
+            }
+        }
+    }
+
+    if (m_input)
+    {
+        // Served from the input program when it is current, so this doesn't
+        // evaluate composite inputs again
+        int buttons = m_input->b.count();
+        data->mappedButtons.resize(buttons);
+        for (int i = 0; i < buttons; ++i)
+        {
+            XeButtonHandle h(i);
+            quint8 flags = 0;
+            if (m_input->isDown(h))
+                flags |= MAPPED_DOWN;
+            if (m_input->isPressed(h))
+                flags |= MAPPED_PRESSED;
+            if (m_input->isReleased(h))
+                flags |= MAPPED_RELEASED;
+            data->mappedButtons[i] = flags;
+        }
+
+        int axes = m_input->a.count();
+        data->mappedAxes.resize(axes);
+        for (int i = 0; i < axes; ++i)
+            data->mappedAxes[i] = m_input->value(XeAxisHandle(i));
+    }
+
+    XeInputSnapshot snapshot(data);
+
+    QMutexLocker lock(&m_lock);
+    m_latest = snapshot;
+}
@@ -1,12 +1,9 @@
 
 #include "xe/notbutton.h"
 
-XeNotButton::XeNotButton() : m_child(0) { }
+XeNotButton::XeNotButton() : m_child(0), m_named(false) { }
 
-XeNotButton::XeNotButton(XeButtonInput *child) : m_child(child) 
-{ 
-    setChild(child); // generate m_id/m_name 
-}
+XeNotButton::XeNotButton(XeButtonInput *child) : m_child(child), m_named(false) { }
 
 XeButtonInput *XeNotButton::child() const
 {
@@ -16,26 +13,21 @@ XeButtonInput *XeNotButton::child() const
 void XeNotButton::setChild(XeButtonInput *child)
 {
     m_child = child;
-    if (child)
-    {
-        m_id = QString("not-") + child->id();
-        m_name = QString("Not (") + child->name() + ")";
-    }
-    else
-    {
-        m_id = "not-<nil>";
-        m_name = "<nil>";
-    }
+    m_named = false;
 }
 
 const char *XeNotButton::id() const
 {
-    return m_id.toUtf8().data();
+    if (!m_named)
+        rename();
+    return m_id.constData();
 }
 
 const char *XeNotButton::name() const
 {
-    return m_name.toUtf8().data();
+    if (!m_named)
+        rename();
+    return m_name.constData();
 }
 
 const char *XeNotButton::deviceID() const
@@ -48,3 +40,21 @@ bool XeNotButton::isDown() const
     return m_child && !m_child->isDown();
 }
 
+void XeNotButton::rename() const
+{
+    if (m_child)
+    {
+        m_id = "not-";
+        m_id += m_child->id();
+        m_name = "Not (";
+        m_name += m_child->name();
+        m_name += ')';
+    }
+    else
+    {
+        m_id = "not-<nil>";
+        m_name = "<nil>";
+    }
+
+    m_named = true;
+}
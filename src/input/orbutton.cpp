@@ -1,16 +1,18 @@
 
 #include "xe/orbutton.h"
 
+XeOrButton::XeOrButton() : m_named(false) { }
+
 void XeOrButton::attach(XeButtonInput *b)
 {
     m_children.append(b);
-    rename();
+    m_named = false;
 }
 
 void XeOrButton::detach(XeButtonInput *b)
 {
     m_children.removeOne(b);
-    rename();
+    m_named = false;
 }
 
 bool XeOrButton::isAttached(XeButtonInput *b) const
@@ -18,6 +20,11 @@ bool XeOrButton::isAttached(XeButtonInput *b) const
     return m_children.contains(b);
 }
 
+const QList<XeButtonInput *> &XeOrButton::children() const
+{
+    return m_children;
+}
+
 bool XeOrButton::isDown() const
 {
     foreach (XeButtonInput *b, m_children)
@@ -29,12 +36,16 @@ bool XeOrButton::isDown() const
 
 const char *XeOrButton::id() const
 {
-    return m_id.toUtf8().data();
+    if (!m_named)
+        rename();
+    return m_id.constData();
 }
 
 const char *XeOrButton::name() const
 {
-    return m_name.toUtf8().data();
+    if (!m_named)
+        rename();
+    return m_name.constData();
 }
 
 const char *XeOrButton::deviceID() const
@@ -42,20 +53,24 @@ const char *XeOrButton::deviceID() const
     return "anonymous";
 }
 
-void XeOrButton::rename()
+void XeOrButton::rename() const
 {
     m_id = "or";
-    m_name = "";
+    m_name.clear();
 
     for (int i = 0; i < m_children.count(); ++i)
     {
         XeButtonInput *b = m_children[i];
-        
-        m_id += QString("-") + b->id();
 
-        if (i > 0) 
+        m_id += '-';
+        m_id += b->id();
+
+        if (i > 0)
             m_name += " or ";
-        m_name += QString("(") + b->name() + ")";
+        m_name += '(';
+        m_name += b->name();
+        m_name += ')';
     }
-}
 
+    m_named = true;
+}
@@ -0,0 +1,284 @@
+
+#include "xe/strings.h"
+#include "xe/syntheticdevice.h"
+#include "xe/trace.h"
+
+class XeSyntheticDevice::Button : public XeButtonInput
+{
+public:
+    virtual ~Button() { }
+
+    const char *id() const { return m_id; }
+    const char *name() const { return m_name; }
+    const char *deviceID() const { return m_deviceID; }
+
+    bool isDown() const { return down; }
+
+    const char *m_id;
+    const char *m_name;
+    const char *m_deviceID;
+    int index;
+    bool down;
+};
+
+class XeSyntheticDevice::Axis : public XeAxisInput
+{
+public:
+    virtual ~Axis() { }
+
+    const char *id() const { return m_id; }
+    const char *name() const { return m_name; }
+    const char *deviceID() const { return m_deviceID; }
+
+    float value() const { return axisValue; }
+
+    const char *m_id;
+    const char *m_name;
+    const char *m_deviceID;
+    int index;
+    float axisValue;
+    bool relative;
+};
+
+XeSyntheticDevice::XeSyntheticDevice(const char *id, const char *name)
+        : m_id(id), m_name(name ? name : id)
+{ }
+
+XeSyntheticDevice::~XeSyntheticDevice()
+{
+    foreach (Button *b, m_buttons)
+        delete b;
+    foreach (Axis *a, m_axes)
+        delete a;
+}
+
+XeButtonInput *XeSyntheticDevice::addButton(const char *id, const char *name)
+{
+    Button *b = findButton(id);
+    if (b)
+        return b;
+
+    b = new Button();
+    b->m_id = xe_strings.intern(id);
+    b->m_name = xe_strings.intern(name ? name : id);
+    b->m_deviceID = m_id.constData();
+    b->index = m_buttons.count();
+    b->down = false;
+
+    m_buttonIndex[QByteArray(b->m_id)] = b->index;
+    m_buttons.append(b);
+
+    return b;
+}
+
+XeAxisInput *XeSyntheticDevice::addAxis(const char *id, const char *name, bool relative)
+{
+    Axis *a = findAxis(id);
+    if (a)
+        return a;
+
+    a = new Axis();
+    a->m_id = xe_strings.intern(id);
+    a->m_name = xe_strings.intern(name ? name : id);
+    a->m_deviceID = m_id.constData();
+    a->index = m_axes.count();
+    a->axisValue = 0.f;
+    a->relative = relative;
+
+    m_axisIndex[QByteArray(a->m_id)] = a->index;
+    m_axes.append(a);
+
+    return a;
+}
+
+XeSyntheticDevice::Button *XeSyntheticDevice::findButton(const char *id) const
+{
+    int i = m_buttonIndex.value(QByteArray::fromRawData(id, qstrlen(id)), -1);
+    return i == -1 ? 0 : m_buttons[i];
+}
+
+XeSyntheticDevice::Button *XeSyntheticDevice::findButton(XeButtonInput *input) const
+{
+    // Only buttons of this device share its interned ID pointer; the index
+    // check rules out other devices registered under the same ID
+    if (!input || input->deviceID() != m_id.constData())
+        return 0;
+
+    Button *b = static_cast<Button*>(input);
+    return b->index < m_buttons.count() && m_buttons[b->index] == b ? b : 0;
+}
+
+XeSyntheticDevice::Axis *XeSyntheticDevice::findAxis(const char *id) const
+{
+    int i = m_axisIndex.value(QByteArray::fromRawData(id, qstrlen(id)), -1);
+    return i == -1 ? 0 : m_axes[i];
+}
+
+XeSyntheticDevice::Axis *XeSyntheticDevice::findAxis(XeAxisInput *input) const
+{
+    if (!input || input->deviceID() != m_id.constData())
+        return 0;
+
+    Axis *a = static_cast<Axis*>(input);
+    return a->index < m_axes.count() && m_axes[a->index] == a ? a : 0;
+}
+
+void XeSyntheticDevice::setDown(const char *id, bool down)
+{
+    Button *b = findButton(id);
+    if (!b)
+    {
+        xe_trace.warn << QString("XeSyntheticDevice %1: no button %2").arg(m_id.constData()).arg(id);
+        return;
+    }
+
+    setDown(b, down);
+}
+
+void XeSyntheticDevice::setDown(XeButtonInput *input, bool down)
+{
+    Button *b = findButton(input);
+    if (!b)
+    {
+        xe_trace.warn << QString("XeSyntheticDevice %1: button doesn't belong to this device").arg(m_id.constData());
+        return;
+    }
+
+    if (b->down == down)
+        return;
+
+    b->down = down;
+    m_events.push(down ? XeInputEvent::PRESS : XeInputEvent::RELEASE, b);
+}
+
+void XeSyntheticDevice::press(const char *id)
+{
+    setDown(id, true);
+}
+
+void XeSyntheticDevice::release(const char *id)
+{
+    setDown(id, false);
+}
+
+void XeSyntheticDevice::set(Axis *a, float value)
+{
+    if (a->axisValue == value)
+        return;
+
+    float delta = value - a->axisValue;
+    a->axisValue = value;
+    m_events.push(XeInputEvent::AXIS, 0, a, delta);
+}
+
+void XeSyntheticDevice::setAxis(const char *id, float value)
+{
+    Axis *a = findAxis(id);
+    if (!a)
+    {
+        xe_trace.warn << QString("XeSyntheticDevice %1: no axis %2").arg(m_id.constData()).arg(id);
+        return;
+    }
+
+    set(a, value);
+}
+
+void XeSyntheticDevice::setAxis(XeAxisInput *input, float value)
+{
+    Axis *a = findAxis(input);
+    if (!a)
+    {
+        xe_trace.warn << QString("XeSyntheticDevice %1: axis doesn't belong to this device").arg(m_id.constData());
+        return;
+    }
+
+    set(a, value);
+}
+
+void XeSyntheticDevice::moveAxis(const char *id, float delta)
+{
+    Axis *a = findAxis(id);
+    if (!a)
+    {
+        xe_trace.warn << QString("XeSyntheticDevice %1: no axis %2").arg(m_id.constData()).arg(id);
+        return;
+    }
+
+    set(a, a->axisValue + delta);
+}
+
+void XeSyntheticDevice::moveAxis(XeAxisInput *input, float delta)
+{
+    Axis *a = findAxis(input);
+    if (!a)
+    {
+        xe_trace.warn << QString("XeSyntheticDevice %1: axis doesn't belong to this device").arg(m_id.constData());
+        return;
+    }
+
+    set(a, a->axisValue + delta);
+}
+
+void XeSyntheticDevice::reset()
+{
+    foreach (Button *b, m_buttons)
+        setDown(b, false);
+    foreach (Axis *a, m_axes)
+        set(a, 0.f);
+}
+
+const char *XeSyntheticDevice::id() const
+{
+    return m_id.constData();
+}
+
+const char *XeSyntheticDevice::name() const
+{
+    return m_name.constData();
+}
+
+bool XeSyntheticDevice::hasAxis(const char *id) const
+{
+    return findAxis(id) != 0;
+}
+
+bool XeSyntheticDevice::hasButton(const char *id) const
+{
+    return findButton(id) != 0;
+}
+
+void XeSyntheticDevice::axes(QList<const char *> &out)
+{
+    foreach (Axis *a, m_axes)
+        out.append(a->m_id);
+}
+
+void XeSyntheticDevice::buttons(QList<const char *> &out)
+{
+    foreach (Button *b, m_buttons)
+        out.append(b->m_id);
+}
+
+XeAxisInput *XeSyntheticDevice::axis(const char *id) const
+{
+    return findAxis(id);
+}
+
+XeButtonInput *XeSyntheticDevice::button(const char *id) const
+{
+    return findButton(id);
+}
+
+void XeSyntheticDevice::update(float dt)
+{
+    foreach (Button *b, m_buttons)
+        b->update(dt);
+
+    // Relative axes report the motion of a single tick; going back to 0
+    // isn't motion, so it isn't recorded as an event
+    foreach (Axis *a, m_axes)
+        if (a->relative)
+            a->axisValue = 0.f;
+
+    m_events.clear();
+}
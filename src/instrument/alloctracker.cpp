@@ -0,0 +1,279 @@
+
+#include "xe/alloctracker.h"
+
+#include <QAtomicInteger>
+
+#include <cstdlib>
+#include <new>
+
+#if XE_ALLOC_TRACKING && defined(__GLIBC__)
+#   include <malloc.h> // malloc_usable_size
+#endif
+
+XeAllocStats XeAllocStats::operator-(const XeAllocStats &o) const
+{
+    XeAllocStats s;
+    s.allocs = allocs > o.allocs ? allocs - o.allocs : 0;
+    s.frees = frees > o.frees ? frees - o.frees : 0;
+    s.bytesAllocated = bytesAllocated > o.bytesAllocated ? bytesAllocated - o.bytesAllocated : 0;
+    s.bytesFreed = bytesFreed > o.bytesFreed ? bytesFreed - o.bytesFreed : 0;
+    return s;
+}
+
+XeAllocStats &XeAllocStats::operator+=(const XeAllocStats &o)
+{
+    allocs += o.allocs;
+    frees += o.frees;
+    bytesAllocated += o.bytesAllocated;
+    bytesFreed += o.bytesFreed;
+    return *this;
+}
+
+#if XE_ALLOC_TRACKING
+
+// The hooks below run inside the allocator, so nothing they touch may
+// allocate in turn: the per-thread counters are plain zero-initialized PODs
+// and the process-wide counters are constant-initialized atomics.
+
+struct AllocCounters
+{
+    quint64 allocs;
+    quint64 frees;
+    quint64 bytesAllocated;
+    quint64 bytesFreed;
+};
+
+static thread_local AllocCounters t_counters;
+
+static QAtomicInteger<quint64> s_allocs;
+static QAtomicInteger<quint64> s_frees;
+static QAtomicInteger<quint64> s_bytesAllocated;
+static QAtomicInteger<quint64> s_bytesFreed;
+
+static inline void record_alloc(size_t size)
+{
+    ++t_counters.allocs;
+    t_counters.bytesAllocated += size;
+
+    s_allocs.fetchAndAddRelaxed(1);
+    s_bytesAllocated.fetchAndAddRelaxed(size);
+}
+
+static inline void record_free(size_t size)
+{
+    ++t_counters.frees;
+    t_counters.bytesFreed += size;
+
+    s_frees.fetchAndAddRelaxed(1);
+    s_bytesFreed.fetchAndAddRelaxed(size);
+}
+
+#if defined(__GLIBC__)
+
+// On glibc, operator new/delete are implemented in terms of malloc/free, so
+// interposing the C allocator catches both. The original implementations
+// remain available under their __libc_ names.
+
+extern "C"
+{
+    void *__libc_malloc(size_t);
+    void *__libc_calloc(size_t, size_t);
+    void *__libc_realloc(void *, size_t);
+    void *__libc_memalign(size_t, size_t);
+    void __libc_free(void *);
+}
+
+extern "C" void *malloc(size_t size)
+{
+    void *p = __libc_malloc(size);
+    if (p)
+        record_alloc(malloc_usable_size(p));
+
+    return p;
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    void *p = __libc_calloc(count, size);
+    if (p)
+        record_alloc(malloc_usable_size(p));
+
+    return p;
+}
+
+extern "C" void *realloc(void *old, size_t size)
+{
+    size_t oldSize = old ? malloc_usable_size(old) : 0;
+
+    void *p = __libc_realloc(old, size);
+    if (!p && size)
+        return p; // Failed; old is untouched
+
+    if (old)
+        record_free(oldSize);
+    if (p)
+        record_alloc(malloc_usable_size(p));
+
+    return p;
+}
+
+extern "C" void *memalign(size_t alignment, size_t size)
+{
+    void *p = __libc_memalign(alignment, size);
+    if (p)
+        record_alloc(malloc_usable_size(p));
+
+    return p;
+}
+
+extern "C" void *aligned_alloc(size_t alignment, size_t size)
+{
+    return memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void **out, size_t alignment, size_t size)
+{
+    if (!alignment || (alignment & (alignment - 1)) || alignment % sizeof(void*))
+        return 22; // EINVAL
+
+    void *p = memalign(alignment, size);
+    if (!p)
+        return 12; // ENOMEM
+
+    *out = p;
+    return 0;
+}
+
+extern "C" void free(void *p)
+{
+    if (p)
+        record_free(malloc_usable_size(p));
+
+    __libc_free(p);
+}
+
+#else
+
+// Elsewhere there's no portable way to interpose malloc, so only the global
+// operator new/delete are replaced. Each block is prefixed with its size so
+// that delete can account for the bytes it releases. The prefix is padded to
+// 16 bytes to preserve the alignment malloc() guarantees.
+
+static const size_t header_size = 16;
+
+static void *tracked_alloc(size_t size)
+{
+    char *p = (char*)malloc(size + header_size);
+    if (!p)
+        return 0;
+
+    *(size_t*)p = size;
+    record_alloc(size);
+
+    return p + header_size;
+}
+
+static void tracked_free(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    char *p = (char*)ptr - header_size;
+    record_free(*(size_t*)p);
+
+    free(p);
+}
+
+void *operator new(size_t size)
+{
+    void *p = tracked_alloc(size);
+    if (!p)
+        throw std::bad_alloc();
+
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    void *p = tracked_alloc(size);
+    if (!p)
+        throw std::bad_alloc();
+
+    return p;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) throw()
+{
+    return tracked_alloc(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) throw()
+{
+    return tracked_alloc(size);
+}
+
+void operator delete(void *p) throw()
+{
+    tracked_free(p);
+}
+
+void operator delete[](void *p) throw()
+{
+    tracked_free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) throw()
+{
+    tracked_free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) throw()
+{
+    tracked_free(p);
+}
+
+#endif // __GLIBC__
+
+bool XeAllocTracker::isEnabled()
+{
+    return true;
+}
+
+XeAllocStats XeAllocTracker::thread()
+{
+    XeAllocStats s;
+    s.allocs = t_counters.allocs;
+    s.frees = t_counters.frees;
+    s.bytesAllocated = t_counters.bytesAllocated;
+    s.bytesFreed = t_counters.bytesFreed;
+    return s;
+}
+
+XeAllocStats XeAllocTracker::process()
+{
+    XeAllocStats s;
+    s.allocs = s_allocs.loadAcquire();
+    s.frees = s_frees.loadAcquire();
+    s.bytesAllocated = s_bytesAllocated.loadAcquire();
+    s.bytesFreed = s_bytesFreed.loadAcquire();
+    return s;
+}
+
+#else
+
+bool XeAllocTracker::isEnabled()
+{
+    return false;
+}
+
+XeAllocStats XeAllocTracker::thread()
+{
+    return XeAllocStats();
+}
+
+XeAllocStats XeAllocTracker::process()
+{
+    return XeAllocStats();
+}
+
+#endif // XE_ALLOC_TRACKING
@@ -0,0 +1,186 @@
+
+#include "xe/flightrecorder.h"
+#include "xe/profiler.h"
+#include "xe/trace.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+
+XeFlightRecorder::XeFlightRecorder(XeProfiler *profiler, int frames)
+        : m_profiler(profiler), m_current(0), m_count(0), m_frameIndex(0),
+          m_cooldown(0), m_dumps(0), m_threshold(.1f), m_directory(".")
+{
+    setFrames(frames);
+}
+
+XeProfiler *XeFlightRecorder::profiler() const
+{
+    return m_profiler;
+}
+
+void XeFlightRecorder::setProfiler(XeProfiler *p)
+{
+    m_profiler = p;
+}
+
+int XeFlightRecorder::frames() const
+{
+    return m_frames.count();
+}
+
+void XeFlightRecorder::setFrames(int n)
+{
+    xe_assert(n > 0, "XeFlightRecorder needs to keep at least one frame");
+
+    m_frames.clear();
+    m_frames.resize(n);
+    m_current = 0;
+    m_count = 0;
+
+    m_frames[0].index = m_frameIndex;
+}
+
+float XeFlightRecorder::threshold() const
+{
+    return m_threshold;
+}
+
+void XeFlightRecorder::setThreshold(float t)
+{
+    m_threshold = t;
+}
+
+const char *XeFlightRecorder::directory() const
+{
+    return m_directory.constData();
+}
+
+void XeFlightRecorder::setDirectory(const char *dir)
+{
+    m_directory = dir;
+}
+
+int XeFlightRecorder::dumpCount() const
+{
+    return m_dumps;
+}
+
+void XeFlightRecorder::log(time_t timestamp, XeTraceType type, const char *str)
+{
+    Record r;
+    r.timestamp = timestamp;
+    r.type = type;
+    r.message = str;
+
+    m_frames[m_current].records.append(r);
+}
+
+void XeFlightRecorder::update(float dt)
+{
+    Frame &f = m_frames[m_current];
+    f.dt = dt;
+
+    if (m_profiler)
+    {
+        m_sections.clear();
+        m_profiler->sections(m_sections);
+
+        foreach (const XeProfilerSection *s, m_sections)
+        {
+            Sample sample;
+            sample.section = s;
+            sample.dt = s->dt();
+            sample.allocs = s->allocations();
+
+            f.samples.append(sample);
+        }
+    }
+
+    // A hitch is dumped with the frames leading up to it. After a dump, wait
+    // for the window to fill with new frames before dumping again, so that a
+    // sustained slowdown doesn't write a file every tick
+
+    quint64 index = f.index;
+    QByteArray written;
+    if (dt > m_threshold && m_cooldown == 0)
+    {
+        QByteArray path = QDir(m_directory).filePath(
+                QString("hitch-%1.trace").arg(index)).toUtf8();
+
+        if (dump(path.constData()))
+        {
+            written = path;
+            ++m_dumps;
+        }
+
+        m_cooldown = m_frames.count();
+    }
+    else if (m_cooldown > 0)
+    {
+        --m_cooldown;
+    }
+
+    // Start the next frame, reusing the oldest frame's storage
+
+    if (m_count < m_frames.count() - 1)
+        ++m_count;
+
+    m_current = (m_current + 1) % m_frames.count();
+    ++m_frameIndex;
+
+    Frame &next = m_frames[m_current];
+    next.index = m_frameIndex;
+    next.dt = 0.f;
+    next.samples.clear();
+    next.records.clear();
+
+    // Logged after the frame is closed, so the message lands in the next frame
+
+    if (!written.isEmpty())
+        xe_trace.warn << QString("XeFlightRecorder: frame %1 took %2 ms, wrote %3")
+                         .arg(index).arg(1000.f * dt, 0, 'f', 1).arg(written.constData());
+}
+
+bool XeFlightRecorder::dump(const char *path) const
+{
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        xe_trace.error << QString("XeFlightRecorder: could not open %1 for writing").arg(path);
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "# xenon flight recorder\n"
+        << "# threshold " << m_threshold << " s, " << (m_count + 1) << " frames\n";
+
+    // The frame in progress is written last. When update() dumps a hitch,
+    // this is the frame that exceeded the threshold
+
+    int oldest = (m_current - m_count + m_frames.count()) % m_frames.count();
+    for (int i = 0; i <= m_count; ++i)
+    {
+        const Frame &f = m_frames[(oldest + i) % m_frames.count()];
+
+        out << "frame " << f.index << " dt " << f.dt << "\n";
+
+        foreach (const Sample &s, f.samples)
+        {
+            out << "  section " << s.dt
+                << " allocs " << s.allocs.allocs
+                << " bytes " << s.allocs.bytesAllocated
+                << " " << s.section->name() << "\n";
+        }
+
+        foreach (const Record &r, f.records)
+        {
+            out << "  log " << (qint64)r.timestamp
+                << " " << xe_trace_type_str(r.type)
+                << " " << r.message << "\n";
+        }
+    }
+
+    out.flush();
+    return out.status() == QTextStream::Ok;
+}
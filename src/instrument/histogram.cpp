@@ -0,0 +1,130 @@
+
+#include "xe/histogram.h"
+#include "xe/trace.h"
+
+#include <cstring>
+
+XeHistogram::XeHistogram()
+{
+    clear();
+}
+
+void XeHistogram::add(qint64 ns)
+{
+    if (ns < 0)
+        ns = 0;
+
+    // The bucket is the number of bits in the duration in microseconds
+    quint64 us = (quint64)ns / 1000;
+    int b = 0;
+    while (us && b < BUCKETS - 1)
+    {
+        us >>= 1;
+        ++b;
+    }
+
+    ++m_buckets[b];
+    m_sum += ns;
+
+    if (m_count == 0 || ns < m_min)
+        m_min = ns;
+    if (m_count == 0 || ns > m_max)
+        m_max = ns;
+
+    ++m_count;
+}
+
+void XeHistogram::merge(const XeHistogram &other)
+{
+    if (other.m_count == 0)
+        return;
+
+    for (int i = 0; i < BUCKETS; ++i)
+        m_buckets[i] += other.m_buckets[i];
+
+    if (m_count == 0 || other.m_min < m_min)
+        m_min = other.m_min;
+    if (m_count == 0 || other.m_max > m_max)
+        m_max = other.m_max;
+
+    m_sum += other.m_sum;
+    m_count += other.m_count;
+}
+
+void XeHistogram::clear()
+{
+    memset(m_buckets, 0, sizeof(m_buckets));
+    m_count = 0;
+    m_sum = 0;
+    m_min = 0;
+    m_max = 0;
+}
+
+quint64 XeHistogram::count() const
+{
+    return m_count;
+}
+
+quint64 XeHistogram::bucket(int i) const
+{
+    return i >= 0 && i < BUCKETS ? m_buckets[i] : 0;
+}
+
+qint64 XeHistogram::bucketLimit(int i)
+{
+    return (qint64)1 << i;
+}
+
+qint64 XeHistogram::min() const
+{
+    return m_min;
+}
+
+qint64 XeHistogram::max() const
+{
+    return m_max;
+}
+
+qint64 XeHistogram::mean() const
+{
+    return m_count ? m_sum / (qint64)m_count : 0;
+}
+
+qint64 XeHistogram::percentile(float p) const
+{
+    if (m_count == 0)
+        return 0;
+
+    // The rank of the sample we're looking for, rounded up
+    quint64 rank = (quint64)(p * m_count + .999f);
+    if (rank < 1)
+        rank = 1;
+
+    quint64 seen = 0;
+    for (int i = 0; i < BUCKETS; ++i)
+    {
+        seen += m_buckets[i];
+        if (seen >= rank)
+        {
+            qint64 limit = bucketLimit(i) * 1000;
+            return limit < m_max ? limit : m_max;
+        }
+    }
+
+    return m_max;
+}
+
+void XeHistogram::log(const char *title) const
+{
+    xe_trace.info << QString("%1: %2 samples, mean %3us, p50 %4us, p99 %5us, max %6us")
+                     .arg(title)
+                     .arg(m_count)
+                     .arg(mean() / 1000)
+                     .arg(percentile(.5f) / 1000)
+                     .arg(percentile(.99f) / 1000)
+                     .arg(m_max / 1000);
+
+    for (int i = 0; i < BUCKETS; ++i)
+        if (m_buckets[i])
+            xe_trace.info << QString("\t< %1us\t%2").arg(bucketLimit(i)).arg(m_buckets[i]);
+}
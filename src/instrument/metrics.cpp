@@ -0,0 +1,217 @@
+
+#include "xe/metrics.h"
+#include "xe/trace.h"
+
+#include <QMutexLocker>
+#include <QThread>
+
+#include <cstring> // memset
+
+XeMetrics xe_metrics;
+
+// Caches the calling thread's slots for the registry it last touched, so that
+// the common case (one registry, many increments) never walks the slot list.
+// The cache is keyed on the registry's generation as well as its address, as
+// a new registry may be allocated where a destroyed one was
+static thread_local const XeMetrics *t_owner = 0;
+static thread_local quint64 t_generation = 0;
+static thread_local void *t_slots = 0;
+
+static QAtomicInteger<quint64> s_generations;
+
+XeMetrics::XeMetrics(int history)
+        : m_threads(0), m_generation(s_generations.fetchAndAddRelaxed(1) + 1), m_count(0), m_historyFrames(history > 0 ? history : 1), m_frames(0)
+{
+    m_history = new qint64[m_historyFrames * MAX_METRICS];
+    memset(m_history, 0, sizeof(qint64) * m_historyFrames * MAX_METRICS);
+}
+
+XeMetrics::~XeMetrics()
+{
+    ThreadSlots *s = m_threads.loadAcquire();
+    while (s)
+    {
+        ThreadSlots *next = s->next;
+        delete s;
+        s = next;
+    }
+
+    delete[] m_history;
+
+    if (t_owner == this)
+        t_owner = 0;
+}
+
+XeMetric XeMetrics::reg(const char *name, Type type)
+{
+    QMutexLocker lock(&m_lock);
+
+    QByteArray key(name);
+    if (m_lookup.contains(key))
+    {
+        XeMetric m = m_lookup[key];
+        if (m_types[m] != type)
+            xe_trace.warn << QString("XeMetrics: %1 is already registered with a different type").arg(name);
+
+        return m;
+    }
+
+    int m = m_count.loadAcquire();
+    if (m >= MAX_METRICS)
+    {
+        xe_trace.error << QString("XeMetrics: can't register %1, the registry is full").arg(name);
+        return -1;
+    }
+
+    m_names[m] = key;
+    m_types[m] = type;
+    m_lookup[key] = m;
+
+    m_count.storeRelease(m + 1);
+    return m;
+}
+
+XeMetric XeMetrics::counter(const char *name)
+{
+    return reg(name, COUNTER);
+}
+
+XeMetric XeMetrics::gauge(const char *name)
+{
+    return reg(name, GAUGE);
+}
+
+XeMetric XeMetrics::find(const char *name) const
+{
+    QMutexLocker lock(&m_lock);
+    return m_lookup.value(QByteArray(name), -1);
+}
+
+int XeMetrics::count() const
+{
+    return m_count.loadAcquire();
+}
+
+const char *XeMetrics::name(XeMetric m) const
+{
+    if (m < 0 || m >= count())
+        return "";
+
+    return m_names[m].constData();
+}
+
+XeMetrics::Type XeMetrics::type(XeMetric m) const
+{
+    if (m < 0 || m >= count())
+        return COUNTER;
+
+    return m_types[m];
+}
+
+XeMetrics::ThreadSlots *XeMetrics::threadSlots()
+{
+    if (t_owner == this && t_generation == m_generation)
+        return (ThreadSlots*)t_slots;
+
+    Qt::HANDLE thread = QThread::currentThreadId();
+
+    ThreadSlots *s = m_threads.loadAcquire();
+    while (s && s->thread != thread)
+        s = s->next;
+
+    if (!s)
+    {
+        // First increment from this thread: publish a new set of slots.
+        // Slots are never removed, so a lock-free push is enough
+        s = new ThreadSlots();
+        s->thread = thread;
+
+        do
+        {
+            s->next = m_threads.loadAcquire();
+        }
+        while (!m_threads.testAndSetOrdered(s->next, s));
+    }
+
+    t_owner = this;
+    t_generation = m_generation;
+    t_slots = s;
+    return s;
+}
+
+void XeMetrics::add(XeMetric m, qint64 amount)
+{
+    if (m < 0 || m >= MAX_METRICS)
+        return;
+
+    threadSlots()->values[m].fetchAndAddRelaxed(amount);
+}
+
+void XeMetrics::set(XeMetric m, qint64 value)
+{
+    if (m < 0 || m >= MAX_METRICS)
+        return;
+
+    m_gauges[m].storeRelease(value);
+}
+
+void XeMetrics::adjust(XeMetric m, qint64 amount)
+{
+    if (m < 0 || m >= MAX_METRICS)
+        return;
+
+    m_gauges[m].fetchAndAddRelaxed(amount);
+}
+
+qint64 XeMetrics::value(XeMetric m) const
+{
+    return value(m, 0);
+}
+
+qint64 XeMetrics::value(XeMetric m, int framesAgo) const
+{
+    if (m < 0 || m >= count() || framesAgo < 0 || (quint64)framesAgo >= m_frames ||
+        framesAgo >= m_historyFrames)
+        return 0;
+
+    int frame = (int)((m_frames - 1 - framesAgo) % m_historyFrames);
+    return m_history[frame * MAX_METRICS + m];
+}
+
+int XeMetrics::history() const
+{
+    return m_historyFrames;
+}
+
+quint64 XeMetrics::frames() const
+{
+    return m_frames;
+}
+
+void XeMetrics::update(float)
+{
+    int n = count();
+    qint64 *row = m_history + (m_frames % m_historyFrames) * MAX_METRICS;
+
+    for (int m = 0; m < n; ++m)
+        row[m] = m_types[m] == GAUGE ? m_gauges[m].loadAcquire() : 0;
+
+    for (ThreadSlots *s = m_threads.loadAcquire(); s; s = s->next)
+        for (int m = 0; m < n; ++m)
+            if (m_types[m] == COUNTER)
+                row[m] += s->values[m].fetchAndStoreRelaxed(0);
+
+    ++m_frames;
+}
+
+void XeMetrics::log() const
+{
+    const char *titles = "\tValue\t\tMetric";
+
+    xe_trace.info << "XeMetrics"
+                  << titles;
+
+    int n = count();
+    for (int m = 0; m < n; ++m)
+        xe_trace.info << QString("\t%1\t\t%2").arg(value(m)).arg(name(m));
+}
@@ -0,0 +1,258 @@
+
+#include "xe/perfcounters.h"
+
+#include <cstring>
+
+#if defined(__linux__)
+#   define XE_PERF_EVENTS 1
+#   include <cerrno>
+#   include <ctime>
+#   include <linux/perf_event.h>
+#   include <sys/ioctl.h>
+#   include <sys/resource.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#else
+#   define XE_PERF_EVENTS 0
+#endif
+
+XePerfSample::XePerfSample()
+        : cycles(0), instructions(0), cacheReferences(0), cacheMisses(0),
+          branches(0), branchMisses(0), taskClock(0), pageFaults(0), contextSwitches(0)
+{ }
+
+float XePerfSample::ipc() const
+{
+    return cycles ? (float)instructions / cycles : 0.f;
+}
+
+float XePerfSample::cacheMissRate() const
+{
+    return cacheReferences ? (float)cacheMisses / cacheReferences : 0.f;
+}
+
+float XePerfSample::branchMissRate() const
+{
+    return branches ? (float)branchMisses / branches : 0.f;
+}
+
+static inline quint64 delta(quint64 a, quint64 b)
+{
+    return a > b ? a - b : 0;
+}
+
+XePerfSample XePerfSample::operator-(const XePerfSample &o) const
+{
+    XePerfSample s;
+    s.cycles = delta(cycles, o.cycles);
+    s.instructions = delta(instructions, o.instructions);
+    s.cacheReferences = delta(cacheReferences, o.cacheReferences);
+    s.cacheMisses = delta(cacheMisses, o.cacheMisses);
+    s.branches = delta(branches, o.branches);
+    s.branchMisses = delta(branchMisses, o.branchMisses);
+    s.taskClock = delta(taskClock, o.taskClock);
+    s.pageFaults = delta(pageFaults, o.pageFaults);
+    s.contextSwitches = delta(contextSwitches, o.contextSwitches);
+    return s;
+}
+
+XePerfSample &XePerfSample::operator+=(const XePerfSample &o)
+{
+    cycles += o.cycles;
+    instructions += o.instructions;
+    cacheReferences += o.cacheReferences;
+    cacheMisses += o.cacheMisses;
+    branches += o.branches;
+    branchMisses += o.branchMisses;
+    taskClock += o.taskClock;
+    pageFaults += o.pageFaults;
+    contextSwitches += o.contextSwitches;
+    return *this;
+}
+
+#if XE_PERF_EVENTS
+
+// Each group is read with a single read() on its leader (PERF_FORMAT_GROUP).
+// The values are listed in the order the counters were opened
+
+static const quint64 hw_events[] =
+{
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_REFERENCES,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+static const quint64 sw_events[] =
+{
+    PERF_COUNT_SW_TASK_CLOCK,
+    PERF_COUNT_SW_PAGE_FAULTS,
+    PERF_COUNT_SW_CONTEXT_SWITCHES,
+};
+
+static int perf_open(quint32 type, quint64 config, int leader)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = leader == -1; // The leader enables the whole group at once
+    attr.exclude_kernel = type == PERF_TYPE_HARDWARE;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP |
+                       PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // pid 0, cpu -1: the calling thread, on whichever CPU it runs
+    int fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+
+    // With perf_event_paranoid at 2, the default, unprivileged processes may
+    // only count user space. Software events then lose the time and faults
+    // spent in the kernel, but still beat falling back to getrusage()
+    if (fd == -1 && !attr.exclude_kernel && (errno == EACCES || errno == EPERM))
+    {
+        attr.exclude_kernel = 1;
+        fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+    }
+
+    return fd;
+}
+
+static void close_group(int *fds, int count)
+{
+    for (int i = count - 1; i >= 0; --i)
+    {
+        if (fds[i] != -1)
+            ::close(fds[i]);
+        fds[i] = -1;
+    }
+}
+
+static bool open_group(quint32 type, const quint64 *events, int *fds, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        fds[i] = perf_open(type, events[i], i == 0 ? -1 : fds[0]);
+        if (fds[i] == -1)
+        {
+            close_group(fds, count);
+            return false;
+        }
+    }
+
+    ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+}
+
+static bool read_group(int leader, quint64 *out, int count)
+{
+    // nr, time_enabled, time_running, then one value per counter
+    quint64 buf[3 + 8];
+    if (::read(leader, buf, sizeof(buf)) < (ssize_t)(sizeof(quint64) * (3 + count)))
+        return false;
+
+    // If there were more counters than the PMU could schedule at once, the
+    // kernel multiplexed them; extrapolate to the full enabled time
+    quint64 enabled = buf[1], running = buf[2];
+    double scale = running && running < enabled ? (double)enabled / running : 1.0;
+
+    for (int i = 0; i < count; ++i)
+        out[i] = (quint64)(buf[3 + i] * scale);
+
+    return true;
+}
+
+#endif // XE_PERF_EVENTS
+
+XePerfCounters::XePerfCounters() : m_mode(NONE)
+{
+    for (int i = 0; i < HW_COUNTERS; ++i)
+        m_hw[i] = -1;
+    for (int i = 0; i < SW_COUNTERS; ++i)
+        m_sw[i] = -1;
+}
+
+XePerfCounters::~XePerfCounters()
+{
+    close();
+}
+
+XePerfCounters::Mode XePerfCounters::open()
+{
+    close();
+
+#if XE_PERF_EVENTS
+    bool hw = open_group(PERF_TYPE_HARDWARE, hw_events, m_hw, HW_COUNTERS);
+
+    // If the software events can't be opened either, read() falls back to
+    // getrusage(), so software counters are always available on Linux
+    open_group(PERF_TYPE_SOFTWARE, sw_events, m_sw, SW_COUNTERS);
+
+    m_mode = hw ? HARDWARE : SOFTWARE;
+#endif
+
+    return m_mode;
+}
+
+void XePerfCounters::close()
+{
+#if XE_PERF_EVENTS
+    close_group(m_hw, HW_COUNTERS);
+    close_group(m_sw, SW_COUNTERS);
+#endif
+
+    m_mode = NONE;
+}
+
+XePerfCounters::Mode XePerfCounters::mode() const
+{
+    return m_mode;
+}
+
+XePerfSample XePerfCounters::read() const
+{
+    XePerfSample s;
+
+#if XE_PERF_EVENTS
+    if (m_mode == NONE)
+        return s;
+
+    quint64 v[HW_COUNTERS];
+
+    if (m_hw[0] != -1 && read_group(m_hw[0], v, HW_COUNTERS))
+    {
+        s.cycles = v[0];
+        s.instructions = v[1];
+        s.cacheReferences = v[2];
+        s.cacheMisses = v[3];
+        s.branches = v[4];
+        s.branchMisses = v[5];
+    }
+
+    if (m_sw[0] != -1 && read_group(m_sw[0], v, SW_COUNTERS))
+    {
+        s.taskClock = v[0];
+        s.pageFaults = v[1];
+        s.contextSwitches = v[2];
+    }
+    else
+    {
+        struct timespec ts;
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+            s.taskClock = (quint64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+
+        struct rusage ru;
+        if (getrusage(RUSAGE_THREAD, &ru) == 0)
+        {
+            s.pageFaults = ru.ru_minflt + ru.ru_majflt;
+            s.contextSwitches = ru.ru_nvcsw + ru.ru_nivcsw;
+        }
+    }
+#endif
+
+    return s;
+}
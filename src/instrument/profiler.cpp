@@ -1,11 +1,14 @@
 
 #include "xe/profiler.h"
+#include "xe/profileroverlay.h"
 #include "xe/trace.h"
 
+#include <GL/glew.h>
+
 #include <QHashIterator>
 #include <QStringList>
 
-XeProfilerSection::XeProfilerSection(const char *name) : m_name(name) { }
+XeProfilerSection::XeProfilerSection(const char *name) : m_name(name), m_parent(0), m_frame(0), m_dt(0.f) { }
 
 const char *XeProfilerSection::name() const 
 {
@@ -22,14 +25,71 @@ float XeProfilerSection::dt() const
     return m_dt;
 }
 
+const XeProfilerSection *XeProfilerSection::parent() const
+{
+    return m_parent;
+}
+
+quint64 XeProfilerSection::frame() const
+{
+    return m_frame;
+}
+
+const XeAllocStats &XeProfilerSection::allocations() const
+{
+    return m_allocs;
+}
+
+const XePerfSample &XeProfilerSection::perf() const
+{
+    return m_perf;
+}
+
 void XeProfilerSection::begin()
 {
+    m_allocStart = XeAllocTracker::thread();
     m_time.start();
 }
 
 void XeProfilerSection::end()
 {
-    m_dt = .001f * m_time.elapsed();
+    m_dt = 1e-9f * m_time.nsecsElapsed();
+    m_allocs = XeAllocTracker::thread() - m_allocStart;
+}
+
+XeProfiler::XeProfiler()
+        : m_perf(0), m_overlay(0), m_frame(0), m_dt(0.f), m_threadStart(XeAllocTracker::thread()), m_processStart(XeAllocTracker::process())
+{ }
+
+XeProfiler::~XeProfiler()
+{
+    delete m_perf;
+    delete m_overlay;
+}
+
+XePerfCounters::Mode XeProfiler::setPerfCounters(bool enabled)
+{
+    delete m_perf;
+    m_perf = 0;
+
+    if (!enabled)
+        return XePerfCounters::NONE;
+
+    m_perf = new XePerfCounters();
+    if (m_perf->open() == XePerfCounters::NONE)
+    {
+        xe_trace.warn << "XeProfiler: performance counters are not available on this platform";
+        delete m_perf;
+        m_perf = 0;
+        return XePerfCounters::NONE;
+    }
+
+    return m_perf->mode();
+}
+
+const XePerfCounters *XeProfiler::perfCounters() const
+{
+    return m_perf;
 }
 
 XeProfilerSection *XeProfiler::get(const char *name)
@@ -57,14 +117,47 @@ void XeProfiler::sections(QList<XeProfilerSection*> &out) const
         out.append(it.next().value());
 }
 
+void XeProfiler::sections(QVector<XeProfilerSection*> &out) const
+{
+    out.resize(m_sections.count());
+
+    int i = 0;
+    QHashIterator<QString, XeProfilerSection*> it(m_sections);
+    while (it.hasNext())
+        out[i++] = it.next().value();
+}
+
 void XeProfiler::begin(const char *name)
 {
-    get(name)->begin();
+    XeProfilerSection *s = get(name);
+
+    s->m_parent = m_stack.isEmpty() ? 0 : m_stack.top();
+    m_stack.push(s);
+
+    // Counters are read outside of the timed region, so the cost of the
+    // read() syscall doesn't show up in the section's time
+    if (m_perf)
+        s->m_perfStart = m_perf->read();
+
+    s->begin();
 }
 
 void XeProfiler::end(const char *name)
 {
-    get(name)->end();
+    XeProfilerSection *s = get(name);
+    s->end();
+
+    if (m_perf)
+        s->m_perf = m_perf->read() - s->m_perfStart;
+
+    s->m_frame = m_frame;
+
+    // Sections are normally ended in the reverse order they were begun in,
+    // but tolerate overlapping sections by removing s wherever it is
+    if (!m_stack.isEmpty() && m_stack.top() == s)
+        m_stack.pop();
+    else
+        m_stack.removeOne(s);
 }
 
 void XeProfiler::update(float dt)
@@ -75,19 +168,64 @@ void XeProfiler::update(float dt)
     if (!other)
         other = new XeProfilerSection("Other");
 
+    // Only outermost sections sampled this frame count towards the total;
+    // nested sections are already included in their parents
     float total = 0.f;
+    XeAllocStats totalAllocs;
     QHashIterator<QString, XeProfilerSection*> it(m_sections);
     while (it.hasNext())
-        total += it.next().value()->dt();
+    {
+        XeProfilerSection *s = it.next().value();
+        if (s->parent() || s->frame() != m_frame)
+            continue;
+
+        total += s->dt();
+        totalAllocs += s->allocations();
+    }
+
+    XeAllocStats threadNow = XeAllocTracker::thread();
+    XeAllocStats processNow = XeAllocTracker::process();
 
     other->m_dt = dt - total;
+    other->m_allocs = (threadNow - m_threadStart) - totalAllocs;
+    other->m_frame = m_frame;
     m_sections["Other"] = other;
+
+    m_frameAllocs = processNow - m_processStart;
+    m_threadStart = threadNow;
+    m_processStart = processNow;
+
+    ++m_frame;
+}
+
+quint64 XeProfiler::frame() const
+{
+    return m_frame;
+}
+
+float XeProfiler::dt() const
+{
+    return m_dt;
+}
+
+const XeAllocStats &XeProfiler::allocations() const
+{
+    return m_frameAllocs;
 }
 
 void XeProfiler::log() const
 {
-    const char *titles = "\tTime\t\t%\t\tSection";
-    const char *fmt = "\t%.3f\t\t%.3f\t\t%s";
+    bool allocs = XeAllocTracker::isEnabled();
+    XePerfCounters::Mode perf = m_perf ? m_perf->mode() : XePerfCounters::NONE;
+
+    QString titles = "\tTime\t\t%";
+    if (allocs)
+        titles += "\t\tAllocs\t\tBytes";
+    if (perf == XePerfCounters::HARDWARE)
+        titles += "\t\tIPC\t\tCache miss\tBranch miss";
+    else if (perf == XePerfCounters::SOFTWARE)
+        titles += "\t\tCPU time\tFaults\t\tSwitches";
+    titles += "\t\tSection";
 
     xe_trace.info << "XeProfiler"
                   << titles;
@@ -97,15 +235,58 @@ void XeProfiler::log() const
 
     foreach (const QString& section, keys)
     {
-        float t = m_sections[section]->dt();
+        const XeProfilerSection *s = m_sections[section];
+        float t = s->dt();
         float amt = t / m_dt;
 
-        xe_trace.info(fmt, t, amt, section.toUtf8().data());
+        QString row = QString("\t%1\t\t%2").arg(t, 0, 'f', 3).arg(amt, 0, 'f', 3);
+
+        if (allocs)
+            row += QString("\t\t%1\t\t%2").arg(s->allocations().allocs)
+                                           .arg(s->allocations().bytesAllocated);
+
+        const XePerfSample &p = s->perf();
+        if (perf == XePerfCounters::HARDWARE)
+            row += QString("\t\t%1\t\t%2%\t\t%3%").arg(p.ipc(), 0, 'f', 2)
+                                                  .arg(100.f * p.cacheMissRate(), 0, 'f', 1)
+                                                  .arg(100.f * p.branchMissRate(), 0, 'f', 1);
+        else if (perf == XePerfCounters::SOFTWARE)
+            row += QString("\t\t%1\t\t%2\t\t%3").arg(1e-9 * p.taskClock, 0, 'f', 3)
+                                                .arg(p.pageFaults)
+                                                .arg(p.contextSwitches);
+
+        row += "\t\t" + section;
+        xe_trace.info << row;
     }
+
+    if (allocs)
+        xe_trace.info << QString("\tFrame total: %1 allocations, %2 bytes (all threads)")
+                         .arg(m_frameAllocs.allocs).arg(m_frameAllocs.bytesAllocated);
 }
 
 void XeProfiler::render(float) const
 {
-    xe_trace.error << "XeProfiler::render() not yet implemented";
+    if (!m_overlay)
+        m_overlay = new XeProfilerOverlay();
+
+    m_overlay->draw(*this);
+    const QImage &img = m_overlay->image();
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_PIXEL_MODE_BIT);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // QImage rows run top to bottom; draw them downwards from the top-left
+    // corner. Format_ARGB32 is BGRA in memory on little-endian machines
+    glWindowPos2i(viewport[0], viewport[1] + viewport[3]);
+    glPixelZoom(1.f, -1.f);
+    glDrawPixels(img.width(), img.height(), GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, img.constBits());
+    glPixelZoom(1.f, 1.f);
+
+    glPopAttrib();
 }
 
@@ -0,0 +1,98 @@
+
+#include "xe/metrics.h"
+#include "xe/profiler.h"
+#include "xe/profilercsv.h"
+#include "xe/trace.h"
+
+static QByteArray section_path(const XeProfilerSection *s)
+{
+    QByteArray path(s->name());
+    for (s = s->parent(); s; s = s->parent())
+        path = QByteArray(s->name()) + "/" + path;
+
+    return path;
+}
+
+static QByteArray csv_escape(const QByteArray &str)
+{
+    if (!str.contains(',') && !str.contains('"') && !str.contains('\n'))
+        return str;
+
+    QByteArray quoted("\"");
+    for (int i = 0; i < str.size(); ++i)
+    {
+        if (str[i] == '"')
+            quoted += '"';
+        quoted += str[i];
+    }
+    quoted += '"';
+
+    return quoted;
+}
+
+XeProfilerCsv::XeProfilerCsv(XeProfiler *profiler, const char *path, XeMetrics *metrics)
+        : m_profiler(profiler), m_metrics(metrics), m_file(path)
+{
+    if (!m_file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        xe_trace.error << QString("XeProfilerCsv: could not open %1 for writing").arg(path);
+        return;
+    }
+
+    m_out.setDevice(&m_file);
+    m_out << "frame,type,name,value\n";
+}
+
+XeProfilerCsv::~XeProfilerCsv()
+{
+    flush();
+}
+
+bool XeProfilerCsv::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+void XeProfilerCsv::update(float)
+{
+    if (!isOpen())
+        return;
+
+    // The profiler has already moved on to the next frame
+    quint64 frame = m_profiler->frame() - 1;
+    bool allocs = XeAllocTracker::isEnabled();
+
+    m_out << frame << ",dt,," << m_profiler->dt() << "\n";
+
+    m_sections.clear();
+    m_profiler->sections(m_sections);
+
+    foreach (const XeProfilerSection *s, m_sections)
+    {
+        if (s->frame() != frame)
+            continue;
+
+        QByteArray name = csv_escape(section_path(s));
+        m_out << frame << ",section," << name << "," << s->dt() << "\n";
+
+        if (allocs)
+        {
+            m_out << frame << ",allocs," << name << "," << s->allocations().allocs << "\n";
+            m_out << frame << ",bytes," << name << "," << s->allocations().bytesAllocated << "\n";
+        }
+    }
+
+    if (m_metrics)
+    {
+        int n = m_metrics->count();
+        for (XeMetric m = 0; m < n; ++m)
+            m_out << frame << ",metric," << csv_escape(m_metrics->name(m))
+                  << "," << m_metrics->value(m) << "\n";
+    }
+}
+
+void XeProfilerCsv::flush()
+{
+    if (isOpen())
+        m_out.flush();
+}
@@ -0,0 +1,70 @@
+
+#include "xe/profiler.h"
+#include "xe/profilerfolded.h"
+#include "xe/trace.h"
+
+#include <QFile>
+#include <QHashIterator>
+#include <QTextStream>
+
+XeProfilerFolded::XeProfilerFolded(XeProfiler *profiler) : m_profiler(profiler) { }
+
+void XeProfilerFolded::update(float)
+{
+    quint64 frame = m_profiler->frame() - 1;
+
+    m_sections.clear();
+    m_profiler->sections(m_sections);
+
+    // Self time: each section's time, minus the time of the sections nested
+    // directly inside it this frame
+    QHash<const XeProfilerSection*, float> self;
+    foreach (const XeProfilerSection *s, m_sections)
+        if (s->frame() == frame)
+            self[s] += s->dt();
+
+    foreach (const XeProfilerSection *s, m_sections)
+        if (s->frame() == frame && s->parent() && s->parent()->frame() == frame)
+            self[s->parent()] -= s->dt();
+
+    QHashIterator<const XeProfilerSection*, float> it(self);
+    while (it.hasNext())
+    {
+        it.next();
+        if (it.value() <= 0.f)
+            continue;
+
+        QByteArray stack = QByteArray(it.key()->name()).replace(';', ':');
+        for (const XeProfilerSection *p = it.key()->parent(); p; p = p->parent())
+            stack = QByteArray(p->name()).replace(';', ':') + ";" + stack;
+
+        m_stacks[stack] += (quint64)(it.value() * 1e6f);
+    }
+}
+
+void XeProfilerFolded::clear()
+{
+    m_stacks.clear();
+}
+
+bool XeProfilerFolded::write(const char *path) const
+{
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        xe_trace.error << QString("XeProfilerFolded: could not open %1 for writing").arg(path);
+        return false;
+    }
+
+    QTextStream out(&file);
+    QHashIterator<QByteArray, quint64> it(m_stacks);
+    while (it.hasNext())
+    {
+        it.next();
+        if (it.value())
+            out << it.key() << " " << it.value() << "\n";
+    }
+
+    out.flush();
+    return out.status() == QTextStream::Ok;
+}
@@ -0,0 +1,175 @@
+
+#include "xe/profiler.h"
+#include "xe/profileroverlay.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+// A 5x7 bitmap font covering printable ASCII (0x20 - 0x7e). Each glyph is
+// five columns, left to right; bit 0 of each column is the top row
+static const unsigned char font[][5] =
+{
+    { 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x5f, 0x00, 0x00 }, //   !
+    { 0x00, 0x07, 0x00, 0x07, 0x00 }, { 0x14, 0x7f, 0x14, 0x7f, 0x14 }, // " #
+    { 0x24, 0x2a, 0x7f, 0x2a, 0x12 }, { 0x23, 0x13, 0x08, 0x64, 0x62 }, // $ %
+    { 0x36, 0x49, 0x55, 0x22, 0x50 }, { 0x00, 0x05, 0x03, 0x00, 0x00 }, // & '
+    { 0x00, 0x1c, 0x22, 0x41, 0x00 }, { 0x00, 0x41, 0x22, 0x1c, 0x00 }, // ( )
+    { 0x08, 0x2a, 0x1c, 0x2a, 0x08 }, { 0x08, 0x08, 0x3e, 0x08, 0x08 }, // * +
+    { 0x00, 0x50, 0x30, 0x00, 0x00 }, { 0x08, 0x08, 0x08, 0x08, 0x08 }, // , -
+    { 0x00, 0x60, 0x60, 0x00, 0x00 }, { 0x20, 0x10, 0x08, 0x04, 0x02 }, // . /
+    { 0x3e, 0x51, 0x49, 0x45, 0x3e }, { 0x00, 0x42, 0x7f, 0x40, 0x00 }, // 0 1
+    { 0x42, 0x61, 0x51, 0x49, 0x46 }, { 0x21, 0x41, 0x45, 0x4b, 0x31 }, // 2 3
+    { 0x18, 0x14, 0x12, 0x7f, 0x10 }, { 0x27, 0x45, 0x45, 0x45, 0x39 }, // 4 5
+    { 0x3c, 0x4a, 0x49, 0x49, 0x30 }, { 0x01, 0x71, 0x09, 0x05, 0x03 }, // 6 7
+    { 0x36, 0x49, 0x49, 0x49, 0x36 }, { 0x06, 0x49, 0x49, 0x29, 0x1e }, // 8 9
+    { 0x00, 0x36, 0x36, 0x00, 0x00 }, { 0x00, 0x56, 0x36, 0x00, 0x00 }, // : ;
+    { 0x08, 0x14, 0x22, 0x41, 0x00 }, { 0x14, 0x14, 0x14, 0x14, 0x14 }, // < =
+    { 0x00, 0x41, 0x22, 0x14, 0x08 }, { 0x02, 0x01, 0x51, 0x09, 0x06 }, // > ?
+    { 0x32, 0x49, 0x79, 0x41, 0x3e }, { 0x7e, 0x11, 0x11, 0x11, 0x7e }, // @ A
+    { 0x7f, 0x49, 0x49, 0x49, 0x36 }, { 0x3e, 0x41, 0x41, 0x41, 0x22 }, // B C
+    { 0x7f, 0x41, 0x41, 0x22, 0x1c }, { 0x7f, 0x49, 0x49, 0x49, 0x41 }, // D E
+    { 0x7f, 0x09, 0x09, 0x09, 0x01 }, { 0x3e, 0x41, 0x49, 0x49, 0x7a }, // F G
+    { 0x7f, 0x08, 0x08, 0x08, 0x7f }, { 0x00, 0x41, 0x7f, 0x41, 0x00 }, // H I
+    { 0x20, 0x40, 0x41, 0x3f, 0x01 }, { 0x7f, 0x08, 0x14, 0x22, 0x41 }, // J K
+    { 0x7f, 0x40, 0x40, 0x40, 0x40 }, { 0x7f, 0x02, 0x0c, 0x02, 0x7f }, // L M
+    { 0x7f, 0x04, 0x08, 0x10, 0x7f }, { 0x3e, 0x41, 0x41, 0x41, 0x3e }, // N O
+    { 0x7f, 0x09, 0x09, 0x09, 0x06 }, { 0x3e, 0x41, 0x51, 0x21, 0x5e }, // P Q
+    { 0x7f, 0x09, 0x19, 0x29, 0x46 }, { 0x46, 0x49, 0x49, 0x49, 0x31 }, // R S
+    { 0x01, 0x01, 0x7f, 0x01, 0x01 }, { 0x3f, 0x40, 0x40, 0x40, 0x3f }, // T U
+    { 0x1f, 0x20, 0x40, 0x20, 0x1f }, { 0x3f, 0x40, 0x38, 0x40, 0x3f }, // V W
+    { 0x63, 0x14, 0x08, 0x14, 0x63 }, { 0x07, 0x08, 0x70, 0x08, 0x07 }, // X Y
+    { 0x61, 0x51, 0x49, 0x45, 0x43 }, { 0x00, 0x7f, 0x41, 0x41, 0x00 }, // Z [
+    { 0x02, 0x04, 0x08, 0x10, 0x20 }, { 0x00, 0x41, 0x41, 0x7f, 0x00 }, // \ ]
+    { 0x04, 0x02, 0x01, 0x02, 0x04 }, { 0x40, 0x40, 0x40, 0x40, 0x40 }, // ^ _
+    { 0x00, 0x01, 0x02, 0x04, 0x00 }, { 0x20, 0x54, 0x54, 0x54, 0x78 }, // ` a
+    { 0x7f, 0x48, 0x44, 0x44, 0x38 }, { 0x38, 0x44, 0x44, 0x44, 0x20 }, // b c
+    { 0x38, 0x44, 0x44, 0x48, 0x7f }, { 0x38, 0x54, 0x54, 0x54, 0x18 }, // d e
+    { 0x08, 0x7e, 0x09, 0x01, 0x02 }, { 0x0c, 0x52, 0x52, 0x52, 0x3e }, // f g
+    { 0x7f, 0x08, 0x04, 0x04, 0x78 }, { 0x00, 0x44, 0x7d, 0x40, 0x00 }, // h i
+    { 0x20, 0x40, 0x44, 0x3d, 0x00 }, { 0x7f, 0x10, 0x28, 0x44, 0x00 }, // j k
+    { 0x00, 0x41, 0x7f, 0x40, 0x00 }, { 0x7c, 0x04, 0x18, 0x04, 0x78 }, // l m
+    { 0x7c, 0x08, 0x04, 0x04, 0x78 }, { 0x38, 0x44, 0x44, 0x44, 0x38 }, // n o
+    { 0x7c, 0x14, 0x14, 0x14, 0x08 }, { 0x08, 0x14, 0x14, 0x18, 0x7c }, // p q
+    { 0x7c, 0x08, 0x04, 0x04, 0x08 }, { 0x48, 0x54, 0x54, 0x54, 0x20 }, // r s
+    { 0x04, 0x3f, 0x44, 0x40, 0x20 }, { 0x3c, 0x40, 0x40, 0x20, 0x7c }, // t u
+    { 0x1c, 0x20, 0x40, 0x20, 0x1c }, { 0x3c, 0x40, 0x30, 0x40, 0x3c }, // v w
+    { 0x44, 0x28, 0x10, 0x28, 0x44 }, { 0x0c, 0x50, 0x50, 0x50, 0x3c }, // x y
+    { 0x44, 0x64, 0x54, 0x4c, 0x44 }, { 0x00, 0x08, 0x36, 0x41, 0x00 }, // z {
+    { 0x00, 0x00, 0x7f, 0x00, 0x00 }, { 0x00, 0x41, 0x36, 0x08, 0x00 }, // | }
+    { 0x08, 0x04, 0x08, 0x10, 0x08 },                                   // ~
+};
+
+static const QRgb background = 0xa0000000;
+static const QRgb foreground = 0xffffffff;
+static const QRgb overbudget = 0xffff4040;
+
+static const QRgb palette[] =
+{
+    0xff4e79a7, 0xfff28e2b, 0xff59a14f, 0xffedc948,
+    0xffb07aa1, 0xff76b7b2, 0xffff9da7, 0xff9c755f,
+};
+
+// Glyphs are 5x7 font pixels with one pixel of spacing; rows are padded so
+// that bars and text line up
+static const int glyph_w = 6;
+static const int row_h = 10;
+static const int margin = 2;
+
+XeProfilerOverlay::XeProfilerOverlay(int width, int scale)
+        : m_width(width), m_scale(scale > 0 ? scale : 1), m_budget(1.f / 60.f)
+{ }
+
+float XeProfilerOverlay::budget() const
+{
+    return m_budget;
+}
+
+void XeProfilerOverlay::setBudget(float b)
+{
+    m_budget = b;
+}
+
+const QImage &XeProfilerOverlay::image() const
+{
+    return m_image;
+}
+
+void XeProfilerOverlay::fill(int x, int y, int w, int h, QRgb color)
+{
+    int x1 = qMin(x + w, m_image.width()), y1 = qMin(y + h, m_image.height());
+    x = qMax(x, 0);
+    y = qMax(y, 0);
+
+    for (int row = y; row < y1; ++row)
+    {
+        QRgb *line = (QRgb*)m_image.scanLine(row);
+        for (int col = x; col < x1; ++col)
+            line[col] = color;
+    }
+}
+
+void XeProfilerOverlay::text(int x, int y, const char *str, QRgb color)
+{
+    for (; *str; ++str, x += glyph_w * m_scale)
+    {
+        unsigned char c = (unsigned char)*str;
+        if (c < 0x20 || c > 0x7e)
+            c = '?';
+
+        const unsigned char *glyph = font[c - 0x20];
+        for (int col = 0; col < 5; ++col)
+            for (int row = 0; row < 7; ++row)
+                if (glyph[col] & (1 << row))
+                    fill(x + col * m_scale, y + row * m_scale, m_scale, m_scale, color);
+    }
+}
+
+void XeProfilerOverlay::draw(const XeProfiler &profiler)
+{
+    quint64 frame = profiler.frame() - 1;
+
+    m_sections.clear();
+    profiler.sections(m_sections);
+
+    // Keep only sections sampled in the last frame, in a stable order
+    for (int i = m_sections.count() - 1; i >= 0; --i)
+        if (m_sections[i]->frame() != frame)
+            m_sections.removeAt(i);
+
+    std::sort(m_sections.begin(), m_sections.end(),
+              [](const XeProfilerSection *a, const XeProfilerSection *b) { return strcmp(a->name(), b->name()) < 0; });
+
+    int rows = 1 + m_sections.count();
+    int height = (2 * margin + rows * row_h) * m_scale;
+
+    if (m_image.width() != m_width || m_image.height() != height)
+        m_image = QImage(m_width, height, QImage::Format_ARGB32);
+    m_image.fill(background);
+
+    // Each row: a bar spanning the section's share of the budget (red past
+    // the end of the budget), with the label drawn over it
+    int barw = m_width - 2 * margin * m_scale;
+    char label[128];
+
+    int y = margin * m_scale;
+    snprintf(label, sizeof(label), "Frame %.2f ms", 1000.f * profiler.dt());
+    text(margin * m_scale, y + m_scale, label,
+         profiler.dt() > m_budget ? overbudget : foreground);
+    y += row_h * m_scale;
+
+    for (int i = 0; i < m_sections.count(); ++i)
+    {
+        const XeProfilerSection *s = m_sections[i];
+        float share = m_budget > 0.f ? s->dt() / m_budget : 0.f;
+
+        int w = (int)(qMin(share, 1.f) * barw);
+        fill(margin * m_scale, y, w, (row_h - 1) * m_scale,
+             share > 1.f ? overbudget : palette[i % (sizeof(palette) / sizeof(palette[0]))]);
+
+        snprintf(label, sizeof(label), "%s %.2f ms", s->name(), 1000.f * s->dt());
+        text((margin + 1) * m_scale, y + m_scale, label, foreground);
+
+        y += row_h * m_scale;
+    }
+}
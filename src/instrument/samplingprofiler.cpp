@@ -0,0 +1,338 @@
+
+#include "xe/samplingprofiler.h"
+#include "xe/trace.h"
+
+#include <QAtomicPointer>
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QThread>
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__) && defined(__GLIBC__)
+#   define XE_SAMPLING_SUPPORTED 1
+#   include <cerrno>
+#   include <csignal>
+#   include <ctime>
+#   include <cxxabi.h>
+#   include <dlfcn.h>
+#   include <execinfo.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#   ifndef sigev_notify_thread_id
+#       define sigev_notify_thread_id _sigev_un._tid
+#   endif
+#else
+#   define XE_SAMPLING_SUPPORTED 0
+#endif
+
+// The profiler currently receiving samples, and the number of signal handlers
+// that may be writing into its buffer. stop() clears the former and then waits
+// for the latter to drain before the buffer can be read or freed
+static QAtomicPointer<XeSamplingProfiler> s_active;
+static QAtomicInt s_inflight;
+
+#if XE_SAMPLING_SUPPORTED
+
+/** Records one sample from inside the SIGPROF handler. Everything here has to
+  * be async-signal-safe: no locks, no allocation, no Qt containers
+  */
+struct XeSamplingProfilerHandler
+{
+    static void sample(int, siginfo_t *, void *)
+    {
+        int saved = errno;
+        s_inflight.ref();
+
+        XeSamplingProfiler *p = s_active.loadAcquire();
+        if (p)
+        {
+            // The first two frames are this handler and the kernel's signal
+            // trampoline; the interrupted code starts at frames[2]
+            void *frames[XeSamplingProfiler::MAX_DEPTH + 2];
+            int depth = backtrace(frames, XeSamplingProfiler::MAX_DEPTH + 2) - 2;
+
+            if (depth > 0)
+            {
+                int size = depth + 1;
+                int at = p->m_used.loadAcquire() + size <= p->m_capacity
+                       ? p->m_used.fetchAndAddOrdered(size) : p->m_capacity;
+
+                if (at + size <= p->m_capacity)
+                {
+                    p->m_buffer[at] = (void*)(quintptr)depth;
+                    for (int i = 0; i < depth; ++i)
+                        p->m_buffer[at + 1 + i] = frames[2 + i];
+
+                    p->m_samples.ref();
+                }
+                else
+                {
+                    p->m_dropped.ref();
+                }
+            }
+        }
+
+        s_inflight.deref();
+        errno = saved;
+    }
+};
+
+static QByteArray symbolize(void *addr)
+{
+    Dl_info info;
+    if (!dladdr(addr, &info) || (!info.dli_sname && !info.dli_fname))
+        return QByteArray("0x") + QByteArray::number((quintptr)addr, 16);
+
+    if (info.dli_sname)
+    {
+        int status = 0;
+        char *demangled = abi::__cxa_demangle(info.dli_sname, 0, 0, &status);
+        if (status == 0 && demangled)
+        {
+            QByteArray name(demangled);
+            free(demangled);
+            return name;
+        }
+
+        return QByteArray(info.dli_sname);
+    }
+
+    // Not an exported symbol (e.g. static, or the executable wasn't linked
+    // with -rdynamic): fall back to the module and offset
+    const char *module = strrchr(info.dli_fname, '/');
+    module = module ? module + 1 : info.dli_fname;
+
+    return QByteArray(module) + "+0x" +
+           QByteArray::number((quintptr)addr - (quintptr)info.dli_fbase, 16);
+}
+
+#endif // XE_SAMPLING_SUPPORTED
+
+XeSamplingProfiler::XeSamplingProfiler(int capacity)
+        : m_buffer(new void*[capacity]), m_capacity(capacity), m_used(0),
+          m_samples(0), m_dropped(0), m_interval(0)
+{ }
+
+XeSamplingProfiler::~XeSamplingProfiler()
+{
+    stop();
+    delete[] m_buffer;
+}
+
+bool XeSamplingProfiler::isSupported()
+{
+    return XE_SAMPLING_SUPPORTED;
+}
+
+bool XeSamplingProfiler::start(int hz)
+{
+#if XE_SAMPLING_SUPPORTED
+    if (hz < 1)
+        hz = 1;
+    m_interval = 1000000000 / hz;
+
+    if (!s_active.testAndSetOrdered(0, this))
+    {
+        xe_trace.warn << "XeSamplingProfiler::start(): another sampling profiler is already running";
+        return false;
+    }
+
+    // backtrace() loads the unwinder lazily on first use, which isn't safe to
+    // do inside a signal handler
+    void *prime[1];
+    backtrace(prime, 1);
+
+    // The handler stays installed after stop(): a SIGPROF that's already
+    // pending when the timers are deleted would otherwise terminate the
+    // process. With no active profiler, the handler does nothing
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = &XeSamplingProfilerHandler::sample;
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGPROF, &sa, 0);
+
+    // Give up the active slot if the timer can't be created, so this or
+    // another profiler can start later
+    if (!attach())
+    {
+        stop();
+        return false;
+    }
+
+    return true;
+#else
+    (void)hz;
+    xe_trace.warn << "XeSamplingProfiler::start(): sampling is not supported on this platform";
+    return false;
+#endif
+}
+
+void XeSamplingProfiler::stop()
+{
+    QMutexLocker lock(&m_lock);
+
+#if XE_SAMPLING_SUPPORTED
+    foreach (const Timer &t, m_timers)
+        timer_delete((timer_t)t.timer);
+#endif
+    m_timers.clear();
+
+    if (s_active.testAndSetOrdered(this, 0))
+        while (s_inflight.loadAcquire())
+            QThread::yieldCurrentThread();
+}
+
+bool XeSamplingProfiler::isRunning() const
+{
+    return s_active.loadAcquire() == this;
+}
+
+bool XeSamplingProfiler::attach()
+{
+#if XE_SAMPLING_SUPPORTED
+    QMutexLocker lock(&m_lock);
+
+    if (!isRunning())
+    {
+        xe_trace.warn << "XeSamplingProfiler::attach(): the profiler isn't running";
+        return false;
+    }
+
+    Qt::HANDLE thread = QThread::currentThreadId();
+    foreach (const Timer &t, m_timers)
+        if (t.thread == thread)
+            return true;
+
+    // A per-thread CPU-time clock only advances while the thread runs, and
+    // SIGEV_THREAD_ID delivers the signal to that same thread
+    struct sigevent ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.sigev_notify = SIGEV_THREAD_ID;
+    ev.sigev_signo = SIGPROF;
+    ev.sigev_notify_thread_id = (pid_t)syscall(SYS_gettid);
+
+    timer_t timer;
+    if (timer_create(CLOCK_THREAD_CPUTIME_ID, &ev, &timer) != 0)
+    {
+        xe_trace.error << QString("XeSamplingProfiler::attach(): timer_create failed (%1)").arg(strerror(errno));
+        return false;
+    }
+
+    struct itimerspec spec;
+    spec.it_interval.tv_sec = m_interval / 1000000000;
+    spec.it_interval.tv_nsec = m_interval % 1000000000;
+    spec.it_value = spec.it_interval;
+    timer_settime(timer, 0, &spec, 0);
+
+    Timer t;
+    t.thread = thread;
+    t.timer = (void*)timer;
+    m_timers.append(t);
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void XeSamplingProfiler::detach()
+{
+    QMutexLocker lock(&m_lock);
+
+    Qt::HANDLE thread = QThread::currentThreadId();
+    for (int i = 0; i < m_timers.count(); ++i)
+    {
+        if (m_timers[i].thread == thread)
+        {
+#if XE_SAMPLING_SUPPORTED
+            timer_delete((timer_t)m_timers[i].timer);
+#endif
+            m_timers.removeAt(i);
+            return;
+        }
+    }
+}
+
+int XeSamplingProfiler::samples() const
+{
+    return m_samples.loadAcquire();
+}
+
+int XeSamplingProfiler::dropped() const
+{
+    return m_dropped.loadAcquire();
+}
+
+void XeSamplingProfiler::clear()
+{
+    xe_assert(!isRunning(), "XeSamplingProfiler::clear() called while sampling");
+
+    m_used.storeRelease(0);
+    m_samples.storeRelease(0);
+    m_dropped.storeRelease(0);
+}
+
+bool XeSamplingProfiler::writeFolded(const char *path) const
+{
+    xe_assert(!isRunning(), "XeSamplingProfiler::writeFolded() called while sampling");
+
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        xe_trace.error << QString("XeSamplingProfiler: could not open %1 for writing").arg(path);
+        return false;
+    }
+
+#if XE_SAMPLING_SUPPORTED
+    QHash<void*, QByteArray> symbols;
+    QHash<QByteArray, int> stacks;
+
+    int used = qMin(m_used.loadAcquire(), m_capacity);
+    for (int at = 0; at < used; )
+    {
+        int depth = (int)(quintptr)m_buffer[at];
+        if (depth <= 0 || at + 1 + depth > used)
+            break;
+
+        // backtrace() lists the innermost frame first; folded stacks start
+        // from the outermost one
+        QByteArray stack;
+        for (int i = depth - 1; i >= 0; --i)
+        {
+            // Return addresses point past the call instruction, so look up
+            // the byte before them. Only the innermost frame is an exact PC
+            void *addr = m_buffer[at + 1 + i];
+            void *lookup = i > 0 ? (void*)((char*)addr - 1) : addr;
+
+            if (!symbols.contains(lookup))
+                symbols[lookup] = symbolize(lookup).replace(';', ':');
+
+            if (!stack.isEmpty())
+                stack += ';';
+            stack += symbols[lookup];
+        }
+
+        ++stacks[stack];
+        at += depth + 1;
+    }
+
+    QTextStream out(&file);
+    QHashIterator<QByteArray, int> it(stacks);
+    while (it.hasNext())
+    {
+        it.next();
+        out << it.key() << " " << it.value() << "\n";
+    }
+
+    out.flush();
+    return out.status() == QTextStream::Ok;
+#else
+    return true;
+#endif
+}
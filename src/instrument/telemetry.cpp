@@ -0,0 +1,369 @@
+
+#include "xe/metrics.h"
+#include "xe/profiler.h"
+#include "xe/telemetry.h"
+#include "xe/trace.h"
+
+#include <QAtomicInteger>
+#include <QDir>
+#include <QStringList>
+
+#include <atomic>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   define XE_TELEMETRY_SUPPORTED 1
+#   include <cerrno>
+#   include <fcntl.h>
+#   include <signal.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#else
+#   define XE_TELEMETRY_SUPPORTED 0
+#endif
+
+// The layout of the shared memory object. Everything in it is fixed-size, so
+// that both sides agree on it without any negotiation; a reader checks the
+// magic number and version before trusting the rest
+
+static const quint32 telemetry_magic = 0x4d544558; // "XETM"
+static const quint32 telemetry_version = 1;
+
+struct XeTelemetryEntry
+{
+    char name[XeTelemetry::MAX_NAME];
+    quint32 type;
+    double value;
+};
+
+struct XeTelemetrySlot
+{
+    // Odd while the publisher is writing the slot. A reader copies the slot
+    // and accepts the copy only if the counter was even and unchanged
+    QAtomicInteger<quint32> seq;
+    quint32 count;
+    quint64 index;
+    quint64 frame;
+    double dt;
+    XeTelemetryEntry entries[XeTelemetry::MAX_ENTRIES];
+};
+
+struct XeTelemetryBlock
+{
+    quint32 magic;
+    quint32 version;
+    quint32 capacity;
+    quint32 slotSize;
+    qint64 pid;
+    QAtomicInteger<quint64> published;
+    XeTelemetrySlot slots_[1]; // capacity slots follow
+};
+
+static size_t block_size(int capacity)
+{
+    return sizeof(XeTelemetryBlock) + (capacity - 1) * sizeof(XeTelemetrySlot);
+}
+
+static QByteArray default_name(qint64 pid)
+{
+    return QByteArray("xenon-") + QByteArray::number(pid);
+}
+
+static void copy_name(char *dst, const char *src)
+{
+    strncpy(dst, src, XeTelemetry::MAX_NAME - 1);
+    dst[XeTelemetry::MAX_NAME - 1] = '\0';
+}
+
+// Writes a section's path, outermost section first, truncating it to fit
+static void copy_path(char *dst, const XeProfilerSection *s)
+{
+    const XeProfilerSection *path[16];
+    int depth = 0;
+    for (; s && depth < 16; s = s->parent())
+        path[depth++] = s;
+
+    int len = 0;
+    dst[0] = '\0';
+    for (int i = depth - 1; i >= 0 && len < XeTelemetry::MAX_NAME - 1; --i)
+    {
+        if (i != depth - 1)
+            dst[len++] = '/';
+
+        for (const char *c = path[i]->name(); *c && len < XeTelemetry::MAX_NAME - 1; ++c)
+            dst[len++] = *c;
+    }
+    dst[len] = '\0';
+}
+
+XeTelemetryFrame::XeTelemetryFrame() : index(0), frame(0), dt(0.f) { }
+
+XeTelemetry::XeTelemetry(XeProfiler *profiler, XeMetrics *metrics, const char *name, int frames)
+        : m_profiler(profiler), m_metrics(metrics), m_block(0), m_size(0)
+{
+#if XE_TELEMETRY_SUPPORTED
+    if (frames < 1)
+        frames = 1;
+
+    m_name = name ? QByteArray(name) : default_name(getpid());
+    QByteArray path = QByteArray("/") + m_name;
+
+    // Remove a leftover object from a crashed process that had the same pid
+    shm_unlink(path.constData());
+
+    int fd = shm_open(path.constData(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd == -1)
+    {
+        xe_trace.error << QString("XeTelemetry: could not create %1 (%2)").arg(path.constData()).arg(strerror(errno));
+        return;
+    }
+
+    size_t size = block_size(frames);
+    void *mem = MAP_FAILED;
+    if (ftruncate(fd, size) == 0)
+        mem = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (mem == MAP_FAILED)
+    {
+        xe_trace.error << QString("XeTelemetry: could not map %1 (%2)").arg(path.constData()).arg(strerror(errno));
+        shm_unlink(path.constData());
+        return;
+    }
+
+    // The new object is zero-filled, so every slot starts out even and empty.
+    // The magic number goes in last, so readers never see a partial header
+    m_block = (XeTelemetryBlock*)mem;
+    m_size = size;
+    m_block->version = telemetry_version;
+    m_block->capacity = frames;
+    m_block->slotSize = sizeof(XeTelemetrySlot);
+    m_block->pid = getpid();
+    std::atomic_thread_fence(std::memory_order_release);
+    m_block->magic = telemetry_magic;
+#else
+    (void)name;
+    (void)frames;
+    xe_trace.warn << "XeTelemetry: shared memory telemetry is not supported on this platform";
+#endif
+}
+
+XeTelemetry::~XeTelemetry()
+{
+#if XE_TELEMETRY_SUPPORTED
+    if (m_block)
+    {
+        munmap(m_block, m_size);
+        shm_unlink((QByteArray("/") + m_name).constData());
+    }
+#endif
+}
+
+bool XeTelemetry::isOpen() const
+{
+    return m_block != 0;
+}
+
+const QByteArray &XeTelemetry::name() const
+{
+    return m_name;
+}
+
+void XeTelemetry::update(float)
+{
+    if (!m_block)
+        return;
+
+    quint64 index = m_block->published.loadAcquire();
+    XeTelemetrySlot &slot = m_block->slots_[index % m_block->capacity];
+
+    slot.seq.fetchAndAddRelaxed(1);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // The profiler has already moved on to the next frame
+    quint64 frame = m_profiler->frame() - 1;
+    int n = 0;
+
+    m_profiler->sections(m_sections);
+
+    foreach (const XeProfilerSection *s, m_sections)
+    {
+        if (n == MAX_ENTRIES)
+            break;
+        if (s->frame() != frame)
+            continue;
+
+        XeTelemetryEntry &e = slot.entries[n++];
+        copy_path(e.name, s);
+        e.type = XeTelemetryFrame::SECTION;
+        e.value = s->dt();
+    }
+
+    if (m_metrics)
+    {
+        int count = m_metrics->count();
+        for (XeMetric m = 0; m < count && n < MAX_ENTRIES; ++m)
+        {
+            XeTelemetryEntry &e = slot.entries[n++];
+            copy_name(e.name, m_metrics->name(m));
+            e.type = XeTelemetryFrame::METRIC;
+            e.value = (double)m_metrics->value(m);
+        }
+    }
+
+    slot.count = n;
+    slot.index = index;
+    slot.frame = frame;
+    slot.dt = m_profiler->dt();
+
+    slot.seq.fetchAndAddRelease(1);
+    m_block->published.storeRelease(index + 1);
+}
+
+XeTelemetryReader::XeTelemetryReader() : m_block(0), m_size(0) { }
+
+XeTelemetryReader::~XeTelemetryReader()
+{
+    close();
+}
+
+QList<qint64> XeTelemetryReader::instances()
+{
+    QList<qint64> pids;
+
+#if defined(__linux__)
+    // POSIX shared memory objects live in /dev/shm on Linux
+    QStringList names = QDir("/dev/shm").entryList(QStringList("xenon-*"), QDir::Files);
+    foreach (const QString &name, names)
+    {
+        bool ok = false;
+        qint64 pid = name.mid(6).toLongLong(&ok);
+        if (ok && kill((pid_t)pid, 0) == 0)
+            pids.append(pid);
+    }
+#endif
+
+    return pids;
+}
+
+bool XeTelemetryReader::open(qint64 pid)
+{
+    return open(default_name(pid).constData());
+}
+
+bool XeTelemetryReader::open(const char *name)
+{
+    close();
+
+#if XE_TELEMETRY_SUPPORTED
+    QByteArray path = QByteArray("/") + name;
+    int fd = shm_open(path.constData(), O_RDONLY, 0);
+    if (fd == -1)
+        return false;
+
+    struct stat st;
+    void *mem = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(XeTelemetryBlock))
+        mem = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (mem == MAP_FAILED)
+        return false;
+
+    const XeTelemetryBlock *block = (const XeTelemetryBlock*)mem;
+    if (block->magic != telemetry_magic || block->version != telemetry_version ||
+        block->slotSize != sizeof(XeTelemetrySlot) || block->capacity < 1 ||
+        block_size(block->capacity) > (size_t)st.st_size)
+    {
+        xe_trace.warn << QString("XeTelemetryReader: %1 is not a compatible telemetry channel").arg(name);
+        munmap(mem, st.st_size);
+        return false;
+    }
+
+    m_block = block;
+    m_size = st.st_size;
+    return true;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+void XeTelemetryReader::close()
+{
+#if XE_TELEMETRY_SUPPORTED
+    if (m_block)
+        munmap((void*)m_block, m_size);
+#endif
+
+    m_block = 0;
+    m_size = 0;
+}
+
+bool XeTelemetryReader::isOpen() const
+{
+    return m_block != 0;
+}
+
+qint64 XeTelemetryReader::pid() const
+{
+    return m_block ? m_block->pid : 0;
+}
+
+int XeTelemetryReader::capacity() const
+{
+    return m_block ? (int)m_block->capacity : 0;
+}
+
+quint64 XeTelemetryReader::published() const
+{
+    return m_block ? m_block->published.loadAcquire() : 0;
+}
+
+bool XeTelemetryReader::read(quint64 index, XeTelemetryFrame &out) const
+{
+    if (!m_block)
+        return false;
+
+    const XeTelemetrySlot &slot = m_block->slots_[index % m_block->capacity];
+
+    // The publisher doesn't wait for readers, so a frame can be overwritten
+    // while it is being copied; retry a few times before giving up
+    for (int attempt = 0; attempt < 8; ++attempt)
+    {
+        quint64 published = m_block->published.loadAcquire();
+        if (index >= published || published - index > m_block->capacity)
+            return false;
+
+        quint32 before = slot.seq.loadAcquire();
+        if (before & 1)
+            continue;
+
+        quint32 count = qMin<quint32>(slot.count, XeTelemetry::MAX_ENTRIES);
+        out.index = slot.index;
+        out.frame = slot.frame;
+        out.dt = (float)slot.dt;
+        out.entries.resize(count);
+
+        for (quint32 i = 0; i < count; ++i)
+        {
+            const XeTelemetryEntry &e = slot.entries[i];
+            out.entries[i].name = QByteArray(e.name, qstrnlen(e.name, XeTelemetry::MAX_NAME));
+            out.entries[i].type = (XeTelemetryFrame::Type)e.type;
+            out.entries[i].value = e.value;
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.loadAcquire() == before)
+            return out.index == index;
+    }
+
+    return false;
+}
+
+bool XeTelemetryReader::latest(XeTelemetryFrame &out) const
+{
+    quint64 n = published();
+    return n && read(n - 1, out);
+}
@@ -0,0 +1,64 @@
+
+#include "xe/affinematrix.h"
+
+XeAffineMatrix XeAffineMatrix::FromScaleRotationTranslation(const XeVector3 &scale, const XeQuaternion &rotation, const XeVector3 &translation)
+{
+    return XeAffineMatrix::FromXeMatrix(XeMatrix::FromScaleRotationTranslation(scale, rotation, translation));
+}
+
+XeAffineMatrix XeAffineMatrix::Multiply(const XeAffineMatrix &m1, const XeAffineMatrix &m2)
+{
+    // XeMatrix::Multiply() without the last column, and without the terms
+    // of the last row of m2 that would only add zeroes
+    XeAffineMatrix m;
+    for (int i = 0; i < 12; i += 3)
+    {
+        m.m[i] = ((m1.m[i] * m2.m11) + (m1.m[i + 1] * m2.m21)) + (m1.m[i + 2] * m2.m31);
+        m.m[i + 1] = ((m1.m[i] * m2.m12) + (m1.m[i + 1] * m2.m22)) + (m1.m[i + 2] * m2.m32);
+        m.m[i + 2] = ((m1.m[i] * m2.m13) + (m1.m[i + 1] * m2.m23)) + (m1.m[i + 2] * m2.m33);
+    }
+
+    m.m41 += m2.m41;
+    m.m42 += m2.m42;
+    m.m43 += m2.m43;
+    return m;
+}
+
+XeAffineMatrix XeAffineMatrix::Invert(const XeAffineMatrix &m)
+{
+    // The linear part is inverted with its adjugate, and the inverse
+    // translation is the translation, negated and transformed by that
+    float c1 = (m.m22 * m.m33) - (m.m23 * m.m32);
+    float c2 = (m.m23 * m.m31) - (m.m21 * m.m33);
+    float c3 = (m.m21 * m.m32) - (m.m22 * m.m31);
+    float d = 1.f / (((m.m11 * c1) + (m.m12 * c2)) + (m.m13 * c3));
+
+    XeAffineMatrix i;
+    i.m11 = c1 * d;
+    i.m12 = ((m.m13 * m.m32) - (m.m12 * m.m33)) * d;
+    i.m13 = ((m.m12 * m.m23) - (m.m13 * m.m22)) * d;
+    i.m21 = c2 * d;
+    i.m22 = ((m.m11 * m.m33) - (m.m13 * m.m31)) * d;
+    i.m23 = ((m.m13 * m.m21) - (m.m11 * m.m23)) * d;
+    i.m31 = c3 * d;
+    i.m32 = ((m.m12 * m.m31) - (m.m11 * m.m32)) * d;
+    i.m33 = ((m.m11 * m.m22) - (m.m12 * m.m21)) * d;
+
+    i.m41 = -(((m.m41 * i.m11) + (m.m42 * i.m21)) + (m.m43 * i.m31));
+    i.m42 = -(((m.m41 * i.m12) + (m.m42 * i.m22)) + (m.m43 * i.m32));
+    i.m43 = -(((m.m41 * i.m13) + (m.m42 * i.m23)) + (m.m43 * i.m33));
+    return i;
+}
+
+XeAffineMatrix XeAffineMatrix::InvertOrthonormal(const XeAffineMatrix &m)
+{
+    XeAffineMatrix i(m.m11, m.m21, m.m31,
+                     m.m12, m.m22, m.m32,
+                     m.m13, m.m23, m.m33,
+                     0, 0, 0);
+
+    i.m41 = -(((m.m41 * m.m11) + (m.m42 * m.m12)) + (m.m43 * m.m13));
+    i.m42 = -(((m.m41 * m.m21) + (m.m42 * m.m22)) + (m.m43 * m.m23));
+    i.m43 = -(((m.m41 * m.m31) + (m.m42 * m.m32)) + (m.m43 * m.m33));
+    return i;
+}
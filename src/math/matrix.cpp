@@ -5,57 +5,10 @@
 #include "xe/vector3.h"
 #include "xe/vector4.h"
 #include "xe/quaternion.h"
+#include "xe/matrixa.h"
 
 #include <cmath>    // sin(), cos()
 
-XeMatrix __m_identity (1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1);
-XeMatrix __m_zero     (0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
-
-const XeMatrix& XeMatrix::Identity()
-{
-    return __m_identity;
-}
-
-const XeMatrix& XeMatrix::Zero()
-{
-    return __m_zero;
-}
-
-XeVector3 XeMatrix::Up(const XeMatrix &m)
-{
-    return XeVector3(m.m21, m.m22, m.m23);
-}
-
-XeVector3 XeMatrix::Down(const XeMatrix &m)
-{
-    return XeVector3(-m.m21, -m.m22, -m.m23);
-}
-
-XeVector3 XeMatrix::Left(const XeMatrix &m)
-{
-    return XeVector3(-m.m11, -m.m12, -m.m13);
-}
-
-XeVector3 XeMatrix::Right(const XeMatrix &m)
-{
-    return XeVector3(m.m11, m.m12, m.m13);
-}
-
-XeVector3 XeMatrix::Forward(const XeMatrix &m)
-{
-    return XeVector3(-m.m31, -m.m32, -m.m33);
-}
-
-XeVector3 XeMatrix::Backward(const XeMatrix &m)
-{
-    return XeVector3(m.m31, m.m32, m.m33);
-}
-
-XeVector3 XeMatrix::Translation(const XeMatrix &m)
-{
-    return XeVector3(m.m41, m.m42, m.m43);
-}
-
 XeMatrix XeMatrix::Billboard(const XeVector3 &objectPos, const XeVector3 &cameraPos, const XeVector3 &up)
 {
     XeVector3 z = (objectPos - cameraPos).normalize();
@@ -119,6 +72,31 @@ XeMatrix XeMatrix::FromYawPitchRoll(float yaw, float pitch, float roll)
     return XeMatrix::FromXeQuaternion(XeQuaternion::FromYawPitchRoll(yaw, pitch, roll));
 }
 
+XeMatrix XeMatrix::FromScaleRotationTranslation(const XeVector3 &scale, const XeQuaternion &rotation, const XeVector3 &translation)
+{
+    // Scaling first multiplies the rotation's rows, and translating last
+    // sets the bottom row
+    XeMatrix m = XeMatrix::FromXeQuaternion(rotation);
+    for (int j = 0; j < 3; ++j)
+    {
+        m.m[j] *= scale.x;
+        m.m[4 + j] *= scale.y;
+        m.m[8 + j] *= scale.z;
+    }
+
+    m.m41 = translation.x;
+    m.m42 = translation.y;
+    m.m43 = translation.z;
+    return m;
+}
+
+void XeMatrix::FromScaleRotationTranslation(const XeVector3 *scales, const XeQuaternion *rotations, const XeVector3 *translations,
+                                            XeMatrix *out, int count)
+{
+    for (int i = 0; i < count; ++i)
+        out[i] = XeMatrix::FromScaleRotationTranslation(scales[i], rotations[i], translations[i]);
+}
+
 XeMatrix XeMatrix::LookAt(const XeVector3 &cameraPos, const XeVector3 &targetPos, const XeVector3 &up)
 {
     XeVector3 z = (cameraPos - targetPos).normalize();
@@ -158,30 +136,6 @@ XeMatrix XeMatrix::PerspectiveFieldOfView(float fieldOfView, float aspectRatio,
                   0,      0,     (znear * zfar) / (znear - zfar),  0);
 }
 
-XeMatrix XeMatrix::Scale(float a)
-{
-    return XeMatrix(a, 0, 0, 0,
-                  0, a, 0, 0,
-                  0, 0, a, 0,
-                  0, 0, 0, 1);
-}
-
-XeMatrix XeMatrix::Scale(const XeVector3 &a)
-{
-    return XeMatrix(a.x, 0,   0,   0,
-                  0,   a.y, 0,   0,
-                  0,   0,   a.z, 0,
-                  0,   0,   0,   1);
-}
-
-XeMatrix XeMatrix::Scale(float x, float y, float z)
-{
-    return XeMatrix(x, 0, 0, 0,
-                  0, y, 0, 0,
-                  0, 0, z, 0,
-                  0, 0, 0, 1);
-}
-
 XeMatrix XeMatrix::RotateX(float angle)
 {
     float sinTheta = sin(angle);
@@ -215,78 +169,11 @@ XeMatrix XeMatrix::RotateZ(float angle)
                   0,         0,        0, 1);
 }
 
-XeMatrix XeMatrix::Translate(const XeVector2 &a)
-{
-    return XeMatrix(  1,   0, 0, 0,
-                    0,   1, 0, 0,
-                    0,   0, 1, 0,
-                  a.x, a.y, 0, 1);
-}
-
-XeMatrix XeMatrix::Translate(const XeVector3 &a)
-{
-    return XeMatrix(  1,   0,   0, 0,
-                    0,   1,   0, 0,
-                    0,   0,   1, 0,
-                  a.x, a.y, a.z, 1);
-}
-
-XeMatrix XeMatrix::Translate(const XeVector4 &a)
-{
-    return XeMatrix(  1,   0,   0, 0,
-                    0,   1,   0, 0,
-                    0,   0,   1, 0,
-                  a.x, a.y, a.z, 1);
-}
-
-XeMatrix XeMatrix::Translate(float x, float y)
-{
-    return XeMatrix(1, 0, 0, 0,
-                  0, 1, 0, 0,
-                  0, 0, 1, 0,
-                  x, y, 0, 1);
-}
-
-XeMatrix XeMatrix::Translate(float x, float y, float z)
-{
-    return XeMatrix(1, 0, 0, 0,
-                  0, 1, 0, 0,
-                  0, 0, 1, 0,
-                  x, y, z, 1);
-}
-
-XeMatrix XeMatrix::Add(const XeMatrix &m1, const XeMatrix &m2)
-{
-    XeMatrix m;
-
-    for (int i = 0; i < 16; ++i)
-        m.m[i] = m1.m[i] + m2.m[i];
-
-    return m;
-}
-
-XeMatrix XeMatrix::Subtract(const XeMatrix &m1, const XeMatrix &m2)
-{
-    XeMatrix m;
-
-    for (int i = 0; i < 16; ++i)
-        m.m[i] = m1.m[i] - m2.m[i];
-
-    return m;
-}
-
-XeMatrix XeMatrix::Multiply(const XeMatrix &m, float a)
-{
-    XeMatrix out;
-
-    for (int i = 0; i < 16; ++i)
-        out.m[i] = a * m.m[i];
-
-    return out;
-}
-
 XeMatrix XeMatrix::Multiply(const XeMatrix &m1, const XeMatrix &m2)
 {
+#if XE_SIMD != XE_SIMD_SCALAR
+    return XeMatrixA::Multiply(m1, m2).packed();
+#else
     XeMatrix m;
     m.m11 = (((m1.m11 * m2.m11) + (m1.m12 * m2.m21)) + (m1.m13 * m2.m31)) + (m1.m14 * m2.m41);
     m.m12 = (((m1.m11 * m2.m12) + (m1.m12 * m2.m22)) + (m1.m13 * m2.m32)) + (m1.m14 * m2.m42);
@@ -306,31 +193,130 @@ XeMatrix XeMatrix::Multiply(const XeMatrix &m1, const XeMatrix &m2)
     m.m44 = (((m1.m41 * m2.m14) + (m1.m42 * m2.m24)) + (m1.m43 * m2.m34)) + (m1.m44 * m2.m44);
 
     return m;
+#endif
 }
 
-XeMatrix XeMatrix::Divide(const XeMatrix &m, float amount)
+#if XE_SIMD != XE_SIMD_SCALAR
+
+// 2x2 matrices are held in one register as (a11, a12, a21, a22)
+
+// Computes A * B
+static inline XeFloat4 mat2_mul(XeFloat4 a, XeFloat4 b)
 {
-    return XeMatrix::Multiply(m, 1.f / amount);
+    return XeSimd::add(XeSimd::mul(a, XeSimd::shuffle<0, 3, 0, 3>(b, b)),
+                       XeSimd::mul(XeSimd::shuffle<1, 0, 3, 2>(a, a), XeSimd::shuffle<2, 1, 2, 1>(b, b)));
 }
 
-XeMatrix XeMatrix::Negate(const XeMatrix &m)
+// Computes adj(A) * B
+static inline XeFloat4 mat2_adj_mul(XeFloat4 a, XeFloat4 b)
 {
-    return XeMatrix::Multiply(m, -1.f);
+    return XeSimd::sub(XeSimd::mul(XeSimd::shuffle<3, 3, 0, 0>(a, a), b),
+                       XeSimd::mul(XeSimd::shuffle<1, 1, 2, 2>(a, a), XeSimd::shuffle<2, 3, 0, 1>(b, b)));
 }
 
-bool XeMatrix::Equal(const XeMatrix &m1, const XeMatrix &m2, float epsilon)
+// Computes A * adj(B)
+static inline XeFloat4 mat2_mul_adj(XeFloat4 a, XeFloat4 b)
 {
-    for (int i = 0; i < 16; i++)
-        if (fabs(m1.m[i] - m2.m[i]) > epsilon)
-            return false;
-    return true;
+    return XeSimd::sub(XeSimd::mul(a, XeSimd::shuffle<3, 0, 3, 0>(b, b)),
+                       XeSimd::mul(XeSimd::shuffle<1, 0, 3, 2>(a, a), XeSimd::shuffle<2, 1, 2, 1>(b, b)));
 }
 
-bool XeMatrix::NotEqual(const XeMatrix &m1, const XeMatrix &m2, float epsilon)
+// Splits a matrix into 2x2 blocks | A B | and computes the terms of its
+//                                 | C D |
+// determinant, which the inverse also needs
+struct MatrixBlocks
 {
-    return !XeMatrix::Equal(m1, m2, epsilon);
+    XeFloat4 a, b, c, d;
+    XeFloat4 detA, detB, detC, detD;
+    /** adj(A) * B and adj(D) * C */
+    XeFloat4 ab, dc;
+    /** The determinant of the whole matrix, in every lane */
+    XeFloat4 det;
+
+    MatrixBlocks(const XeFloat4 *rows)
+    {
+        XeFloat4 r1 = rows[0];
+        XeFloat4 r2 = rows[1];
+        XeFloat4 r3 = rows[2];
+        XeFloat4 r4 = rows[3];
+
+        a = XeSimd::shuffle<0, 1, 0, 1>(r1, r2);
+        b = XeSimd::shuffle<2, 3, 2, 3>(r1, r2);
+        c = XeSimd::shuffle<0, 1, 0, 1>(r3, r4);
+        d = XeSimd::shuffle<2, 3, 2, 3>(r3, r4);
+
+        // (|A|, |B|, |C|, |D|)
+        XeFloat4 dets = XeSimd::sub(
+                XeSimd::mul(XeSimd::shuffle<0, 2, 0, 2>(r1, r3), XeSimd::shuffle<1, 3, 1, 3>(r2, r4)),
+                XeSimd::mul(XeSimd::shuffle<1, 3, 1, 3>(r1, r3), XeSimd::shuffle<0, 2, 0, 2>(r2, r4)));
+        detA = XeSimd::lane<0>(dets);
+        detB = XeSimd::lane<1>(dets);
+        detC = XeSimd::lane<2>(dets);
+        detD = XeSimd::lane<3>(dets);
+
+        ab = mat2_adj_mul(a, b);
+        dc = mat2_adj_mul(d, c);
+
+        // |M| = |A||D| + |B||C| - tr(adj(A) B adj(D) C)
+        XeFloat4 tr = XeSimd::mul(ab, XeSimd::shuffle<0, 2, 1, 3>(dc, dc));
+        tr = XeSimd::add(tr, XeSimd::shuffle<2, 3, 0, 1>(tr, tr));
+        tr = XeSimd::add(tr, XeSimd::shuffle<1, 0, 3, 2>(tr, tr));
+
+        det = XeSimd::sub(XeSimd::add(XeSimd::mul(detA, detD), XeSimd::mul(detB, detC)), tr);
+    }
+};
+
+float XeMatrixA::Determinant(const XeMatrixA &m)
+{
+    return XeSimd::first(MatrixBlocks(m.r).det);
+}
+
+XeMatrixA XeMatrixA::Invert(const XeMatrixA &m)
+{
+    // The inverse in blocks is 1/|M| | X Y |, where
+    //                                | Z W |
+    //   adj(X) = |D|A - B adj(D) C      adj(Y) = |B|C - D adj(adj(A) B)
+    //   adj(Z) = |C|B - A adj(adj(D) C) adj(W) = |A|D - C adj(A) B
+    MatrixBlocks k(m.r);
+
+    XeFloat4 x = XeSimd::sub(XeSimd::mul(k.detD, k.a), mat2_mul(k.b, k.dc));
+    XeFloat4 w = XeSimd::sub(XeSimd::mul(k.detA, k.d), mat2_mul(k.c, k.ab));
+    XeFloat4 y = XeSimd::sub(XeSimd::mul(k.detB, k.c), mat2_mul_adj(k.d, k.ab));
+    XeFloat4 z = XeSimd::sub(XeSimd::mul(k.detC, k.b), mat2_mul_adj(k.a, k.dc));
+
+    // The signs of the adjugates are applied with the division by |M|, and
+    // their shuffles with the shuffles back into rows
+    XeFloat4 scale = XeSimd::div(XeSimd::set(1.f, -1.f, -1.f, 1.f), k.det);
+    x = XeSimd::mul(x, scale);
+    y = XeSimd::mul(y, scale);
+    z = XeSimd::mul(z, scale);
+    w = XeSimd::mul(w, scale);
+
+    XeMatrixA i;
+    i.r[0] = XeSimd::shuffle<3, 1, 3, 1>(x, y);
+    i.r[1] = XeSimd::shuffle<2, 0, 2, 0>(x, y);
+    i.r[2] = XeSimd::shuffle<3, 1, 3, 1>(z, w);
+    i.r[3] = XeSimd::shuffle<2, 0, 2, 0>(z, w);
+    return i;
+}
+
+float XeMatrix::Determinant(const XeMatrix &m)
+{
+    return XeMatrixA::Determinant(m);
+}
+
+XeMatrix XeMatrix::Invert(const XeMatrix &m)
+{
+    return XeMatrixA::Invert(m).packed();
+}
+
+XeMatrix XeMatrix::Transpose(const XeMatrix &m)
+{
+    return XeMatrixA::Transpose(m).packed();
 }
 
+#else
+
 float XeMatrix::Determinant(const XeMatrix &m)
 {
     float d1 = (m.m33 * m.m44) - (m.m34 * m.m43);
@@ -408,253 +394,16 @@ XeMatrix XeMatrix::Transpose(const XeMatrix &m)
     return t;
 }
 
-XeMatrix XeMatrix::Lerp(const XeMatrix &m1, const XeMatrix &m2, float amount)
-{
-    return XeMatrix::Add(XeMatrix::Multiply(m1, 1.f - amount), XeMatrix::Multiply(m2, amount));
-}
-
-XeMatrix::XeMatrix()
-{
-    m11 = m22 = m33 = m44 = 1;
-    m12 = m13 = m14 = m21 = m23 = m24 = m31 = m32 = m34 = m41 = m42 = m43 = 0;
-}
-
-XeMatrix::XeMatrix(float m11, float m12, float m13, float m14,
-               float m21, float m22, float m23, float m24,
-               float m31, float m32, float m33, float m34,
-               float m41, float m42, float m43, float m44)
-{
-    this->m11 = m11;
-    this->m12 = m12;
-    this->m13 = m13;
-    this->m14 = m14;
-    this->m21 = m21;
-    this->m22 = m22;
-    this->m23 = m23;
-    this->m24 = m24;
-    this->m31 = m31;
-    this->m32 = m32;
-    this->m33 = m33;
-    this->m34 = m34;
-    this->m41 = m41;
-    this->m42 = m42;
-    this->m43 = m43;
-    this->m44 = m44;
-}
-
-XeVector3 XeMatrix::up() const
-{
-    return XeMatrix::Up(*this);
-}
-
-XeVector3 XeMatrix::down() const
-{
-    return XeMatrix::Down(*this);
-}
-
-XeVector3 XeMatrix::left() const
-{
-    return XeMatrix::Left(*this);
-}
-
-XeVector3 XeMatrix::right() const
-{
-    return XeMatrix::Right(*this);
-}
-
-XeVector3 XeMatrix::forward() const
-{
-    return XeMatrix::Forward(*this);
-}
-
-XeVector3 XeMatrix::backward() const
-{
-    return XeMatrix::Backward(*this);
-}
-
-XeVector3 XeMatrix::translation() const
-{
-    return XeMatrix::Translation(*this);
-}
-
-XeMatrix XeMatrix::scale(float amount) const
-{
-    return *this * XeMatrix::Scale(amount);
-}
-
-XeMatrix XeMatrix::scale(const XeVector3 &amounts) const
-{
-    return *this * XeMatrix::Scale(amounts);
-}
-
-XeMatrix XeMatrix::rotateX(float angle) const
-{
-    return *this * XeMatrix::RotateX(angle);
-}
-
-XeMatrix XeMatrix::rotateY(float angle) const
-{
-    return *this * XeMatrix::RotateY(angle);
-}
-
-XeMatrix XeMatrix::rotateZ(float angle) const
-{
-    return *this * XeMatrix::RotateZ(angle);
-}
-
-XeMatrix XeMatrix::rotate(const XeVector3 &axis, float angle) const
-{
-    return *this * XeMatrix::FromAxisAngle(axis, angle);
-}
-
-XeMatrix XeMatrix::translate(const XeVector2 &amount) const
-{
-    return *this * XeMatrix::Translate(amount);
-}
-
-XeMatrix XeMatrix::translate(const XeVector3 &amount) const
-{
-    return *this * XeMatrix::Translate(amount);
-}
-
-XeMatrix XeMatrix::translate(const XeVector4 &amount) const
-{
-    return *this * XeMatrix::Translate(amount);
-}
-
-XeMatrix XeMatrix::translate(float x, float y) const
-{
-    return *this * XeMatrix::Translate(x, y);
-}
-
-XeMatrix XeMatrix::translate(float x, float y, float z) const
-{
-    return *this * XeMatrix::Translate(x, y, z);
-}
-
-float XeMatrix::determinant() const
-{
-    return XeMatrix::Determinant(*this);
-}
-
-XeMatrix XeMatrix::invert() const
-{
-    return XeMatrix::Invert(*this);
-}
-
-XeMatrix XeMatrix::transpose() const
-{
-    return XeMatrix::Transpose(*this);
-}
-
-bool XeMatrix::operator== (const XeMatrix& rhs) const
-{
-    return XeMatrix::Equal(*this, rhs);
-}
-
-bool XeMatrix::operator!= (const XeMatrix& rhs) const
-{
-    return XeMatrix::NotEqual(*this, rhs);
-}
-
-XeMatrix XeMatrix::operator+ (const XeMatrix& rhs) const
-{
-    return XeMatrix::Add(*this, rhs);
-}
-
-XeMatrix XeMatrix::operator- (const XeMatrix& rhs) const
-{
-    return XeMatrix::Subtract(*this, rhs);
-}
-
-XeMatrix XeMatrix::operator- () const
-{
-    return XeMatrix::Negate(*this);
-}
-
-XeMatrix XeMatrix::operator* (const XeMatrix& rhs) const
-{
-    return XeMatrix::Multiply(*this, rhs);
-}
-
-XeMatrix XeMatrix::operator* (float rhs) const
-{
-    return XeMatrix::Multiply(*this, rhs);
-}
-
-XeMatrix XeMatrix::operator/ (float rhs) const
-{
-    return XeMatrix::Divide(*this, rhs);
-}
-
-XeVector3 XeMatrix::operator* (const XeVector3& rhs) const
-{
-    return XeVector3::Transform(*this, rhs);
-}
-
-XeVector4 XeMatrix::operator* (const XeVector4& rhs) const
-{
-    return XeVector4::Transform(*this, rhs);
-}
-
-XeMatrix& XeMatrix::operator+= (const XeMatrix& rhs)
-{
-    for (int i = 0; i < 16; ++i)
-        m[i] += rhs.m[i];
-
-    return *this;
-}
-
-XeMatrix& XeMatrix::operator-= (const XeMatrix& rhs)
-{
-    for (int i = 0; i < 16; ++i)
-        m[i] -= rhs.m[i];
-
-    return *this;
-}
-
-XeMatrix& XeMatrix::operator*= (const XeMatrix& rhs)
-{
-    m11 = (((m11 * rhs.m11) + (m12 * rhs.m21)) + (m13 * rhs.m31)) + (m14 * rhs.m41);
-    m12 = (((m11 * rhs.m12) + (m12 * rhs.m22)) + (m13 * rhs.m32)) + (m14 * rhs.m42);
-    m13 = (((m11 * rhs.m13) + (m12 * rhs.m23)) + (m13 * rhs.m33)) + (m14 * rhs.m43);
-    m14 = (((m11 * rhs.m14) + (m12 * rhs.m24)) + (m13 * rhs.m34)) + (m14 * rhs.m44);
-    m21 = (((m21 * rhs.m11) + (m22 * rhs.m21)) + (m23 * rhs.m31)) + (m24 * rhs.m41);
-    m22 = (((m21 * rhs.m12) + (m22 * rhs.m22)) + (m23 * rhs.m32)) + (m24 * rhs.m42);
-    m23 = (((m21 * rhs.m13) + (m22 * rhs.m23)) + (m23 * rhs.m33)) + (m24 * rhs.m43);
-    m24 = (((m21 * rhs.m14) + (m22 * rhs.m24)) + (m23 * rhs.m34)) + (m24 * rhs.m44);
-    m31 = (((m31 * rhs.m11) + (m32 * rhs.m21)) + (m33 * rhs.m31)) + (m34 * rhs.m41);
-    m32 = (((m31 * rhs.m12) + (m32 * rhs.m22)) + (m33 * rhs.m32)) + (m34 * rhs.m42);
-    m33 = (((m31 * rhs.m13) + (m32 * rhs.m23)) + (m33 * rhs.m33)) + (m34 * rhs.m43);
-    m34 = (((m31 * rhs.m14) + (m32 * rhs.m24)) + (m33 * rhs.m34)) + (m34 * rhs.m44);
-    m41 = (((m41 * rhs.m11) + (m42 * rhs.m21)) + (m43 * rhs.m31)) + (m44 * rhs.m41);
-    m42 = (((m41 * rhs.m12) + (m42 * rhs.m22)) + (m43 * rhs.m32)) + (m44 * rhs.m42);
-    m43 = (((m41 * rhs.m13) + (m42 * rhs.m23)) + (m43 * rhs.m33)) + (m44 * rhs.m43);
-    m44 = (((m41 * rhs.m14) + (m42 * rhs.m24)) + (m43 * rhs.m34)) + (m44 * rhs.m44);
-
-    return *this;
-}
-
-XeMatrix& XeMatrix::operator*= (float rhs)
-{
-    for (int i = 0; i < 16; ++i)
-        m[i] *= rhs;
-
-    return *this;
-}
-
-XeMatrix& XeMatrix::operator/= (float rhs)
-{
-    return ((*this) *= (1.f / rhs));
-}
+// Without registers to keep the rows in, the packed code does the same work
 
-XeMatrix operator*= (float lhs, const XeMatrix& rhs)
+float XeMatrixA::Determinant(const XeMatrixA &m)
 {
-    return rhs * lhs;
+    return XeMatrix::Determinant(m.packed());
 }
 
-XeMatrix operator/= (float lhs, const XeMatrix& rhs)
+XeMatrixA XeMatrixA::Invert(const XeMatrixA &m)
 {
-    return rhs * (1.f / lhs);
+    return XeMatrixA(XeMatrix::Invert(m.packed()));
 }
 
+#endif
@@ -3,19 +3,6 @@
 
 #include <cmath> // sin, cos, sqrt
 
-XeQuaternion __q_identity(0, 0, 0, 1);
-XeQuaternion __q_zero(0, 0, 0, 0);
-
-const XeQuaternion& XeQuaternion::Identity()
-{
-    return __q_identity;
-}
-
-const XeQuaternion& XeQuaternion::Zero()
-{
-    return __q_zero;
-}
-
 XeQuaternion XeQuaternion::FromAxisAngle(const XeVector3 &axis, float angle)
 {
     XeQuaternion q;
@@ -87,55 +74,6 @@ XeQuaternion XeQuaternion::FromYawPitchRoll(float yaw, float pitch, float roll)
                       ((cosYaw * cosPitch) * cosRoll) + ((sinYaw * sinPitch) * sinRoll));
 }
 
-float XeQuaternion::Length(const XeQuaternion &q)
-{
-    return sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
-}
-
-float XeQuaternion::LengthSquared(const XeQuaternion &q)
-{
-    return q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w;
-}
-
-XeQuaternion XeQuaternion::Normalize(const XeQuaternion &q)
-{
-    float a = 1.f / XeQuaternion::Length(q);
-    return XeQuaternion(q.x * a, q.y * a, q.z * a, q.w * a);
-}
-
-XeQuaternion XeQuaternion::Add(const XeQuaternion &q1, const XeQuaternion &q2)
-{
-    return XeQuaternion(q1.x + q2.x, q1.y + q2.y, q1.z + q2.z, q1.w + q2.w);
-}
-
-XeQuaternion XeQuaternion::Subtract(const XeQuaternion &q1, const XeQuaternion &q2)
-{
-    return XeQuaternion(q1.x - q2.x, q1.y - q2.y, q1.z - q2.z, q1.w - q2.w);
-}
-
-XeQuaternion XeQuaternion::Concatenate(const XeQuaternion &q1, const XeQuaternion &q2)
-{
-    return XeQuaternion::Multiply(q1, q2);
-}
-
-XeQuaternion XeQuaternion::Multiply(const XeQuaternion &q1, const XeQuaternion &q2)
-{
-    float t1 = (q1.y * q2.z) - (q1.z * q2.y);
-    float t2 = (q1.z * q2.x) - (q1.x * q2.z);
-    float t3 = (q1.x * q2.y) - (q1.y * q2.x);
-    float t4 = ((q1.x * q2.x) + (q1.y * q2.y)) + (q1.z * q2.z);
-
-    return XeQuaternion(((q1.x * q2.w) + (q2.x * q1.w)) + t1,
-                      ((q1.y * q2.w) + (q2.y * q1.w)) + t2,
-                      ((q1.z * q2.w) + (q2.z * q1.w)) + t3,
-                      (q1.w * q2.w) - t4);
-}
-
-XeQuaternion XeQuaternion::Multiply(const XeQuaternion &q, float a)
-{
-    return XeQuaternion(q.x * a, q.y * a, q.z * a, q.w * a);
-}
-
 XeQuaternion XeQuaternion::Divide(const XeQuaternion &q1, const XeQuaternion &q2)
 {
     float len = (((q2.x * q2.x) + (q2.y * q2.y)) + (q2.z * q2.z)) + (q2.w * q2.w);
@@ -155,42 +93,6 @@ XeQuaternion XeQuaternion::Divide(const XeQuaternion &q1, const XeQuaternion &q2
                       (q1.w * t4) - t8);
 }
 
-XeQuaternion XeQuaternion::Divide(const XeQuaternion &q, float amount)
-{
-    return XeQuaternion::Multiply(q, 1.f / amount);
-}
-
-XeQuaternion XeQuaternion::Negate(const XeQuaternion &q)
-{
-    return XeQuaternion::Multiply(q, -1.f);
-}
-
-bool XeQuaternion::Equal(const XeQuaternion &q1, const XeQuaternion &q2, float epsilon)
-{
-    for (int i = 0; i < 4; i++)
-        if (fabs(q1.xyzw[i] - q2.xyzw[i]) > epsilon)
-            return false;
-    return true;
-}
-
-bool XeQuaternion::NotEqual(const XeQuaternion &q1, const XeQuaternion &q2, float epsilon)
-{
-    for (int i = 0; i < 4; i++)
-        if (fabs(q1.xyzw[i] - q2.xyzw[i]) > epsilon)
-            return true;
-    return false;
-}
-
-float XeQuaternion::Dot(const XeQuaternion &q1, const XeQuaternion &q2)
-{
-    return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
-}
-
-XeQuaternion XeQuaternion::Lerp(const XeQuaternion &q1, const XeQuaternion &q2, float amount)
-{
-    return XeQuaternion::Add(XeQuaternion::Multiply(q1, 1.f - amount), XeQuaternion::Multiply(q2, amount));
-}
-
 XeQuaternion XeQuaternion::Slerp(const XeQuaternion &q1, const XeQuaternion &q2, float amount)
 {
     float a0 = amount;
@@ -223,151 +125,6 @@ XeQuaternion XeQuaternion::Slerp(const XeQuaternion &q1, const XeQuaternion &q2,
                       n1 * q1.w + a * q2.w);
 }
 
-XeQuaternion XeQuaternion::Invert(const XeQuaternion &q)
-{
-    float f = -1.f / (q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
-    return XeQuaternion(f * q.x, f * q.y, f * q.z, q.w);
-}
-
-XeQuaternion XeQuaternion::Conjugate(const XeQuaternion &q)
-{
-    return XeQuaternion(-q.x, -q.y, -q.z, q.w);
-}
-
-XeQuaternion::XeQuaternion()
-{
-    x = y = z = 0.f;
-    w = 1.f;
-}
-
-XeQuaternion::XeQuaternion(float x, float y, float z, float w)
-{
-    this->x = x;
-    this->y = y;
-    this->z = z;
-    this->w = w;
-}
-
-float XeQuaternion::length() const
-{
-    return XeQuaternion::Length(*this);
-}
-
-float XeQuaternion::lengthSquared() const
-{
-    return XeQuaternion::LengthSquared(*this);
-}
-
-XeQuaternion XeQuaternion::normalize() const
-{
-    return XeQuaternion::Normalize(*this);
-}
-
-float XeQuaternion::dot(const XeQuaternion &other) const
-{
-    return XeQuaternion::Dot(*this, other);
-}
-
-XeQuaternion XeQuaternion::invert() const
-{
-    return XeQuaternion::Invert(*this);
-}
-
-XeQuaternion XeQuaternion::conjugate() const
-{
-    return XeQuaternion::Conjugate(*this);
-}
-
-bool XeQuaternion::operator== (const XeQuaternion& rhs) const
-{
-    return XeQuaternion::Equal(*this, rhs);
-}
-
-bool XeQuaternion::operator!= (const XeQuaternion& rhs) const
-{
-    return XeQuaternion::NotEqual(*this, rhs);
-}
-
-XeQuaternion XeQuaternion::operator+ (const XeQuaternion& rhs) const
-{
-    return XeQuaternion::Add(*this, rhs);
-}
-
-XeQuaternion XeQuaternion::operator- (const XeQuaternion& rhs) const
-{
-    return XeQuaternion::Subtract(*this, rhs);
-}
-
-XeQuaternion XeQuaternion::operator- () const
-{
-    return XeQuaternion::Negate(*this);
-}
-
-XeQuaternion XeQuaternion::operator* (const XeQuaternion& rhs) const
-{
-    return XeQuaternion::Multiply(*this, rhs);
-}
-
-XeQuaternion XeQuaternion::operator* (float rhs) const
-{
-    return XeQuaternion::Multiply(*this, rhs);
-}
-
-XeQuaternion XeQuaternion::operator/ (const XeQuaternion& rhs) const
-{
-    return XeQuaternion::Divide(*this, rhs);
-}
-
-XeQuaternion XeQuaternion::operator/ (float rhs) const
-{
-    return XeQuaternion::Divide(*this, rhs);
-}
-
-XeQuaternion& XeQuaternion::operator+= (const XeQuaternion& rhs)
-{
-    x += rhs.x;
-    y += rhs.y;
-    z += rhs.z;
-    w += rhs.w;
-
-    return *this;
-}
-
-XeQuaternion& XeQuaternion::operator-= (const XeQuaternion& rhs)
-{
-    x -= rhs.x;
-    y -= rhs.y;
-    z -= rhs.z;
-    w -= rhs.w;
-
-    return *this;
-}
-
-XeQuaternion& XeQuaternion::operator*= (const XeQuaternion& rhs)
-{
-    float t1 = (y * rhs.z) - (z * rhs.y);
-    float t2 = (z * rhs.x) - (x * rhs.z);
-    float t3 = (x * rhs.y) - (y * rhs.x);
-    float t4 = ((x * rhs.x) + (y * rhs.y)) + (z * rhs.z);
-
-    x = x * rhs.w + rhs.x * w + t1;
-    y = y * rhs.w + rhs.y * w + t2;
-    z = z * rhs.w + rhs.z * w + t3;
-    w = w * rhs.w - t4;
-
-    return *this;
-}
-
-XeQuaternion& XeQuaternion::operator*= (float a)
-{
-    x *= a;
-    y *= a;
-    z *= a;
-    w *= a;
-
-    return *this;
-}
-
 XeQuaternion& XeQuaternion::operator/= (const XeQuaternion& rhs)
 {
     float len = (((rhs.x * rhs.x) + (rhs.y * rhs.y)) + (rhs.z * rhs.z)) + (rhs.w * rhs.w);
@@ -389,18 +146,3 @@ XeQuaternion& XeQuaternion::operator/= (const XeQuaternion& rhs)
     return *this;
 }
 
-XeQuaternion& XeQuaternion::operator/= (float a)
-{
-    *this *= 1.f / a;
-    return *this;
-}
-
-XeQuaternion operator* (float lhs, const XeQuaternion& rhs)
-{
-    return XeQuaternion::Multiply(rhs, lhs);
-}
-
-XeQuaternion operator/ (float lhs, const XeQuaternion& rhs)
-{
-    return XeQuaternion::Divide(rhs, lhs);
-}
@@ -1,325 +1,137 @@
 
 #include "xe/vector3.h"
+#include "xe/simd.h"
 
-#include <cmath>   // sqrt()
+// The batch transforms below add their terms in the same order as
+// Transform() and TransformNormal(), so they give bit-identical results
 
-static XeVector3 _zero  (0, 0, 0);
-static XeVector3 _one   (1, 1, 1);
-static XeVector3 _unitx (1, 0, 0);
-static XeVector3 _unity (0, 1, 0);
-static XeVector3 _unitz (0, 0, 1);
-
-const XeVector3& XeVector3::Zero()
-{
-    return _zero;
-}
-
-const XeVector3& XeVector3::One()
-{
-    return _one;
-}
-
-const XeVector3& XeVector3::UnitX()
-{
-    return _unitx;
-}
-
-const XeVector3& XeVector3::UnitY()
-{
-    return _unity;
-}
-
-const XeVector3& XeVector3::UnitZ()
-{
-    return _unitz;
-}
-
-float XeVector3::Length(const XeVector3 &v)
-{
-    return sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
-}
-
-float XeVector3::LengthSquared(const XeVector3 &v)
-{
-    return v.x * v.x + v.y * v.y + v.z * v.z;
-}
-
-float XeVector3::Dot(const XeVector3 &v1, const XeVector3 &v2)
-{
-    return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
-}
-
-XeVector3 XeVector3::Cross(const XeVector3 &v1, const XeVector3 &v2)
-{
-    XeVector3 v;
-    v.x = (v1.y * v2.z) - (v1.z - v2.y);
-    v.y = (v1.z - v2.x) - (v1.x - v2.z);
-    v.z = (v1.x - v2.y) - (v1.y - v2.x);
-    return v;
-}
-
-float XeVector3::Distance(const XeVector3 &v1, const XeVector3 &v2)
-{
-    return sqrt((v1.x - v2.x) * (v1.x - v2.x) + (v1.y - v2.y) * (v1.y - v2.y) + (v1.z - v2.z) * (v1.z - v2.z));
-}
-
-float XeVector3::DistanceSquared(const XeVector3 &v1, const XeVector3 &v2)
-{
-    return (v1.x - v2.x) * (v1.x - v2.x) + (v1.y - v2.y) * (v1.y - v2.y) + (v1.z - v2.z) * (v1.z - v2.z);
-}
-
-float XeVector3::ManhattanDistance(const XeVector3 &v1, const XeVector3 &v2)
-{
-    return fabs(v1.x - v2.x) + fabs(v1.y - v2.y) + fabs(v1.z - v2.z);
-}
-
-XeVector3 XeVector3::Normalize(const XeVector3 &v)
-{
-    return XeVector3::Multiply(v, 1.0f / v.length());
-}
-
-XeVector3 XeVector3::Reflect(const XeVector3 &v, const XeVector3 &n)
-{
-    float dot = XeVector3::Dot(v, n);
-
-    XeVector3 r;
-    r.x = v.x - (2.f * dot) * n.x;
-    r.y = v.y - (2.f * dot) * n.y;
-    r.z = v.z - (2.f * dot) * n.z;
-
-    return r;
-}
-
-bool XeVector3::Equal(const XeVector3 &v1, const XeVector3 &v2, float epsilon)
-{
-    return fabs(v1.x - v2.x) < epsilon && fabs(v1.y - v2.y) < epsilon && fabs(v1.z - v2.z) < epsilon;
-}
-
-bool XeVector3::NotEqual(const XeVector3 &v1, const XeVector3 &v2, float epsilon)
-{
-    return !XeVector3::Equal(v1, v2, epsilon);
-}
-
-XeVector3 XeVector3::Add(const XeVector3 &v1, const XeVector3 &v2)
-{
-    return XeVector3(v1.x + v2.x, v1.y + v2.y, v1.z + v2.z);
-}
-
-XeVector3 XeVector3::Subtract(const XeVector3 &v1, const XeVector3 &v2)
-{
-    return XeVector3(v1.x - v2.x, v1.y - v2.y, v1.z - v2.z);
-}
-
-XeVector3 XeVector3::Negate(const XeVector3 &v)
-{
-    return XeVector3(-v.x, -v.y, -v.z);
-}
-
-XeVector3 XeVector3::Multiply(const XeVector3 &v, float amount)
-{
-    return XeVector3(amount * v.x, amount * v.y, amount * v.z);
-}
-
-XeVector3 XeVector3::Divide(const XeVector3 &v, float amount)
+// Steps to the next element of a strided array
+static inline const float *stride(const float *p, int bytes)
 {
-    return XeVector3::Multiply(v, 1.0f / amount);
+    return reinterpret_cast<const float*>(reinterpret_cast<const char*>(p) + bytes);
 }
 
-XeVector3 XeVector3::Lerp(const XeVector3 &v1, const XeVector3 &v2, float amount)
+static inline float *stride(float *p, int bytes)
 {
-    XeVector3 v;
-    v.x = (1.f - amount) * v1.x + amount * v2.x;
-    v.y = (1.f - amount) * v1.y + amount * v2.y;
-    v.z = (1.f - amount) * v1.z + amount * v2.z;
-
-    return v;
-}
-
-XeVector3 XeVector3::Clamp(const XeVector3 &v, const XeVector3 &min, const XeVector3 &max)
-{
-    XeVector3 c = v;
-    if (min.x > c.x) c.x = min.x;
-    if (min.y > c.y) c.y = min.y;
-    if (min.z > c.z) c.z = min.z;
-    if (max.x < c.x) c.x = max.x;
-    if (max.y < c.y) c.y = max.y;
-    if (max.z < c.z) c.z = max.z;
-    return c;
-}
-
-XeVector3 XeVector3::Min(const XeVector3 &v1, const XeVector3 &v2)
-{
-    XeVector3 c = v1;
-    if (c.x > v2.x) c.x = v2.x;
-    if (c.y > v2.y) c.y = v2.y;
-    if (c.z > v2.z) c.z = v2.z;
-    return c;
-}
-
-XeVector3 XeVector3::Max(const XeVector3 &v1, const XeVector3 &v2)
-{
-    XeVector3 c = v1;
-    if (c.x < v2.x) c.x = v2.x;
-    if (c.y < v2.y) c.y = v2.y;
-    if (c.z < v2.z) c.z = v2.z;
-    return c;
-}
-
-XeVector3 XeVector3::Transform(const XeMatrix &m, const XeVector3 &v)
-{
-    return XeVector3(v.x * m.m11 + v.y * m.m21 + v.z * m.m31 + m.m41,
-                   v.x * m.m12 + v.y * m.m22 + v.z * m.m32 + m.m42,
-                   v.x * m.m13 + v.y * m.m23 + v.z * m.m33 + m.m43);
+    return reinterpret_cast<float*>(reinterpret_cast<char*>(p) + bytes);
 }
 
-XeVector3 XeVector3::TransformNormal(const XeMatrix &m, const XeVector3 &v)
+void XeVector3::Transform(const XeMatrix &m, const XeVector3 *in, XeVector3 *out, int count)
 {
-    return XeVector3(v.x * m.m11 + v.y * m.m21 + v.z * m.m31,
-                   v.x * m.m12 + v.y * m.m22 + v.z * m.m32,
-                   v.x * m.m13 + v.y * m.m23 + v.z * m.m33);
+    XeVector3::Transform(m, in->xyz, sizeof(XeVector3), out->xyz, sizeof(XeVector3), count);
 }
 
-XeVector3::XeVector3()
+void XeVector3::TransformNormal(const XeMatrix &m, const XeVector3 *in, XeVector3 *out, int count)
 {
-    x = y = z = 0;
+    XeVector3::TransformNormal(m, in->xyz, sizeof(XeVector3), out->xyz, sizeof(XeVector3), count);
 }
 
-XeVector3::XeVector3(float x, float y, float z)
+void XeVector3::Transform(const XeMatrix &m, const float *in, int inStride, float *out, int outStride, int count)
 {
-    this->x = x;
-    this->y = y;
-    this->z = z;
-}
+    XeFloat4 r1 = XeSimd::load(m.m);
+    XeFloat4 r2 = XeSimd::load(m.m + 4);
+    XeFloat4 r3 = XeSimd::load(m.m + 8);
+    XeFloat4 r4 = XeSimd::load(m.m + 12);
 
-float XeVector3::length() const
-{
-    return XeVector3::Length(*this);
+    for (int i = 0; i < count; ++i, in = stride(in, inStride), out = stride(out, outStride))
+    {
+        XeFloat4 v = XeSimd::mul(XeSimd::splat(in[0]), r1);
+        v = XeSimd::add(v, XeSimd::mul(XeSimd::splat(in[1]), r2));
+        v = XeSimd::add(v, XeSimd::mul(XeSimd::splat(in[2]), r3));
+        XeSimd::store3(out, XeSimd::add(v, r4));
+    }
 }
 
-float XeVector3::lengthSquared() const
+void XeVector3::TransformNormal(const XeMatrix &m, const float *in, int inStride, float *out, int outStride, int count)
 {
-    return XeVector3::LengthSquared(*this);
-}
+    XeFloat4 r1 = XeSimd::load(m.m);
+    XeFloat4 r2 = XeSimd::load(m.m + 4);
+    XeFloat4 r3 = XeSimd::load(m.m + 8);
 
-float XeVector3::dot(const XeVector3 &other) const
-{
-    return XeVector3::Dot(*this, other);
+    for (int i = 0; i < count; ++i, in = stride(in, inStride), out = stride(out, outStride))
+    {
+        XeFloat4 v = XeSimd::mul(XeSimd::splat(in[0]), r1);
+        v = XeSimd::add(v, XeSimd::mul(XeSimd::splat(in[1]), r2));
+        XeSimd::store3(out, XeSimd::add(v, XeSimd::mul(XeSimd::splat(in[2]), r3)));
+    }
 }
 
-XeVector3 XeVector3::cross(const XeVector3 &other) const
+// Transforms components of four points at a time; translate is false for
+// normals. Points left over at the end go through the strided path
+static void transform_soa(const XeMatrix &m, bool translate,
+                          const float *x, const float *y, const float *z,
+                          float *outX, float *outY, float *outZ, int count)
 {
-    return XeVector3::Cross(*this, other);
-}
+    XeFloat4 m11 = XeSimd::splat(m.m11), m12 = XeSimd::splat(m.m12), m13 = XeSimd::splat(m.m13);
+    XeFloat4 m21 = XeSimd::splat(m.m21), m22 = XeSimd::splat(m.m22), m23 = XeSimd::splat(m.m23);
+    XeFloat4 m31 = XeSimd::splat(m.m31), m32 = XeSimd::splat(m.m32), m33 = XeSimd::splat(m.m33);
+    XeFloat4 m41 = XeSimd::splat(m.m41), m42 = XeSimd::splat(m.m42), m43 = XeSimd::splat(m.m43);
 
-float XeVector3::distanceTo(const XeVector3 &other) const
-{
-    return XeVector3::Distance(*this, other);
-}
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        XeFloat4 vx = XeSimd::load(x + i);
+        XeFloat4 vy = XeSimd::load(y + i);
+        XeFloat4 vz = XeSimd::load(z + i);
 
-float XeVector3::distanceSquaredTo(const XeVector3 &other) const
-{
-    return XeVector3::DistanceSquared(*this, other);
-}
+        XeFloat4 ox = XeSimd::add(XeSimd::add(XeSimd::mul(vx, m11), XeSimd::mul(vy, m21)), XeSimd::mul(vz, m31));
+        XeFloat4 oy = XeSimd::add(XeSimd::add(XeSimd::mul(vx, m12), XeSimd::mul(vy, m22)), XeSimd::mul(vz, m32));
+        XeFloat4 oz = XeSimd::add(XeSimd::add(XeSimd::mul(vx, m13), XeSimd::mul(vy, m23)), XeSimd::mul(vz, m33));
+        if (translate)
+        {
+            ox = XeSimd::add(ox, m41);
+            oy = XeSimd::add(oy, m42);
+            oz = XeSimd::add(oz, m43);
+        }
 
-float XeVector3::manhattanDistanceTo(const XeVector3 &other) const
-{
-    return XeVector3::ManhattanDistance(*this, other);
-}
+        XeSimd::store(outX + i, ox);
+        XeSimd::store(outY + i, oy);
+        XeSimd::store(outZ + i, oz);
+    }
 
-XeVector3 XeVector3::normalize() const
-{
-    return XeVector3::Normalize(*this);
+    for (; i < count; ++i)
+    {
+        XeVector3 v(x[i], y[i], z[i]);
+        v = translate ? XeVector3::Transform(m, v) : XeVector3::TransformNormal(m, v);
+        outX[i] = v.x;
+        outY[i] = v.y;
+        outZ[i] = v.z;
+    }
 }
 
-XeVector3 XeVector3::reflect(const XeVector3 &n) const
+void XeVector3::TransformSoA(const XeMatrix &m, const float *x, const float *y, const float *z,
+                             float *outX, float *outY, float *outZ, int count)
 {
-    return XeVector3::Reflect(*this, n);
+    transform_soa(m, true, x, y, z, outX, outY, outZ, count);
 }
 
-XeVector3 XeVector3::operator+ (const XeVector3& rhs) const
+void XeVector3::TransformNormalSoA(const XeMatrix &m, const float *x, const float *y, const float *z,
+                                   float *outX, float *outY, float *outZ, int count)
 {
-    return XeVector3::Add(*this, rhs);
+    transform_soa(m, false, x, y, z, outX, outY, outZ, count);
 }
 
-XeVector3 XeVector3::operator- (const XeVector3& rhs) const
+void XeVector3::Project(const XeMatrix &m, float x, float y, float width, float height,
+                        const XeVector3 *in, XeVector3 *out, int count)
 {
-    return XeVector3::Subtract(*this, rhs);
-}
+    XeFloat4 r1 = XeSimd::load(m.m);
+    XeFloat4 r2 = XeSimd::load(m.m + 4);
+    XeFloat4 r3 = XeSimd::load(m.m + 8);
+    XeFloat4 r4 = XeSimd::load(m.m + 12);
 
-XeVector3 XeVector3::operator- () const
-{
-    return XeVector3::Negate(*this);
-}
+    // Maps normalized device coordinates from [-1, 1] to the viewport
+    XeFloat4 scale = XeSimd::set(.5f * width, -.5f * height, 1.f, 1.f);
+    XeFloat4 offset = XeSimd::set(x + .5f * width, y + .5f * height, 0.f, 0.f);
 
-XeVector3 XeVector3::operator* (float rhs) const
-{
-    return XeVector3::Multiply(*this, rhs);
-}
+    for (int i = 0; i < count; ++i)
+    {
+        XeFloat4 v = XeSimd::mul(XeSimd::splat(in[i].x), r1);
+        v = XeSimd::add(v, XeSimd::mul(XeSimd::splat(in[i].y), r2));
+        v = XeSimd::add(v, XeSimd::mul(XeSimd::splat(in[i].z), r3));
+        v = XeSimd::add(v, r4);
 
-XeVector3 XeVector3::operator/ (float rhs) const
-{
-    return XeVector3::Divide(*this, rhs);
+        v = XeSimd::div(v, XeSimd::lane<3>(v));
+        XeSimd::store3(out[i].xyz, XeSimd::add(XeSimd::mul(v, scale), offset));
+    }
 }
 
-XeVector3& XeVector3::operator+= (const XeVector3& rhs)
-{
-    x += rhs.x;
-    y += rhs.y;
-    z += rhs.z;
-
-    return *this;
-}
-
-XeVector3& XeVector3::operator-= (const XeVector3& rhs)
-{
-    x -= rhs.x;
-    y -= rhs.y;
-    z -= rhs.z;
-
-    return *this;
-}
-
-XeVector3& XeVector3::operator*= (float rhs)
-{
-    x *= rhs;
-    y *= rhs;
-    z *= rhs;
-
-    return *this;
-}
-
-XeVector3& XeVector3::operator/= (float rhs)
-{
-    *this *= 1.f / rhs;
-    return *this;
-}
-
-bool XeVector3::operator== (const XeVector3& rhs) const
-{
-    return XeVector3::Equal(*this, rhs);
-}
-
-bool XeVector3::operator!= (const XeVector3& rhs) const
-{
-    return XeVector3::NotEqual(*this, rhs);
-}
-
-XeVector3 XeVector3::clamp(const XeVector3 &min, const XeVector3 &max)
-{
-    return XeVector3::Clamp(*this, min, max);
-}
-
-XeVector3 XeVector3::transform(const XeMatrix &m)
-{
-    return XeVector3::Transform(m, *this);
-}
-
-XeVector3 XeVector3::transformNormal(const XeMatrix &m)
-{
-    return XeVector3::TransformNormal(m, *this);
-}
-
-XeVector3 operator* (float lhs, const XeVector3& rhs)
-{
-    return XeVector3::Multiply(rhs, lhs);
-}
@@ -0,0 +1,23 @@
+
+#include "init.h"
+#include "inputs.h"
+#include "scheduler.h"
+#include "window.h"
+
+#include "xe/kernel.h"
+
+#include <QCoreApplication>
+
+void HeadlessHostInit(XeKernel *kernel, XeWindow **outWindow, XeInputs **outInputs, XeScheduler **outScheduler)
+{
+    // No display is needed, but Qt still wants an application object for
+    // timers, threads and the like. One created here belongs to the
+    // scheduler, and goes away with it when the kernel stops
+    QCoreApplication *app = 0;
+    if (!QCoreApplication::instance())
+        app = new QCoreApplication(kernel->argc(), kernel->argv());
+
+    *outWindow = new HeadlessWindow();
+    *outInputs = new HeadlessInputs();
+    *outScheduler = new HeadlessScheduler(app);
+}
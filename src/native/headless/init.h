@@ -0,0 +1,6 @@
+
+#pragma once
+
+#include "../init.h"
+
+void HeadlessHostInit(XeKernel *, XeWindow **, XeInputs **, XeScheduler **);
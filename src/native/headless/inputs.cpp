@@ -0,0 +1,16 @@
+
+#include "inputs.h"
+
+bool HeadlessInputs::hasDevice(const char *)
+{
+    return false;
+}
+
+void HeadlessInputs::devices(QList<const char *> &) { }
+
+XeInputDevice *HeadlessInputs::device(const char *)
+{
+    return 0;
+}
+
+void HeadlessInputs::update(float) { }
@@ -0,0 +1,19 @@
+
+#pragma once
+
+#include "../inputs.h"
+
+/** Without a display there are no native devices; all input comes from
+  * devices attached to the kernel with XeKernel::attach()
+  */
+class HeadlessInputs : public XeInputs
+{
+public:
+    bool hasDevice(const char *id);
+
+    void devices(QList<const char *> &out);
+
+    XeInputDevice *device(const char *id);
+
+    void update(float dt);
+};
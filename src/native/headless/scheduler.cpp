@@ -0,0 +1,50 @@
+
+#include "scheduler.h"
+
+#include "xe/trace.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+HeadlessScheduler::HeadlessScheduler(QCoreApplication *app)
+    : update(0), updateArg(0), render(0), renderArg(0), m_app(app), m_lastUpdate(0)
+{
+    m_clock.start();
+}
+
+HeadlessScheduler::~HeadlessScheduler()
+{
+    delete m_app;
+}
+
+void HeadlessScheduler::setUpdateCallback(XeSchedulerCallback f, void *arg)
+{
+    update = f;
+    updateArg = arg;
+}
+
+void HeadlessScheduler::setRenderCallback(XeSchedulerCallback f, void *arg)
+{
+    render = f;
+    renderArg = arg;
+}
+
+void HeadlessScheduler::tick()
+{
+    if (!update)
+        xe_die("No update callback -- kernel initialization fail");
+
+    QCoreApplication::processEvents();
+
+    // Sleep until the next update is due rather than spinning, so many
+    // headless processes can share a machine
+    qint64 wait = m_lastUpdate + TICK_MS - m_clock.elapsed();
+    if (wait > 0)
+        QThread::msleep(wait);
+
+    qint64 now = m_clock.elapsed();
+    float dt = (now - m_lastUpdate) * 0.001f;
+    m_lastUpdate = now;
+
+    update(dt, updateArg);
+}
@@ -0,0 +1,37 @@
+
+#pragma once
+
+#include "../scheduler.h"
+
+#include <QElapsedTimer>
+
+class QCoreApplication;
+
+/** Runs the update loop at a fixed rate with no display. Nothing is ever
+  * rendered, so screens don't need an OpenGL context
+  */
+class HeadlessScheduler : public XeScheduler
+{
+public:
+    /** The time between updates, in milliseconds; the same as QtWindow's timer */
+    enum { TICK_MS = 10 };
+
+    /** Takes ownership of app, the application object created for the
+      * host, if any
+      */
+    explicit HeadlessScheduler(QCoreApplication *app = 0);
+    ~HeadlessScheduler();
+
+    void setUpdateCallback(XeSchedulerCallback f, void *arg);
+    void setRenderCallback(XeSchedulerCallback f, void *arg);
+
+    void tick();
+
+private:
+    XeSchedulerCallback update; void *updateArg;
+    XeSchedulerCallback render; void *renderArg;
+
+    QCoreApplication *m_app;
+    QElapsedTimer m_clock;
+    qint64 m_lastUpdate;
+};
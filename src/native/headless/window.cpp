@@ -0,0 +1,60 @@
+
+#include "window.h"
+
+HeadlessWindow::HeadlessWindow()
+        : m_bounds(0, 0, 640, 480), m_fullscreen(false), m_relativeMouse(true)
+{ }
+
+void *HeadlessWindow::handle() const
+{
+    return 0;
+}
+
+const char *HeadlessWindow::title() const
+{
+    return m_title.constData();
+}
+
+void HeadlessWindow::setTitle(const char *title)
+{
+    m_title = title ? title : "";
+}
+
+XeRect HeadlessWindow::bounds() const
+{
+    return m_bounds;
+}
+
+void HeadlessWindow::setBounds(const XeRect &r)
+{
+    m_bounds = r;
+}
+
+void HeadlessWindow::show() { }
+
+void HeadlessWindow::hide() { }
+
+bool HeadlessWindow::isFullscreen() const
+{
+    return m_fullscreen;
+}
+
+void HeadlessWindow::setFullscreen(bool f)
+{
+    m_fullscreen = f;
+}
+
+void HeadlessWindow::toggleFullscreen()
+{
+    m_fullscreen = !m_fullscreen;
+}
+
+bool HeadlessWindow::isRelativeMouse() const
+{
+    return m_relativeMouse;
+}
+
+void HeadlessWindow::setRelativeMouse(bool relative)
+{
+    m_relativeMouse = relative;
+}
@@ -0,0 +1,39 @@
+
+#pragma once
+
+#include "xe/window.h"
+
+#include <QByteArray>
+
+/** A window that doesn't exist. Remembers what it's set to, so code that
+  * manipulates the window runs unchanged without a display
+  */
+class HeadlessWindow : public XeWindow
+{
+public:
+    HeadlessWindow();
+
+    void *handle() const;
+
+    const char *title() const;
+    void setTitle(const char *);
+
+    XeRect bounds() const;
+    void setBounds(const XeRect &);
+
+    void show();
+    void hide();
+
+    bool isFullscreen() const;
+    void setFullscreen(bool);
+    void toggleFullscreen();
+
+    bool isRelativeMouse() const;
+    void setRelativeMouse(bool);
+
+private:
+    QByteArray m_title;
+    XeRect m_bounds;
+    bool m_fullscreen;
+    bool m_relativeMouse;
+};
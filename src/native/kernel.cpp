@@ -1,12 +1,15 @@
 
 #include <GL/glew.h>
 
+#include "xe/input.h"
 #include "xe/kernel.h"
+#include "xe/metrics.h"
 
 #include "./init.h"
 #include "./inputs.h"
 #include "./scheduler.h"
 
+#include "./headless/init.h"
 #include "./qt/init.h"
 
 XeKernel *xe_kernel = 0;
@@ -14,10 +17,11 @@ XeKernel *xe_kernel = 0;
 XeKernelInit XeKernelInitializers[] =
 {
     &QtHostInit,
+    &HeadlessHostInit,
 };
 
 XeKernel::XeKernel(int& argc, char **argv) 
-        : m_executing(false), m_nativeWindow(0), m_nativeInputs(0), m_nativeScheduler(0),
+        : m_deviceRevision(0), m_host(HOST_QT), m_executing(false), m_nativeWindow(0), m_nativeInputs(0), m_nativeScheduler(0),
           m_preUpdate(new XeUpdater()), m_postUpdate(new XeUpdater()),
           m_argc(argc), m_argv(argv)
 { }
@@ -75,15 +79,86 @@ XeWindow *XeKernel::window() const
 }
 
 bool XeKernel::hasDevice(const char *id) const
+{
+    return device(id) != 0;
+}
+
+void XeKernel::devices(QList<const char *> &out) const
+{
+    XeInputs *i = (XeInputs*)m_nativeInputs;
+    if (i)
+        i->devices(out);
+
+    foreach (XeInputDevice *d, m_devices)
+        out.append(d->id());
+}
+
+void XeKernel::devices(QList<XeInputDevice *> &out) const
 {
     XeInputs *i = (XeInputs*)m_nativeInputs;
-    return i->hasDevice(id);
+    if (i)
+    {
+        // Hosts only have a handful of native devices
+        QList<const char *> ids;
+        i->devices(ids);
+        foreach (const char *id, ids)
+            if (XeInputDevice *d = i->device(id))
+                out.append(d);
+    }
+
+    out += m_devices;
 }
 
 XeInputDevice *XeKernel::device(const char *id) const
 {
+    if (!id)
+        return 0;
+
+    XeInputDevice *d = m_deviceIndex.value(QByteArray::fromRawData(id, qstrlen(id)));
+    if (d)
+        return d;
+
     XeInputs *i = (XeInputs*)m_nativeInputs;
-    return i->device(id);
+    return i && i->hasDevice(id) ? i->device(id) : 0;
+}
+
+void XeKernel::attach(XeInputDevice *d)
+{
+    if (!d || m_devices.contains(d))
+        return;
+
+    m_devices.append(d);
+    if (!m_deviceIndex.contains(d->id()))
+        m_deviceIndex.insert(d->id(), d);
+    m_postUpdate->attach(d);
+    ++m_deviceRevision;
+}
+
+void XeKernel::detach(XeInputDevice *d)
+{
+    if (m_devices.removeOne(d))
+    {
+        // Another device with the same ID takes over its slot
+        QByteArray id(d->id());
+        if (m_deviceIndex.value(id) == d)
+        {
+            m_deviceIndex.remove(id);
+            foreach (XeInputDevice *other, m_devices)
+                if (id == other->id())
+                {
+                    m_deviceIndex.insert(id, other);
+                    break;
+                }
+        }
+
+        m_postUpdate->detach(d);
+        ++m_deviceRevision;
+    }
+}
+
+quint64 XeKernel::deviceRevision() const
+{
+    return m_deviceRevision;
 }
 
 XeUpdater *XeKernel::preUpdate() const
@@ -141,9 +216,14 @@ void XeKernel::exec(XeScreen *first)
     sched->setUpdateCallback(&update_callback, this);
     sched->setRenderCallback(&render_callback, this);
 
+    // Mapped inputs are evaluated once before the screen's update reads them
+    m_preUpdate->attach(&xe_input);
+
     m_postUpdate->attach((XeInputs*)m_nativeInputs);
+    m_postUpdate->attach(&xe_metrics);
 
-    glewInit();
+    if (m_host != HOST_HEADLESS)
+        glewInit();
 
     m_executing = true;
     xe_kernel = this;
@@ -152,5 +232,14 @@ void XeKernel::exec(XeScreen *first)
 
     while (m_executing)
         sched->tick();
+
+    // Undo the attachments above, so calling exec() again doesn't update
+    // everything twice
+    m_preUpdate->detach(&xe_input);
+    m_postUpdate->detach((XeInputs*)m_nativeInputs);
+    m_postUpdate->detach(&xe_metrics);
+
+    delete sched;
+    m_nativeScheduler = 0;
 }
 
@@ -1,23 +1,144 @@
 
 #include "keyboard.h"
 
+#include <QByteArray>
+#include <QHash>
 #include <QKeyEvent>
 
-static QHash<QString, QString> idToName;
-static QHash<int, QString> qtToId;
 static const char *keyboardDeviceID = "Keyboard";
 static const char *keyboardDeviceName = "Keyboard";
 
-QtKeyboardButton::QtKeyboardButton(const QString &id) : down(false), keyid(id) { }
+struct KeyInfo
+{
+    const char *id;
+    const char *name;
+};
+
+// All keys, indexed by the dense key index used for QtKeyboard::m_buttons.
+// Letters, digits and function keys come first, in Qt key code order, so
+// key_from_qt() can compute their indices from the key code
+static const KeyInfo keys[] =
+{
+    { "A", "A" },
+    { "B", "B" },
+    { "C", "C" },
+    { "D", "D" },
+    { "E", "E" },
+    { "F", "F" },
+    { "G", "G" },
+    { "H", "H" },
+    { "I", "I" },
+    { "J", "J" },
+    { "K", "K" },
+    { "L", "L" },
+    { "M", "M" },
+    { "N", "N" },
+    { "O", "O" },
+    { "P", "P" },
+    { "Q", "Q" },
+    { "R", "R" },
+    { "S", "S" },
+    { "T", "T" },
+    { "U", "U" },
+    { "V", "V" },
+    { "W", "W" },
+    { "X", "X" },
+    { "Y", "Y" },
+    { "Z", "Z" },
+    { "0", "0" }, { "1", "1" }, { "2", "2" }, { "3", "3" }, { "4", "4" },
+    { "5", "5" }, { "6", "6" }, { "7", "7" }, { "8", "8" }, { "9", "9" },
+    { "F1", "F1" }, { "F2", "F2" }, { "F3", "F3" }, { "F4", "F4" },
+    { "F5", "F5" }, { "F6", "F6" }, { "F7", "F7" }, { "F8", "F8" },
+    { "F9", "F9" }, { "F10", "F10" }, { "F11", "F11" }, { "F12", "F12" },
+#if __APPLE__
+    { "Control", "Command" },
+#else
+    { "Control", "Control" },
+#endif
+    { "Meta", "Control" },
+    { "Alt", "Alt" },
+    { "Shift", "Shift" },
+    { "Tab", "Tab" },
+    { "Enter", "Enter" },
+    { "Backspace", "Backspace" },
+    { "Escape", "Escape" },
+    { "Space", "Space" },
+    { "Left", "Left Arrow" },
+    { "Right", "Right Arrow" },
+    { "Up", "Up Arrow" },
+    { "Down", "Down Arrow" },
+};
+
+static_assert(sizeof(keys) / sizeof(keys[0]) == qtkeyboard::NUM_KEYS,
+              "qtkeyboard::NUM_KEYS doesn't match the key table");
+
+enum
+{
+    FirstLetter = 0,
+    FirstDigit = 26,
+    FirstFunction = 36,
+    FirstOther = 48,
+};
+
+static QHash<QByteArray, int> key_index()
+{
+    QHash<QByteArray, int> index;
+    for (int i = 0; i < (int)qtkeyboard::NUM_KEYS; ++i)
+        index[keys[i].id] = i;
+
+    return index;
+}
+
+static bool key_from_id(const char *id, int *out = 0)
+{
+    // Built once, on first use; by-name queries go through here every time
+    static const QHash<QByteArray, int> index = key_index();
+
+    int i = index.value(QByteArray::fromRawData(id, qstrlen(id)), -1);
+    if (i == -1)
+        return false;
+
+    if (out) *out = i;
+    return true;
+}
+
+// Gets the index of a Qt key code, or -1 if the keyboard doesn't track it
+static int key_from_qt(int key)
+{
+    if (key >= Qt::Key_A && key <= Qt::Key_Z)
+        return FirstLetter + (key - Qt::Key_A);
+    if (key >= Qt::Key_0 && key <= Qt::Key_9)
+        return FirstDigit + (key - Qt::Key_0);
+    if (key >= Qt::Key_F1 && key <= Qt::Key_F12)
+        return FirstFunction + (key - Qt::Key_F1);
+
+    switch (key)
+    {
+    case Qt::Key_Control:   return FirstOther + 0;
+    case Qt::Key_Meta:      return FirstOther + 1;
+    case Qt::Key_Alt:       return FirstOther + 2;
+    case Qt::Key_Shift:     return FirstOther + 3;
+    case Qt::Key_Tab:       return FirstOther + 4;
+    case Qt::Key_Return:    return FirstOther + 5;
+    case Qt::Key_Backspace: return FirstOther + 6;
+    case Qt::Key_Escape:    return FirstOther + 7;
+    case Qt::Key_Space:     return FirstOther + 8;
+    case Qt::Key_Left:      return FirstOther + 9;
+    case Qt::Key_Right:     return FirstOther + 10;
+    case Qt::Key_Up:        return FirstOther + 11;
+    case Qt::Key_Down:      return FirstOther + 12;
+    default:                return -1;
+    }
+}
 
 const char *QtKeyboardButton::id() const
 {
-    return keyid.toUtf8().data();
+    return keys[keyIndex].id;
 }
 
 const char *QtKeyboardButton::name() const
 {
-    return idToName[keyid].toUtf8().data();
+    return keys[keyIndex].name;
 }
 
 const char *QtKeyboardButton::deviceID() const
@@ -30,61 +151,13 @@ bool QtKeyboardButton::isDown() const
     return down;
 }
 
-static QtKeyboardButton *defkey(const QString &id, const QString &name, int qt)
-{
-    QtKeyboardButton *b = new QtKeyboardButton(id);
-
-    idToName[id] = name;
-    qtToId[qt] = id;
-
-    return b;
-}
-
 QtKeyboard::QtKeyboard() : m_window(0)
 {
-    // A-Z
-    for (int i = 0; i < 26; ++i)
-    {
-        char letter = 'A' + i;
-        QString id(letter);
-        m_buttons[id] = defkey(id, id, Qt::Key_A + i);
-    }
-    
-    // 0-9
-    for (int i = 0; i <= 10; ++i)
-    {
-        char num = '0' + i;
-        QString id(num);
-        m_buttons[id] = defkey(id, id, Qt::Key_0 + i);
-    }
-
-    // F1 -> F12
-    for (int i = 0; i < 12; ++i)
+    for (int i = 0; i < (int)qtkeyboard::NUM_KEYS; ++i)
     {
-        QString id = "F";
-        id += QString::number(i + 1);
-        m_buttons[id] = defkey(id, id, Qt::Key_F1 + i);
+        m_buttons[i].keyIndex = i;
+        m_buttons[i].down = false;
     }
-
-    // Misc
-#if __APPLE__
-    m_buttons["Control"] = defkey("Control", "Command", Qt::Key_Control);
-    m_buttons["Meta"] = defkey("Meta", "Control", Qt::Key_Meta);
-#else
-    m_buttons["Control"] = defkey("Control", "Control", Qt::Key_Control);
-    m_buttons["Meta"] = defkey("Meta", "Control", Qt::Key_Meta);
-#endif
-    m_buttons["Alt"] = defkey("Alt", "Alt", Qt::Key_Alt);
-    m_buttons["Shift"] = defkey("Shift", "Shift", Qt::Key_Shift);
-    m_buttons["Tab"] = defkey("Tab", "Tab", Qt::Key_Tab);
-    m_buttons["Enter"] = defkey("Enter", "Enter", Qt::Key_Return);
-    m_buttons["Backspace"] = defkey("Backspace", "Backspace", Qt::Key_Backspace);
-    m_buttons["Escape"] = defkey("Escape", "Escape", Qt::Key_Escape);
-    m_buttons["Space"] = defkey("Space", "Space", Qt::Key_Space);
-    m_buttons["Left"] = defkey("Left", "Left Arrow", Qt::Key_Left);
-    m_buttons["Right"] = defkey("Right", "Right Arrow", Qt::Key_Right);
-    m_buttons["Up"] = defkey("Up", "Up Arrow", Qt::Key_Up);
-    m_buttons["Down"] = defkey("Down", "Down Arrow", Qt::Key_Down);
 }
 
 QtWindow *QtKeyboard::window() const
@@ -121,37 +194,56 @@ XeAxisInput *QtKeyboard::axis(const char *) const
 
 bool QtKeyboard::hasButton(const char *id) const
 {
-    return m_buttons.contains(id);
+    return key_from_id(id);
 }
 
 void QtKeyboard::buttons(QList<const char *> &out)
 {
-    QHashIterator<QString, QtKeyboardButton*> it(m_buttons);
-    while (it.hasNext())
-        out.append(it.next().key().toUtf8().data());
+    for (int i = 0; i < (int)qtkeyboard::NUM_KEYS; ++i)
+        out.append(keys[i].id);
 }
 
 XeButtonInput *QtKeyboard::button(const char *id) const
 {
-    return m_buttons[id];
+    int index;
+    if (!key_from_id(id, &index))
+        return 0;
+
+    return (XeButtonInput*)&m_buttons[index];
 }
 
 void QtKeyboard::update(float dt)
 {
-    QHashIterator<QString, QtKeyboardButton*> it(m_buttons);
-    while (it.hasNext())
-        it.next().value()->update(dt);
+    for (int i = 0; i < (int)qtkeyboard::NUM_KEYS; ++i)
+        m_buttons[i].update(dt);
+
+    m_events.clear();
 }
 
 void QtKeyboard::keydown(QKeyEvent *ev)
 {
-    if (qtToId.contains(ev->key()))
-        m_buttons[qtToId[ev->key()]]->down = true;
+    int i = key_from_qt(ev->key());
+    if (i == -1)
+        return;
+
+    QtKeyboardButton *b = &m_buttons[i];
+    b->down = true;
+
+    // Auto-repeat sends extra press/release pairs while a key is held
+    if (!ev->isAutoRepeat())
+        m_events.push(XeInputEvent::PRESS, b);
 }
 
 void QtKeyboard::keyup(QKeyEvent *ev)
 {
-    if (qtToId.contains(ev->key()))
-        m_buttons[qtToId[ev->key()]]->down = false;
+    int i = key_from_qt(ev->key());
+    if (i == -1)
+        return;
+
+    QtKeyboardButton *b = &m_buttons[i];
+    b->down = false;
+
+    if (!ev->isAutoRepeat())
+        m_events.push(XeInputEvent::RELEASE, b);
 }
 
@@ -7,15 +7,20 @@
 
 #include "window.h"
 
-#include <QHash>
 #include <QKeyEvent>
-#include <QString>
+
+namespace qtkeyboard
+{
+    enum
+    {
+        /** A-Z, 0-9, F1-F12 and 13 others; see the key table in keyboard.cpp */
+        NUM_KEYS = 26 + 10 + 12 + 13
+    };
+};
 
 class QtKeyboardButton : public XeButtonInput
 {
 public:
-    QtKeyboardButton(const QString &);
-
     const char *id() const;
     const char *name() const;
     const char *deviceID() const;
@@ -23,7 +28,7 @@ public:
     bool isDown() const;
 
     bool down;
-    QString keyid;
+    int keyIndex;
 };
 
 class QtKeyboard : public XeInputDevice
@@ -50,7 +55,7 @@ public:
     void update(float);
 
 private:
-    QHash<QString, QtKeyboardButton *> m_buttons;
+    QtKeyboardButton m_buttons[(int)qtkeyboard::NUM_KEYS];
     QtWindow *m_window;
 
     friend class QtWindow;
@@ -132,7 +132,7 @@ float QtMouseAxis::value() const
     return axisValue;
 }
 
-QtMouse::QtMouse()
+QtMouse::QtMouse() : m_window(0), m_pendingX(0.f), m_pendingY(0.f), m_pendingSince(-1)
 {
     for (int i = 0; i < (int)qtmouse::NUM_BUTTONS; ++i)
     {
@@ -179,14 +179,14 @@ bool QtMouse::hasButton(const char *id) const
 
 void QtMouse::axes(QList<const char *> &out)
 {
-    for (int i = 0; i < (int)qtmouse::NUM_BUTTONS; ++i)
-        out.append(button_ids[i]);
+    for (int i = 0; i < (int)qtmouse::NUM_AXES; ++i)
+        out.append(axis_ids[i]);
 }
 
 void QtMouse::buttons(QList<const char *> &out)
 {
-    for (int i = 0; i < (int)qtmouse::NUM_AXES; ++i)
-        out.append(axis_ids[i]);
+    for (int i = 0; i < (int)qtmouse::NUM_BUTTONS; ++i)
+        out.append(button_ids[i]);
 }
 
 XeAxisInput *QtMouse::axis(const char *id) const
@@ -217,28 +217,57 @@ void QtMouse::update(float dt)
 
     m_buttons[(int)qtmouse::ScrollUpButton].down = false;
     m_buttons[(int)qtmouse::ScrollDownButton].down = false;
+
+    m_events.clear();
 }
 
 void QtMouse::mousedown(QMouseEvent *ev)
 {
     qtmouse::ButtonID i;
     if (button_from_qt(ev->button(), &i))
+    {
         m_buttons[(int)i].down = true;
+        m_events.push(XeInputEvent::PRESS, &m_buttons[(int)i]);
+    }
 }
 
 void QtMouse::mouseup(QMouseEvent *ev)
 {
     qtmouse::ButtonID i;
     if (button_from_qt(ev->button(), &i))
+    {
         m_buttons[(int)i].down = false;
+        m_events.push(XeInputEvent::RELEASE, &m_buttons[(int)i]);
+    }
+}
+
+void QtMouse::mousemove(float dx, float dy)
+{
+    // High polling rate mice can send many moves per tick; they're only
+    // summed here, and turned into axis values once per tick by coalesce()
+    if (m_pendingSince < 0)
+        m_pendingSince = XeInputEventQueue::now();
+
+    m_pendingX += dx;
+    m_pendingY += dy;
 }
 
-void QtMouse::mousemove(int dx, int dy)
+void QtMouse::coalesce()
 {
     float mult = .001f;
+    float dx = m_pendingX * mult,
+          dy = m_pendingY * mult;
+
+    m_axes[(int)qtmouse::HorizontalAxis].axisValue = dx;
+    m_axes[(int)qtmouse::VerticalAxis].axisValue = dy;
 
-    m_axes[(int)qtmouse::HorizontalAxis].axisValue = dx * mult;
-    m_axes[(int)qtmouse::VerticalAxis].axisValue = dy * mult;
+    if (dx != 0.f)
+        m_events.push(XeInputEvent::AXIS, 0, &m_axes[(int)qtmouse::HorizontalAxis], dx, m_pendingSince);
+    if (dy != 0.f)
+        m_events.push(XeInputEvent::AXIS, 0, &m_axes[(int)qtmouse::VerticalAxis], dy, m_pendingSince);
+
+    m_pendingX = m_pendingY = 0.f;
+    m_pendingSince = -1;
 }
 
 void QtMouse::mousescroll(QWheelEvent *ev)
@@ -247,5 +276,8 @@ void QtMouse::mousescroll(QWheelEvent *ev)
 
     int i = (int)(ev->delta() < 0 ? qtmouse::ScrollDownButton : qtmouse::ScrollUpButton);
     m_buttons[i].down = true;
+
+    // Scroll "buttons" only ever go down; they're released at the next tick
+    m_events.push(XeInputEvent::PRESS, &m_buttons[i]);
 }
 
@@ -88,11 +88,23 @@ private:
     QtMouseAxis m_axes[(int)qtmouse::NUM_AXES];
     QtWindow *m_window;
 
+    // Motion received since the last coalesce(), and when the first of it
+    // arrived
+    float m_pendingX;
+    float m_pendingY;
+    qint64 m_pendingSince;
+
     friend class QtWindow;
+    friend class QtRawMouse;
 
     void mousedown(QMouseEvent *);
     void mouseup(QMouseEvent *);
-    void mousemove(int dx, int dy);
+    void mousemove(float dx, float dy);
     void mousescroll(QWheelEvent *);
+
+    /** Turns the motion accumulated since the last call into the axis values
+      * and a single event per axis. Called once per tick, before the update
+      */
+    void coalesce();
 };
 
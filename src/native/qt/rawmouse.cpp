@@ -0,0 +1,186 @@
+
+#include "mouse.h"
+#include "rawmouse.h"
+#include "window.h"
+
+#include "xe/config.h"
+#include "xe/trace.h"
+
+#include <QCoreApplication>
+
+#if XE_RAW_MOUSE && defined(__linux__)
+
+#include <QX11Info>
+
+#include <xcb/xcb.h>
+#include <xcb/xinput.h>
+
+#include <cstdlib>
+
+// Gets the major opcode of the XInput extension, or -1 if the server doesn't
+// support XInput 2 (raw events were added in 2.0)
+static int xinput_opcode(xcb_connection_t *c)
+{
+    const xcb_query_extension_reply_t *ext = xcb_get_extension_data(c, &xcb_input_id);
+    if (!ext || !ext->present)
+        return -1;
+
+    xcb_input_xi_query_version_cookie_t cookie = xcb_input_xi_query_version(c, 2, 0);
+    xcb_input_xi_query_version_reply_t *reply = xcb_input_xi_query_version_reply(c, cookie, 0);
+
+    bool ok = reply && reply->major_version >= 2;
+    free(reply);
+
+    return ok ? ext->major_opcode : -1;
+}
+
+static void select_raw_motion(bool enable)
+{
+    struct
+    {
+        xcb_input_event_mask_t head;
+        uint32_t mask;
+    } mask;
+
+    mask.head.deviceid = XCB_INPUT_DEVICE_ALL_MASTER;
+    mask.head.mask_len = 1;
+    mask.mask = enable ? XCB_INPUT_XI_EVENT_MASK_RAW_MOTION : 0;
+
+    // Raw events are only ever delivered to the root window
+    xcb_connection_t *c = QX11Info::connection();
+    xcb_input_xi_select_events(c, QX11Info::appRootWindow(), 1, &mask.head);
+    xcb_flush(c);
+}
+
+static double fp3232_to_double(const xcb_input_fp3232_t &v)
+{
+    return v.integral + v.frac / 4294967296.0;
+}
+
+QtRawMouse::QtRawMouse() : m_mouse(0), m_window(0), m_opcode(-1), m_active(false) { }
+
+QtRawMouse::~QtRawMouse()
+{
+    stop();
+}
+
+bool QtRawMouse::isSupported()
+{
+    return QX11Info::isPlatformX11() && xinput_opcode(QX11Info::connection()) != -1;
+}
+
+bool QtRawMouse::start(QtMouse *mouse, QtWindow *window)
+{
+    if (m_active)
+        return true;
+
+    if (!QX11Info::isPlatformX11())
+        return false;
+
+    m_opcode = xinput_opcode(QX11Info::connection());
+    if (m_opcode == -1)
+    {
+        xe_trace.warn << "QtRawMouse: XInput 2 is not available, falling back to cursor warping";
+        return false;
+    }
+
+    m_mouse = mouse;
+    m_window = window;
+    m_active = true;
+
+    QCoreApplication::instance()->installNativeEventFilter(this);
+    select_raw_motion(true);
+
+    return true;
+}
+
+void QtRawMouse::stop()
+{
+    if (!m_active)
+        return;
+
+    select_raw_motion(false);
+    QCoreApplication::instance()->removeNativeEventFilter(this);
+
+    m_active = false;
+}
+
+bool QtRawMouse::nativeEventFilter(const QByteArray &eventType, void *message, long *)
+{
+    if (!m_active || eventType != "xcb_generic_event_t")
+        return false;
+
+    xcb_generic_event_t *ev = (xcb_generic_event_t*)message;
+    if ((ev->response_type & ~0x80) != XCB_GE_GENERIC)
+        return false;
+
+    xcb_ge_generic_event_t *ge = (xcb_ge_generic_event_t*)ev;
+    if (ge->extension != m_opcode || ge->event_type != XCB_INPUT_RAW_MOTION)
+        return false;
+
+    // Raw events arrive no matter which window has focus
+    if (!m_window->isActiveWindow())
+        return true;
+
+    xcb_input_raw_motion_event_t *raw = (xcb_input_raw_motion_event_t*)ev;
+    const uint32_t *mask = xcb_input_raw_button_press_valuator_mask(raw);
+    // The transformed values rather than the raw ones: device units depend
+    // on the mouse's resolution, while these are in the same units as the
+    // cursor motion the warp fallback measures, so sensitivity doesn't
+    // change with the mode
+    const xcb_input_fp3232_t *values = xcb_input_raw_button_press_axisvalues(raw);
+
+    // Values are only sent for the valuators set in the mask; valuators 0
+    // and 1 are the X and Y axes
+    double dx = 0., dy = 0.;
+    int v = 0;
+    for (int i = 0; i < raw->valuators_len * 32; ++i)
+    {
+        if (!(mask[i / 32] & (1u << (i % 32))))
+            continue;
+
+        if (i == 0)
+            dx = fp3232_to_double(values[v]);
+        else if (i == 1)
+            dy = fp3232_to_double(values[v]);
+        else
+            break;
+
+        ++v;
+    }
+
+    if (dx != 0. || dy != 0.)
+        m_mouse->mousemove((float)dx, (float)dy);
+
+    return true;
+}
+
+#else
+
+QtRawMouse::QtRawMouse() : m_mouse(0), m_window(0), m_opcode(-1), m_active(false) { }
+
+QtRawMouse::~QtRawMouse() { }
+
+bool QtRawMouse::isSupported()
+{
+    return false;
+}
+
+bool QtRawMouse::start(QtMouse *, QtWindow *)
+{
+    return false;
+}
+
+void QtRawMouse::stop() { }
+
+bool QtRawMouse::nativeEventFilter(const QByteArray &, void *, long *)
+{
+    return false;
+}
+
+#endif
+
+bool QtRawMouse::isActive() const
+{
+    return m_active;
+}
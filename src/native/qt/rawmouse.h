@@ -0,0 +1,44 @@
+
+#pragma once
+
+#include <QAbstractNativeEventFilter>
+#include <QByteArray>
+
+class QtMouse;
+class QtWindow;
+
+/** Feeds mouse motion straight from the X server (XInput2 raw motion
+  * events) to a QtMouse, so relative mouse mode doesn't depend on the
+  * cursor position or on warping it back to the window center. Motion is
+  * in the same units as cursor motion, so sensitivity is the same as with
+  * the warp fallback.
+  *
+  * Only available on Linux when built with XE_RAW_MOUSE (see xe/config.h);
+  * elsewhere isSupported() returns false, and QtWindow falls back to warping
+  * the cursor.
+  */
+class QtRawMouse : public QAbstractNativeEventFilter
+{
+public:
+    QtRawMouse();
+    ~QtRawMouse();
+
+    /** Gets whether raw motion events are available */
+    static bool isSupported();
+
+    /** Starts delivering raw motion to mouse while window is active.
+      * Returns false if raw motion isn't available
+      */
+    bool start(QtMouse *mouse, QtWindow *window);
+    /** Stops delivering raw motion */
+    void stop();
+    bool isActive() const;
+
+    bool nativeEventFilter(const QByteArray &eventType, void *message, long *result);
+
+private:
+    QtMouse *m_mouse;
+    QtWindow *m_window;
+    int m_opcode;
+    bool m_active;
+};
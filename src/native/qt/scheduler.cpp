@@ -1,10 +1,19 @@
 
 #include "scheduler.h"
+#include "window.h"
 
 #include "xe/trace.h"
 
 #include <QApplication>
 
+QtScheduler::QtScheduler() : update(0), updateArg(0), render(0), renderArg(0), m_window(0) { }
+
+QtScheduler::~QtScheduler()
+{
+    if (m_window)
+        m_window->setSched(0);
+}
+
 void QtScheduler::setUpdateCallback(XeSchedulerCallback f, void *arg)
 {
     update = f;
@@ -3,9 +3,15 @@
 
 #include "../scheduler.h"
 
+class QtWindow;
+
 class QtScheduler : public XeScheduler
 {
 public:
+    QtScheduler();
+    /** Detaches the scheduler from the window it drives */
+    ~QtScheduler();
+
     void setUpdateCallback(XeSchedulerCallback f, void *arg);
     void setRenderCallback(XeSchedulerCallback f, void *arg);
 
@@ -14,6 +20,7 @@ public:
 private:
     XeSchedulerCallback update; void *updateArg;
     XeSchedulerCallback render; void *renderArg;
+    QtWindow *m_window;
 
     friend class QtWindow;
 
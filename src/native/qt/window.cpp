@@ -9,7 +9,9 @@
 #include <QKeyEvent>
 #include <QMouseEvent>
 
-QtWindow::QtWindow(QWidget *parent) : QGLWidget(parent), m_sched(0), m_mouse(0), m_fullscreen(false), m_changingState(false)
+#include <cstdlib>
+
+QtWindow::QtWindow(QWidget *parent) : QGLWidget(parent), m_sched(0), m_mouse(0), m_keyboard(0), m_fullscreen(false), m_changingState(false), m_relativeMouse(true), m_warping(false)
 {
     setMouseTracking(true);
     setCursor(Qt::BlankCursor);
@@ -32,7 +34,17 @@ QtScheduler *QtWindow::sched() const
 
 void QtWindow::setSched(QtScheduler *sched)
 {
+    if (m_sched)
+        m_sched->m_window = 0;
+
     m_sched = sched;
+
+    // Without a scheduler (e.g. once the kernel has stopped and deleted it)
+    // there is nothing left to tick
+    if (m_sched)
+        m_sched->m_window = this;
+    else
+        m_timer.stop();
 }
 
 QtMouse *QtWindow::mouse() const
@@ -63,7 +75,13 @@ void QtWindow::initializeGL()
     m_renderTime.start();
     m_timer.start(10);
 
-    QCursor::setPos(mapToGlobal(QPoint(width() / 2, height() / 2)));
+    m_lastMouse = mapFromGlobal(QCursor::pos());
+    if (m_relativeMouse)
+    {
+        if (mouse())
+            m_rawMouse.start(mouse(), this);
+        warpCursor();
+    }
 
     // Some reasonable OpenGL defaults
     glEnable(GL_DEPTH_TEST);
@@ -75,6 +93,16 @@ void QtWindow::tick()
 {
     xe_assert(sched(), "Native kernel init failure: no scheduler set");
 
+    // Mouse motion is gathered as it arrives, and turned into axis values
+    // once per tick. The cursor goes back to the center at every tick it
+    // moved, so each tick starts with half the window to cover in any
+    // direction
+    if (m_relativeMouse && isActiveWindow() && mapFromGlobal(QCursor::pos()) != QPoint(width() / 2, height() / 2))
+        warpCursor();
+
+    if (mouse())
+        mouse()->coalesce();
+
     float dt = m_updateTime.restart() * 0.001f;
     sched()->onupdate(dt);
 
@@ -85,10 +113,8 @@ void QtWindow::paintGL()
 {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    if (!m_changingState)
+    if (!m_changingState && sched())
     {
-        xe_assert(sched(), "Native kernel init failure: no scheduler set");
-
         float dt = m_renderTime.restart() * 0.001f;
         sched()->onrender(dt);
     }
@@ -113,18 +139,41 @@ void QtWindow::mouseReleaseEvent(QMouseEvent *ev)
 
 void QtWindow::mouseMoveEvent(QMouseEvent *ev)
 {
-    int x0 = width() / 2, y0 = height() / 2;
-    int dx = ev->x() - x0,
-        dy = ev->y() - y0;
+    // Moves queued before a warp are still measured from the old position.
+    // The warp's own move lands exactly on the target, and isn't motion
+    if (m_warping && ev->pos() == m_warpTarget)
+    {
+        m_warping = false;
+        m_lastMouse = ev->pos();
+        return;
+    }
 
-    // Calling QCursor::setPos() with dx == 0 && dy == 0 generates another 
-    // mouseMoveEvent() and leads to infinite recursion fun
-    if (dx || dy)
+    QPoint d = ev->pos() - m_lastMouse;
+    m_lastMouse = ev->pos();
+
+    // Raw motion already reports every movement, unaffected by warps
+    if (!d.isNull() && !m_rawMouse.isActive())
     {
         xe_assert(mouse(), "Native kernel init failure: no mouse set");
-        mouse()->mousemove(dx, dy);
-        QCursor::setPos(mapToGlobal(QPoint(x0, y0)));
+        mouse()->mousemove(d.x(), d.y());
     }
+
+    // A fast flick could leave the window before the next tick, and the
+    // window gets no moves once the cursor is outside; warp back as soon as
+    // the cursor is halfway to the edge
+    if (m_relativeMouse && !d.isNull() &&
+        (abs(ev->pos().x() - width() / 2) > width() / 4 || abs(ev->pos().y() - height() / 2) > height() / 4))
+        warpCursor();
+}
+
+void QtWindow::warpCursor()
+{
+    // Moving the cursor makes another round trip through the window system
+    // and generates a move event, so this is done at most once per tick,
+    // plus whenever a move gets far from the center
+    m_warpTarget = QPoint(width() / 2, height() / 2);
+    m_warping = true;
+    QCursor::setPos(mapToGlobal(m_warpTarget));
 }
 
 void QtWindow::wheelEvent(QWheelEvent *ev)
@@ -152,12 +201,15 @@ void *QtWindow::handle() const
 
 const char *QtWindow::title() const
 {
-    return windowTitle().toUtf8().data();
+    return m_title.constData();
 }
 
 void QtWindow::setTitle(const char *title)
 {
-    setWindowTitle(title);
+    // Not interned: titles such as frame rates change all the time, and the
+    // string table never frees anything
+    m_title = title ? title : "";
+    setWindowTitle(QString::fromUtf8(m_title));
 }
 
 XeRect QtWindow::bounds() const
@@ -217,3 +269,30 @@ void QtWindow::toggleFullscreen()
     m_fullscreen = !m_fullscreen;
 }
 
+bool QtWindow::isRelativeMouse() const
+{
+    return m_relativeMouse;
+}
+
+void QtWindow::setRelativeMouse(bool relative)
+{
+    if (relative == m_relativeMouse)
+        return;
+
+    m_relativeMouse = relative;
+
+    if (relative)
+    {
+        setCursor(Qt::BlankCursor);
+        if (mouse())
+            m_rawMouse.start(mouse(), this);
+        warpCursor();
+    }
+    else
+    {
+        m_rawMouse.stop();
+        m_warping = false;
+        m_lastMouse = mapFromGlobal(QCursor::pos());
+        unsetCursor();
+    }
+}
@@ -2,11 +2,15 @@
 #pragma once
 
 #include <qgl.h>
+#include <QByteArray>
+#include <QPoint>
 #include <QTime>
 #include <QTimer>
 
 #include "xe/window.h"
 
+#include "rawmouse.h"
+
 class QtScheduler;
 class QtMouse;
 class QtKeyboard;
@@ -43,6 +47,9 @@ public:
     void setFullscreen(bool);
     void toggleFullscreen();
 
+    bool isRelativeMouse() const;
+    void setRelativeMouse(bool);
+
 private:
     QTime m_updateTime;
     QTime m_renderTime;
@@ -50,9 +57,20 @@ private:
     QtScheduler *m_sched;
     QtMouse *m_mouse;
     QtKeyboard *m_keyboard;
+    QByteArray m_title;
     bool m_fullscreen;
     bool m_changingState;
 
+    bool m_relativeMouse;
+    QtRawMouse m_rawMouse;
+    // The cursor position motion is measured from, and where it was last
+    // warped to while the warp's own move event is still pending
+    QPoint m_lastMouse;
+    QPoint m_warpTarget;
+    bool m_warping;
+
+    void warpCursor();
+
     void initializeGL();
     void paintGL();
     void resizeGL(int, int);
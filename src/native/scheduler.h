@@ -16,6 +16,9 @@ typedef void (*XeSchedulerCallback)(float dt, void *opaque);
 class XeScheduler
 {
 public:
+    /** The kernel deletes its scheduler once exec() returns */
+    virtual ~XeScheduler() { }
+
     /** Registers a callback that will be called on every update tick.
       * XeKernel's callback for this function calls update() on the current XeScreen
       * @param f The callback function to call
@@ -0,0 +1,88 @@
+
+#include "xe/strings.h"
+
+#include <QMutexLocker>
+
+#include <cstring>
+
+XeStringTable xe_strings;
+
+XeStringTable::XeStringTable() : m_current(0), m_blockUsed(BLOCK_SIZE) { }
+
+XeStringTable::~XeStringTable()
+{
+    foreach (char *block, m_blocks)
+        delete[] block;
+}
+
+XeStringId XeStringTable::add(const QByteArray &str)
+{
+    XeStringId id = m_ids.value(str, -1);
+    if (id != -1)
+        return id;
+
+    // Strings are packed into large blocks that are never reallocated, so
+    // pointers handed out stay valid. Strings too long for a block get a
+    // block of their own, so the current block stays the one being packed
+    int size = str.size() + 1;
+    char *dst;
+    if (size > BLOCK_SIZE / 4)
+    {
+        dst = new char[size];
+        m_blocks.append(dst);
+    }
+    else
+    {
+        if (m_blockUsed + size > BLOCK_SIZE)
+        {
+            m_current = new char[BLOCK_SIZE];
+            m_blocks.append(m_current);
+            m_blockUsed = 0;
+        }
+
+        dst = m_current + m_blockUsed;
+        m_blockUsed += size;
+    }
+
+    memcpy(dst, str.constData(), size);
+
+    id = m_strings.count();
+    m_strings.append(dst);
+    m_ids[str] = id;
+
+    return id;
+}
+
+const char *XeStringTable::intern(const char *str)
+{
+    return intern(QByteArray(str ? str : ""));
+}
+
+const char *XeStringTable::intern(const QByteArray &str)
+{
+    QMutexLocker lock(&m_lock);
+    return m_strings[add(str)];
+}
+
+const char *XeStringTable::intern(const QString &str)
+{
+    return intern(str.toUtf8());
+}
+
+XeStringId XeStringTable::id(const char *str)
+{
+    QMutexLocker lock(&m_lock);
+    return add(QByteArray(str ? str : ""));
+}
+
+const char *XeStringTable::string(XeStringId id) const
+{
+    QMutexLocker lock(&m_lock);
+    return id >= 0 && id < m_strings.count() ? m_strings[id] : 0;
+}
+
+int XeStringTable::count() const
+{
+    QMutexLocker lock(&m_lock);
+    return m_strings.count();
+}
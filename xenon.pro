@@ -3,7 +3,7 @@ QT += core gui opengl
 
 TARGET = xenon
 TEMPLATE = lib
-CONFIG += staticlib
+CONFIG += staticlib c++11
 
 QMAKE_CXXFLAGS_RELEASE -= -O2
 QMAKE_CXXFLAGS_RELEASE += -O3
@@ -12,6 +12,20 @@ QMAKE_CFLAGS_RELEASE += -O3
 
 DEFINES += XENON_LIBRARY
 
+# The math types give the same results with every XE_SIMD instruction set
+# only if the compiler doesn't fuse multiplies and adds on its own (GCC does
+# by default when the target has FMA, e.g. with -march=haswell). Code that
+# includes the math headers needs the same flags
+*-g++*|*-clang*: QMAKE_CXXFLAGS += -ffp-contract=off
+win32-msvc*: QMAKE_CXXFLAGS += /fp:precise
+
+# Raw mouse motion through XInput 2 (see XE_RAW_MOUSE in xe/config.h)
+xe_raw_mouse {
+    DEFINES += XE_RAW_MOUSE=1
+    QT += x11extras
+    LIBS += -lxcb -lxcb-xinput
+}
+
 INCLUDEPATH += include
 DEPENDPATH  += src/instrument src/input
 
@@ -20,21 +34,41 @@ SOURCES += src/instrument/tracetype.cpp \
            src/instrument/trace.cpp \
            src/instrument/filelogger.cpp \
            src/instrument/profiler.cpp \
+           src/instrument/alloctracker.cpp \
+           src/instrument/flightrecorder.cpp \
+           src/instrument/metrics.cpp \
+           src/instrument/samplingprofiler.cpp \
+           src/instrument/perfcounters.cpp \
+           src/instrument/profilercsv.cpp \
+           src/instrument/profilerfolded.cpp \
+           src/instrument/profileroverlay.cpp \
+           src/instrument/telemetry.cpp \
+           src/instrument/histogram.cpp \
            src/updater.cpp \
+           src/strings.cpp \
            src/input/buttoninput.cpp \
            src/input/axisinput.cpp \
            src/input/inputdevice.cpp \
+           src/input/inputevent.cpp \
            src/input/andbutton.cpp \
            src/input/orbutton.cpp \
            src/input/notbutton.cpp \
            src/input/axisbutton.cpp \
            src/input/buttonaxis.cpp \
            src/input/input.cpp \
+           src/input/inputprogram.cpp \
+           src/input/combo.cpp \
+           src/input/inputlatency.cpp \
+           src/input/syntheticdevice.cpp \
+           src/input/inputsnapshot.cpp \
+           src/input/axisfilter.cpp \
+           src/input/bindingprofile.cpp \
            src/native/kernel.cpp \
-           src/math/vector2.cpp \
            src/math/vector3.cpp \
            src/math/vector4.cpp \
-           src/math/quaternion.cpp
+           src/math/quaternion.cpp \
+           src/math/matrix.cpp \
+           src/math/affinematrix.cpp
 
 HEADERS += include/xe/global.h \
            include/xe/config.h \
@@ -43,25 +77,50 @@ HEADERS += include/xe/global.h \
            include/xe/trace.h \
            include/xe/filelogger.h \
            include/xe/profiler.h \
+           include/xe/alloctracker.h \
+           include/xe/flightrecorder.h \
+           include/xe/metrics.h \
+           include/xe/samplingprofiler.h \
+           include/xe/perfcounters.h \
+           include/xe/profilercsv.h \
+           include/xe/profilerfolded.h \
+           include/xe/profileroverlay.h \
+           include/xe/telemetry.h \
+           include/xe/histogram.h \
            include/xe/updatable.h \
            include/xe/updater.h \
+           include/xe/strings.h \
            include/xe/rect.h \
            include/xe/window.h \
            include/xe/buttoninput.h \
            include/xe/axisinput.h \
            include/xe/inputdevice.h \
+           include/xe/inputevent.h \
            include/xe/andbutton.h \
            include/xe/orbutton.h \
            include/xe/notbutton.h \
            include/xe/axisbutton.h \
            include/xe/buttonaxis.h \
+           include/xe/inputhandle.h \
            include/xe/input.h \
+           include/xe/inputprogram.h \
+           include/xe/combo.h \
+           include/xe/inputlatency.h \
+           include/xe/syntheticdevice.h \
+           include/xe/inputsnapshot.h \
+           include/xe/axisfilter.h \
+           include/xe/bindingprofile.h \
            include/xe/kernel.h \
            include/xe/vector2.h \
            include/xe/vector3.h \
            include/xe/vector4.h \ 
            include/xe/quaternion.h \
            include/xe/matrix.h \
+           include/xe/vector4a.h \
+           include/xe/quaterniona.h \
+           include/xe/matrixa.h \
+           include/xe/affinematrix.h \
+           include/xe/simd.h \
            include/xe/vector.h
 
 # XeKernel::HOST_QT native interface
@@ -69,6 +128,7 @@ HEADERS += include/xe/global.h \
 HEADERS += src/native/qt/window.h \
            src/native/qt/scheduler.h \
            src/native/qt/mouse.h \
+           src/native/qt/rawmouse.h \
            src/native/qt/keyboard.h \
            src/native/qt/inputs.h \
            src/native/qt/init.h
@@ -76,7 +136,19 @@ HEADERS += src/native/qt/window.h \
 SOURCES += src/native/qt/window.cpp \
            src/native/qt/scheduler.cpp \
            src/native/qt/mouse.cpp \
+           src/native/qt/rawmouse.cpp \
            src/native/qt/keyboard.cpp \
            src/native/qt/inputs.cpp \
            src/native/qt/init.cpp
 
+# XeKernel::HOST_HEADLESS native interface
+
+HEADERS += src/native/headless/window.h \
+           src/native/headless/scheduler.h \
+           src/native/headless/inputs.h \
+           src/native/headless/init.h
+
+SOURCES += src/native/headless/window.cpp \
+           src/native/headless/scheduler.cpp \
+           src/native/headless/inputs.cpp \
+           src/native/headless/init.cpp